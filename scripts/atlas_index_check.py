@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+from __future__ import annotations
+
+import argparse
+import json
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+from typing import Any, Dict, List
+
+from bench_cross_runtime import ROOT_DIR
+
+INDEX_RUNNER = ROOT_DIR / "scripts" / "run_spine_cpp_lite_atlas_index.zsh"
+ATLAS_INDEX = ROOT_DIR / "target" / "release" / "examples" / "atlas_index"
+
+
+def run_json(argv: List[str], allow_fail: bool = False) -> Dict[str, Any]:
+    proc = subprocess.run(argv, cwd=str(ROOT_DIR), capture_output=True, text=True)
+    if proc.returncode != 0 and not (allow_fail and proc.stdout.strip()):
+        raise RuntimeError(f"command failed (code {proc.returncode})\nargv: {argv}\nstderr:\n{proc.stderr}")
+    return json.loads(proc.stdout.strip().splitlines()[-1])
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(
+        description="Bake each atlas into a binary atlas index with spine-cpp (spine_cpp_lite_atlas_index), check it "
+        "field by field against spine2d's Atlas::parse (atlas_index --cpp-index), and report text vs index load times."
+    )
+    ap.add_argument("atlases", type=Path, nargs="+", help="Atlas files (.atlas)")
+    ap.add_argument("--iterations", type=int, default=200, help="Timing iterations per runtime (default 200)")
+    ap.add_argument("--json-out", type=Path, default=None, help="Write all results as JSON")
+    args = ap.parse_args()
+
+    if not ATLAS_INDEX.is_file():
+        raise SystemExit(f"Missing {ATLAS_INDEX}; run `cargo build --release -p spine2d --example atlas_index --features json`.")
+
+    results = []
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        for i, atlas in enumerate(args.atlases):
+            atlas = (ROOT_DIR / atlas).resolve()
+            index = Path(tmp_dir) / f"{i}.atlasidx"
+            cpp = run_json([str(INDEX_RUNNER), str(atlas), str(index), "--iterations", str(args.iterations)], allow_fail=True)
+            rust = run_json(
+                [str(ATLAS_INDEX), str(atlas), "--cpp-index", str(index), "--iterations", str(args.iterations)],
+                allow_fail=True,
+            )
+            results.append({"atlas": str(atlas), "cpp": cpp, "rust": rust})
+
+    print(
+        f"{'atlas':<32} {'pages':>5} {'regions':>7} {'text B':>8} {'index B':>8} "
+        f"{'cpp text':>9} {'cpp idx':>9} {'rs text':>9} {'rs idx':>9}  parity"
+    )
+    failures = 0
+    for r in results:
+        cpp, rust = r["cpp"], r["rust"]
+        parity = rust.get("parity", {})
+        ok = parity.get("ok", False) and cpp.get("lookupMisses", 0) == 0
+        failures += 0 if ok else 1
+        print(
+            f"{Path(r['atlas']).name:<32} {rust['pages']:>5} {rust['regions']:>7} {rust['textBytes']:>8} "
+            f"{cpp['indexBytes']:>8} "
+            f"{(cpp['textLoadP50Ns'] + cpp['textLookupP50Ns']) / 1000:>8.1f}u "
+            f"{(cpp['indexLoadP50Ns'] + cpp['indexLookupP50Ns']) / 1000:>8.1f}u "
+            f"{rust['parseLookupMedianUs']:>8.1f}u {rust['indexLookupMedianUs']:>8.1f}u  "
+            + ("OK" if ok else "MISMATCH")
+        )
+        for m in parity.get("mismatches", [])[:10]:
+            print(f"    {json.dumps(m)}")
+        if "error" in parity:
+            print(f"    {parity['error']}")
+    print("load + lookup; u = microseconds; cpp = sum of the load and lookup p50s, rs = median of both together")
+
+    if args.json_out:
+        args.json_out.write_text(json.dumps({"iterations": args.iterations, "results": results}, indent=2) + "\n", encoding="utf-8")
+    return 0 if failures == 0 else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
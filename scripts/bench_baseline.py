@@ -0,0 +1,212 @@
+#!/usr/bin/env python3
+from __future__ import annotations
+
+import argparse
+import json
+import math
+import platform
+import re
+import subprocess
+import sys
+from datetime import datetime, timezone
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+from bench_cross_runtime import ORACLE_RUNNER, PHASES, ROOT_DIR, RUST_BIN, load_manifest, run_json
+
+
+DEFAULT_STORE = ROOT_DIR / ".cache" / "spine2d-bench" / "baselines"
+
+
+def slug(s: str) -> str:
+    return re.sub(r"[^A-Za-z0-9.]+", "-", s).strip("-").lower() or "unknown"
+
+
+def machine_key() -> str:
+    return slug(f"{platform.node()}-{platform.system()}-{platform.machine()}")
+
+
+def compiler_key() -> str:
+    for cxx in ("clang++", "c++"):
+        try:
+            out = subprocess.run([cxx, "--version"], capture_output=True, text=True, check=True)
+        except (OSError, subprocess.CalledProcessError):
+            continue
+        first = out.stdout.strip().splitlines()[0] if out.stdout.strip() else cxx
+        return slug(first)
+    return "unknown"
+
+
+def commit_key() -> str:
+    try:
+        out = subprocess.run(
+            ["git", "rev-parse", "--short=12", "HEAD"],
+            cwd=str(ROOT_DIR),
+            capture_output=True,
+            text=True,
+            check=True,
+        )
+        return out.stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return "nogit"
+
+
+def mann_whitney_u(a: List[float], b: List[float]) -> Tuple[float, float]:
+    """
+    One-sided Mann-Whitney U test for "b tends to be larger than a".
+
+    Returns (U_b, p). Uses the normal approximation with tie correction, which is adequate
+    for the >= 8 samples per side that the bench modes produce by default.
+    """
+    n1, n2 = len(a), len(b)
+    if n1 == 0 or n2 == 0:
+        return 0.0, 1.0
+    combined = sorted([(v, 0) for v in a] + [(v, 1) for v in b], key=lambda x: x[0])
+    ranks = [0.0] * len(combined)
+    tie_term = 0.0
+    i = 0
+    while i < len(combined):
+        j = i
+        while j + 1 < len(combined) and combined[j + 1][0] == combined[i][0]:
+            j += 1
+        rank = (i + j) / 2.0 + 1.0
+        for k in range(i, j + 1):
+            ranks[k] = rank
+        t = j - i + 1
+        tie_term += t * t * t - t
+        i = j + 1
+    r2 = sum(r for r, (_, side) in zip(ranks, combined) if side == 1)
+    u2 = r2 - n2 * (n2 + 1) / 2.0
+    mean = n1 * n2 / 2.0
+    n = n1 + n2
+    var = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1))) if n > 1 else 0.0
+    if var <= 0.0:
+        return u2, 1.0
+    z = (u2 - mean - 0.5) / math.sqrt(var)
+    p = 0.5 * math.erfc(z / math.sqrt(2.0))
+    return u2, p
+
+
+def median(xs: List[float]) -> float:
+    s = sorted(xs)
+    if not s:
+        return 0.0
+    m = len(s) // 2
+    return s[m] if len(s) % 2 else 0.5 * (s[m - 1] + s[m])
+
+
+def run_suite(manifest: Path, runtime: str, iterations: int, warmup: int, only: str) -> Dict[str, dict]:
+    bench_args = ["--bench", str(iterations), "--bench-warmup", str(warmup)]
+    out: Dict[str, dict] = {}
+    for s in load_manifest(manifest):
+        if only not in s["name"]:
+            continue
+        if runtime == "spine-cpp":
+            argv = [str(ORACLE_RUNNER), s["atlas"], s["skeleton"], *bench_args, *s["commands"]]
+        else:
+            argv = [str(RUST_BIN), s["skeleton"], *bench_args, *s["commands"]]
+        out[s["name"]] = run_json(argv)
+    return out
+
+
+def baseline_path(store: Path, runtime: str, machine: str, compiler: str, commit: str) -> Path:
+    return store / machine / compiler / f"{commit}__{runtime}.json"
+
+
+def find_baseline(store: Path, runtime: str, machine: str, compiler: str, commit: Optional[str]) -> Optional[Path]:
+    d = store / machine / compiler
+    if commit:
+        p = d / f"{commit}__{runtime}.json"
+        return p if p.is_file() else None
+    candidates = sorted(d.glob(f"*__{runtime}.json"), key=lambda p: p.stat().st_mtime)
+    return candidates[-1] if candidates else None
+
+
+def cmd_record(args: argparse.Namespace) -> int:
+    results = run_suite(args.manifest, args.runtime, args.iterations, args.warmup, args.only)
+    machine, compiler, commit = machine_key(), compiler_key(), commit_key()
+    payload = {
+        "machine": machine,
+        "compiler": compiler,
+        "commit": commit,
+        "runtime": args.runtime,
+        "recordedAtUTC": datetime.now(timezone.utc).strftime("%Y-%m-%dT%H:%M:%SZ"),
+        "manifest": str(args.manifest),
+        "results": results,
+    }
+    out = baseline_path(args.store, args.runtime, machine, compiler, commit)
+    out.parent.mkdir(parents=True, exist_ok=True)
+    out.write_text(json.dumps(payload) + "\n", encoding="utf-8")
+    print(f"wrote {out}")
+    return 0
+
+
+def cmd_compare(args: argparse.Namespace) -> int:
+    machine, compiler = machine_key(), compiler_key()
+    base_path = find_baseline(args.store, args.runtime, machine, compiler, args.baseline_commit)
+    if base_path is None:
+        print(f"no baseline for machine={machine} compiler={compiler} runtime={args.runtime}", file=sys.stderr)
+        return 2
+    baseline = json.loads(base_path.read_text(encoding="utf-8"))["results"]
+    current = run_suite(args.manifest, args.runtime, args.iterations, args.warmup, args.only)
+
+    print(f"baseline: {base_path.relative_to(args.store)}")
+    header = f"{'scenario':<32} {'phase':<8} {'base us':>10} {'cur us':>10} {'delta':>8} {'p':>8}"
+    print(header)
+    print("-" * len(header))
+    regressions = 0
+    for name, cur in current.items():
+        base = baseline.get(name)
+        if base is None:
+            print(f"{name:<32} (no baseline)")
+            continue
+        for phase in PHASES:
+            a = [float(v) for v in base["phases"][phase]["samplesNs"]]
+            b = [float(v) for v in cur["phases"][phase]["samplesNs"]]
+            ma, mb = median(a), median(b)
+            delta = (mb - ma) / ma if ma > 0 else 0.0
+            _, p = mann_whitney_u(a, b)
+            regressed = delta > args.threshold and p < args.alpha
+            regressions += 1 if regressed else 0
+            steps_a = max(1, int(base.get("steps", 1)))
+            steps_b = max(1, int(cur.get("steps", 1)))
+            flag = "  REGRESSION" if regressed else ""
+            print(
+                f"{name:<32} {phase:<8} {ma / steps_a / 1000.0:>10.2f} {mb / steps_b / 1000.0:>10.2f} "
+                f"{delta * 100.0:>+7.1f}% {p:>8.4f}{flag}"
+            )
+
+    print(f"\nregressions: {regressions} (threshold {args.threshold * 100.0:.1f}%, alpha {args.alpha})")
+    return 1 if regressions else 0
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(
+        description="Persist bench results as baselines keyed by machine/compiler/commit and gate regressions."
+    )
+    sub = ap.add_subparsers(dest="cmd", required=True)
+
+    def add_common(p: argparse.ArgumentParser) -> None:
+        p.add_argument("manifest", type=Path)
+        p.add_argument("--runtime", choices=["spine-cpp", "spine2d"], default="spine-cpp")
+        p.add_argument("--iterations", type=int, default=30)
+        p.add_argument("--warmup", type=int, default=3)
+        p.add_argument("--only", type=str, default="", help="Substring filter on scenario name")
+        p.add_argument("--store", type=Path, default=DEFAULT_STORE)
+
+    rec = sub.add_parser("record", help="Run the manifest and store a baseline for HEAD")
+    add_common(rec)
+    cmp_ = sub.add_parser("compare", help="Run the manifest and test against a stored baseline")
+    add_common(cmp_)
+    cmp_.add_argument("--baseline-commit", type=str, default=None, help="Default: latest for this machine/compiler")
+    cmp_.add_argument("--threshold", type=float, default=0.05, help="Relative median slowdown to flag (default 0.05)")
+    cmp_.add_argument("--alpha", type=float, default=0.01, help="Mann-Whitney significance level (default 0.01)")
+
+    args = ap.parse_args()
+    if args.runtime == "spine2d" and not RUST_BIN.is_file():
+        raise SystemExit(f"Missing {RUST_BIN}; run `cargo build --release -p spine2d --example pose_dump_scenario --features json,binary`.")
+    return cmd_record(args) if args.cmd == "record" else cmd_compare(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
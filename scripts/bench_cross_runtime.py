@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+from __future__ import annotations
+
+import argparse
+import json
+import subprocess
+import sys
+from pathlib import Path
+from typing import Dict, List
+
+
+ROOT_DIR = Path(__file__).resolve().parent.parent
+ORACLE_RUNNER = ROOT_DIR / "scripts" / "run_spine_cpp_lite_oracle.zsh"
+RUST_BIN = ROOT_DIR / "target" / "release" / "examples" / "pose_dump_scenario"
+PHASES = ["update", "apply", "world", "render"]
+
+
+def load_manifest(path: Path) -> List[dict]:
+    """
+    Manifest format:
+
+        {"scenarios": [
+          {"name": "spineboy_run",
+           "atlas": "assets/.../spineboy-pma.atlas",
+           "skeleton": "assets/.../spineboy-pro.json",
+           "commands": ["--set", "0", "run", "1"],
+           "steps": {"count": 120, "dt": 0.016666668}}
+        ]}
+
+    `commands` is the usual oracle scenario command stream; `steps` (optional) appends
+    `count` x `--step dt` so long runs do not have to be spelled out.
+    """
+    root = json.loads(path.read_text(encoding="utf-8"))
+    scenarios = root.get("scenarios", [])
+    if not isinstance(scenarios, list) or not scenarios:
+        raise SystemExit(f"manifest has no scenarios: {path}")
+    out = []
+    for s in scenarios:
+        commands = [str(c) for c in s.get("commands", [])]
+        steps = s.get("steps")
+        if steps:
+            commands += ["--step", repr(float(steps["dt"]))] * int(steps["count"])
+        out.append(
+            {
+                "name": s["name"],
+                "atlas": str((ROOT_DIR / s["atlas"]).resolve()),
+                "skeleton": str((ROOT_DIR / s["skeleton"]).resolve()),
+                "commands": commands,
+            }
+        )
+    return out
+
+
+def run_json(argv: List[str]) -> dict:
+    proc = subprocess.run(argv, cwd=str(ROOT_DIR), capture_output=True, text=True)
+    if proc.returncode != 0:
+        raise RuntimeError(
+            f"command failed (code {proc.returncode})\nargv: {argv}\nstderr:\n{proc.stderr}"
+        )
+    return json.loads(proc.stdout.strip().splitlines()[-1])
+
+
+def per_step_us(result: dict, phase: str) -> float:
+    p = result["phases"][phase]
+    steps = max(1, int(result.get("steps", 1)))
+    return float(p["p50Ns"]) / steps / 1000.0
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(
+        description="Run one scenario manifest through spine-cpp (C++ oracle) and spine2d (Rust) and compare per-phase latency."
+    )
+    ap.add_argument("manifest", type=Path)
+    ap.add_argument("--iterations", type=int, default=20)
+    ap.add_argument("--warmup", type=int, default=2)
+    ap.add_argument("--only", type=str, default="", help="Substring filter on scenario name")
+    ap.add_argument("--json-out", type=Path, default=None, help="Write raw results as JSON")
+    ap.add_argument("--no-build", action="store_true", help="Skip `cargo build --release`")
+    args = ap.parse_args()
+
+    scenarios = [s for s in load_manifest(args.manifest) if args.only in s["name"]]
+    if not scenarios:
+        print("No scenarios selected.")
+        return 0
+
+    if not args.no_build:
+        subprocess.run(
+            [
+                "cargo",
+                "build",
+                "--release",
+                "-p",
+                "spine2d",
+                "--example",
+                "pose_dump_scenario",
+                "--features",
+                "json,binary",
+            ],
+            cwd=str(ROOT_DIR),
+            check=True,
+        )
+
+    bench_args = ["--bench", str(args.iterations), "--bench-warmup", str(args.warmup)]
+    results: Dict[str, dict] = {}
+    for s in scenarios:
+        cpp = run_json([str(ORACLE_RUNNER), s["atlas"], s["skeleton"], *bench_args, *s["commands"]])
+        rust = run_json([str(RUST_BIN), s["skeleton"], *bench_args, *s["commands"]])
+        results[s["name"]] = {"spine-cpp": cpp, "spine2d": rust}
+
+    # Speedup > 1 means the Rust runtime is faster than the reference for that phase.
+    header = f"{'scenario':<32} {'phase':<8} {'spine-cpp us/step':>18} {'spine2d us/step':>16} {'speedup':>8}"
+    print(header)
+    print("-" * len(header))
+    slower = 0
+    for name, r in results.items():
+        for phase in PHASES + ["total"]:
+            if phase == "total":
+                cpp_us = sum(per_step_us(r["spine-cpp"], p) for p in PHASES)
+                rust_us = sum(per_step_us(r["spine2d"], p) for p in PHASES)
+            else:
+                cpp_us = per_step_us(r["spine-cpp"], phase)
+                rust_us = per_step_us(r["spine2d"], phase)
+            speedup = cpp_us / rust_us if rust_us > 0 else float("inf")
+            flag = "  <- slower" if speedup < 1.0 else ""
+            if phase == "total" and speedup < 1.0:
+                slower += 1
+            print(f"{name:<32} {phase:<8} {cpp_us:>18.2f} {rust_us:>16.2f} {speedup:>7.2f}x{flag}")
+
+    if args.json_out:
+        args.json_out.write_text(json.dumps(results, indent=2) + "\n", encoding="utf-8")
+
+    print(f"\nscenarios: {len(results)}, rust slower overall: {slower}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+from __future__ import annotations
+
+import argparse
+import json
+import sys
+from pathlib import Path
+from typing import Dict, List, Tuple
+
+from bench_cross_runtime import ORACLE_RUNNER, ROOT_DIR, RUST_BIN, per_step_us, run_json
+
+
+def layered_commands(anims: List[str], tracks: int, blend: str, alpha: float, steps: int, dt: float) -> List[str]:
+    """
+    Track 0 plays `anims[0]` with the default (replace) blend; tracks 1..tracks-1 cycle through
+    `anims[1:]` (or `anims` when only one is given) with `--entry-mix-blend <blend>` and
+    `--entry-alpha <alpha>`, like a locomotion base with upper-body/face/additive layers on top.
+    """
+    layers = anims[1:] or anims
+    cmds = ["--set", "0", anims[0], "1"]
+    for t in range(1, tracks):
+        cmds += ["--set", str(t), layers[(t - 1) % len(layers)], "1"]
+        cmds += ["--entry-mix-blend", blend, "--entry-alpha", repr(alpha)]
+    cmds += ["--step", repr(dt)] * steps
+    return cmds
+
+
+def fit_line(xs: List[float], ys: List[float]) -> Tuple[float, float]:
+    """Least-squares `y = a + b * x`; returns (a, b)."""
+    n = len(xs)
+    if n < 2:
+        return (ys[0] if ys else 0.0), 0.0
+    mx = sum(xs) / n
+    my = sum(ys) / n
+    sxx = sum((x - mx) ** 2 for x in xs)
+    if sxx == 0.0:
+        return my, 0.0
+    b = sum((x - mx) * (y - my) for x, y in zip(xs, ys)) / sxx
+    return my - b * mx, b
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(
+        description="Measure AnimationState apply cost as tracks are layered (1..N) per blend mode and fit a per-track cost model."
+    )
+    ap.add_argument("atlas", type=Path)
+    ap.add_argument("skeleton", type=Path)
+    ap.add_argument("--anims", required=True, help="Comma separated: base animation, then layer animations (cycled)")
+    ap.add_argument("--max-tracks", type=int, default=8)
+    ap.add_argument("--blends", type=str, default="replace,add", help="Blend modes for layers 1..N (default: replace,add)")
+    ap.add_argument("--alpha", type=float, default=1.0, help="--entry-alpha for layers 1..N (default 1)")
+    ap.add_argument("--steps", type=int, default=120)
+    ap.add_argument("--dt", type=float, default=0.016666668)
+    ap.add_argument("--iterations", type=int, default=20)
+    ap.add_argument("--warmup", type=int, default=2)
+    ap.add_argument("--runtime", choices=["spine-cpp", "spine2d"], default="spine-cpp")
+    ap.add_argument("--json-out", type=Path, default=None, help="Write raw bench results as JSON")
+    args = ap.parse_args()
+
+    anims = [a for a in args.anims.split(",") if a]
+    blends = [b for b in args.blends.split(",") if b]
+    if not anims or not blends or args.max_tracks < 1:
+        raise SystemExit("need at least one animation, one blend mode and --max-tracks >= 1")
+    if args.runtime == "spine2d" and not RUST_BIN.is_file():
+        raise SystemExit(f"Missing {RUST_BIN}; run `cargo build --release -p spine2d --example pose_dump_scenario --features json,binary`.")
+
+    atlas = str((ROOT_DIR / args.atlas).resolve())
+    skeleton = str((ROOT_DIR / args.skeleton).resolve())
+    bench_args = ["--bench", str(args.iterations), "--bench-warmup", str(args.warmup)]
+
+    results: Dict[str, Dict[int, dict]] = {}
+    for blend in blends:
+        results[blend] = {}
+        for tracks in range(1, args.max_tracks + 1):
+            cmds = layered_commands(anims, tracks, blend, args.alpha, args.steps, args.dt)
+            if args.runtime == "spine-cpp":
+                argv = [str(ORACLE_RUNNER), atlas, skeleton, *bench_args, *cmds]
+            else:
+                argv = [str(RUST_BIN), skeleton, *bench_args, *cmds]
+            results[blend][tracks] = run_json(argv)
+
+    header = f"{'blend':<8} {'tracks':>6} {'apply us/step':>14} {'per track':>10} {'marginal':>9} {'update':>8} {'world':>8}"
+    print(header)
+    print("-" * len(header))
+    model = {}
+    for blend, by_tracks in results.items():
+        xs: List[float] = []
+        ys: List[float] = []
+        prev = None
+        for tracks, r in sorted(by_tracks.items()):
+            apply_us = per_step_us(r, "apply")
+            marginal = "" if prev is None else f"{apply_us - prev:+9.2f}"
+            prev = apply_us
+            xs.append(float(tracks))
+            ys.append(apply_us)
+            print(
+                f"{blend:<8} {tracks:>6} {apply_us:>14.2f} {apply_us / tracks:>10.2f} {marginal:>9} "
+                f"{per_step_us(r, 'update'):>8.2f} {per_step_us(r, 'world'):>8.2f}"
+            )
+        a, b = fit_line(xs, ys)
+        model[blend] = {"baseUs": a, "perTrackUs": b}
+
+    print("\ncost model (apply us/step = base + perTrack * tracks):")
+    for blend, m in model.items():
+        print(f"  {blend:<8} base {m['baseUs']:.2f}  perTrack {m['perTrackUs']:.2f}")
+
+    if args.json_out:
+        payload = {
+            "runtime": args.runtime,
+            "anims": anims,
+            "alpha": args.alpha,
+            "steps": args.steps,
+            "dt": args.dt,
+            "model": model,
+            "results": {blend: {str(t): r for t, r in by.items()} for blend, by in results.items()},
+        }
+        args.json_out.write_text(json.dumps(payload, indent=2) + "\n", encoding="utf-8")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+from __future__ import annotations
+
+import argparse
+import json
+import math
+import struct
+import subprocess
+import sys
+import tempfile
+from collections import Counter
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+from bench_cross_runtime import ROOT_DIR
+
+DUMP_RUNNER = ROOT_DIR / "scripts" / "run_spine_cpp_lite_dump_constraints.zsh"
+MODEL_DUMP = ROOT_DIR / "target" / "release" / "examples" / "model_dump"
+
+Record = Tuple[str, list]
+
+
+def load_dump(path: Path) -> Dict[str, Record]:
+    """Decodes a canonical model dump (see `spine2d/examples/model_dump.rs`) into key -> (tag, values)."""
+    data = path.read_bytes()
+    if data[:4] != b"SPMD":
+        raise SystemExit(f"{path}: not a model dump")
+    (version,) = struct.unpack_from("<I", data, 4)
+    if version != 1:
+        raise SystemExit(f"{path}: unsupported model dump version {version}")
+    records: Dict[str, Record] = {}
+    pos = 8
+    while pos < len(data):
+        (key_len,) = struct.unpack_from("<H", data, pos)
+        key = data[pos + 2 : pos + 2 + key_len].decode("utf-8")
+        pos += 2 + key_len
+        tag = chr(data[pos])
+        (count,) = struct.unpack_from("<I", data, pos + 1)
+        pos += 5
+        if tag in "fi":
+            values = list(struct.unpack_from(f"<{count}{tag}", data, pos))
+            pos += 4 * count
+        elif tag == "s":
+            values = []
+            for _ in range(count):
+                (n,) = struct.unpack_from("<I", data, pos)
+                values.append(data[pos + 4 : pos + 4 + n].decode("utf-8"))
+                pos += 4 + n
+        else:
+            raise SystemExit(f"{path}: bad tag {tag!r} at {key}")
+        if key in records:
+            raise SystemExit(f"{path}: duplicate record {key}")
+        records[key] = (tag, values)
+    return records
+
+
+def values_differ(tag: str, a: list, b: list, tolerance: float) -> Optional[str]:
+    if len(a) != len(b):
+        return f"count {len(a)} != {len(b)}"
+    for i, (x, y) in enumerate(zip(a, b)):
+        if tag == "f":
+            if math.isnan(x) and math.isnan(y):
+                continue
+            if not abs(x - y) <= tolerance * max(1.0, abs(x), abs(y)):
+                return f"[{i}] {x!r} != {y!r}"
+        elif x != y:
+            return f"[{i}] {x!r} != {y!r}"
+    return None
+
+
+def compare(a: Dict[str, Record], b: Dict[str, Record], tolerance: float) -> List[Tuple[str, str]]:
+    mismatches: List[Tuple[str, str]] = []
+    for key in list(a) + [k for k in b if k not in a]:
+        ra, rb = a.get(key), b.get(key)
+        if ra is None or rb is None:
+            mismatches.append((key, "only in " + ("b" if ra is None else "a")))
+        elif ra[0] != rb[0]:
+            mismatches.append((key, f"type {ra[0]} != {rb[0]}"))
+        else:
+            why = values_differ(ra[0], ra[1], rb[1], tolerance)
+            if why:
+                mismatches.append((key, why))
+    return mismatches
+
+
+def run(argv: List[str]) -> None:
+    proc = subprocess.run(argv, cwd=str(ROOT_DIR), capture_output=True, text=True)
+    if proc.returncode != 0:
+        raise RuntimeError(f"command failed (code {proc.returncode})\nargv: {argv}\nstderr:\n{proc.stderr}")
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(
+        description="Compare two canonical SkeletonData dumps field by field. With --run, dump <skeleton> through "
+        "spine-cpp (spine_cpp_lite_dump_constraints --model-out) and spine2d (model_dump) first."
+    )
+    ap.add_argument("a", type=Path, help="Dump file, or the atlas with --run")
+    ap.add_argument("b", type=Path, help="Dump file, or the skeleton (.json|.skel) with --run")
+    ap.add_argument("--run", action="store_true", help="Produce both dumps from <atlas> <skeleton>")
+    ap.add_argument("--tolerance", type=float, default=1e-5, help="Relative float tolerance (default 1e-5)")
+    ap.add_argument("--limit", type=int, default=40, help="Mismatches to print (default 40)")
+    ap.add_argument("--json-out", type=Path, default=None, help="Write the report as JSON")
+    args = ap.parse_args()
+
+    labels = ("a", "b")
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        if args.run:
+            if not MODEL_DUMP.is_file():
+                raise SystemExit(f"Missing {MODEL_DUMP}; run `cargo build --release -p spine2d --example model_dump --features json,binary`.")
+            atlas = (ROOT_DIR / args.a).resolve()
+            skeleton = (ROOT_DIR / args.b).resolve()
+            cpp_out, rust_out = Path(tmp_dir) / "spine-cpp.bin", Path(tmp_dir) / "spine2d.bin"
+            run([str(DUMP_RUNNER), str(atlas), str(skeleton), "--model-out", str(cpp_out)])
+            run([str(MODEL_DUMP), str(skeleton), str(rust_out)])
+            paths, labels = (cpp_out, rust_out), ("spine-cpp", "spine2d")
+        else:
+            paths = (args.a, args.b)
+        dumps = [load_dump(p) for p in paths]
+
+    mismatches = compare(dumps[0], dumps[1], args.tolerance)
+    mismatches = [(k, why.replace("only in a", f"only in {labels[0]}").replace("only in b", f"only in {labels[1]}")) for k, why in mismatches]
+
+    sections = Counter(key.split("/", 1)[0] for key, _ in mismatches)
+    print(f"records: {labels[0]}={len(dumps[0])} {labels[1]}={len(dumps[1])}  mismatches: {len(mismatches)}")
+    for section, n in sorted(sections.items()):
+        print(f"  {section:<12} {n}")
+    for key, why in mismatches[: args.limit]:
+        print(f"{key}: {why}")
+    if len(mismatches) > args.limit:
+        print(f"... {len(mismatches) - args.limit} more")
+    print("OK" if not mismatches else "MISMATCH")
+
+    if args.json_out:
+        report = {
+            "labels": list(labels),
+            "records": [len(d) for d in dumps],
+            "tolerance": args.tolerance,
+            "sections": dict(sections),
+            "mismatches": [{"key": k, "why": why} for k, why in mismatches],
+            "ok": not mismatches,
+        }
+        args.json_out.write_text(json.dumps(report, indent=2) + "\n", encoding="utf-8")
+    return 0 if not mismatches else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -38,9 +38,27 @@ def load_pose(path: Path) -> dict:
         "ikConstraints": load_named_map("ikConstraints"),
         "transformConstraints": load_named_map("transformConstraints"),
         "pathConstraints": load_named_map("pathConstraints"),
+        "allSlotVertices": load_all_slot_vertices(root),
     }
 
 
+def load_all_slot_vertices(root: dict) -> dict | None:
+    """`debug.allSlotVertices` (from `--dump-all-slot-vertices`) split back into per-slot runs."""
+    block = (root.get("debug") or {}).get("allSlotVertices")
+    if not isinstance(block, dict):
+        return None
+    flat = block.get("vertices", []) or []
+    out = {}
+    for entry in block.get("slots", []) or []:
+        name = entry.get("name")
+        if not isinstance(name, str):
+            continue
+        off = int(entry.get("offset", 0))
+        n = int(entry.get("length", 0))
+        out[name] = {"attachment": entry.get("attachment"), "vertices": flat[off : off + n]}
+    return out
+
+
 def get_float(obj: dict, key: str, default: float = 0.0) -> float:
     v = obj.get(key, default)
     if isinstance(v, (int, float)) and math.isfinite(v):
@@ -267,6 +285,33 @@ def main() -> int:
         ["position", "spacing", "mixRotate", "mixX", "mixY", "active"],
     )
 
+    # World vertices of every vertex attachment (only when both sides ran `--dump-all-slot-vertices`).
+    rv = rust.get("allSlotVertices")
+    cv = cpp.get("allSlotVertices")
+    if rv is not None and cv is not None:
+        names = sorted(set(rv.keys()) | set(cv.keys()))
+        missing = [n for n in names if n not in rv or n not in cv]
+        if missing:
+            print(f"\nmissing allSlotVertices slots: {len(missing)}")
+            for n in missing[: min(20, len(missing))]:
+                print(f"  {n}")
+        worst = []
+        for n in names:
+            r = rv.get(n)
+            c = cv.get(n)
+            if r is None or c is None:
+                continue
+            if r["attachment"] != c["attachment"] or len(r["vertices"]) != len(c["vertices"]):
+                worst.append((math.inf, n))
+                continue
+            m = max((abs(float(a) - float(b)) for a, b in zip(r["vertices"], c["vertices"])), default=0.0)
+            if m >= args.eps:
+                worst.append((m, n))
+        worst.sort(reverse=True)
+        print(f"\nallSlotVertices diff >= {args.eps}: {len(worst)}/{len(names)}")
+        for m, n in worst[: args.top]:
+            print(f"{m:.6g}\t{n}")
+
     if args.bone:
         n = args.bone
         print("\n--- bone ---")
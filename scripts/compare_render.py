@@ -23,9 +23,17 @@ class Triangle:
     ref: TriRef
 
 
-def _load_json(path: Path) -> dict:
-    with path.open("r", encoding="utf-8") as f:
-        return json.load(f)
+def _load_json(path: Path, frame: int = 0) -> dict:
+    """A single render dump, or frame `frame` of an NDJSON `--render-every/--render-at` sequence."""
+    text = path.read_text(encoding="utf-8")
+    lines = [line for line in text.splitlines() if line.strip()]
+    if len(lines) <= 1:
+        return json.loads(text)
+    for line in lines:
+        doc = json.loads(line)
+        if int(doc.get("frame", -1)) == frame:
+            return doc
+    raise SystemExit(f"{path}: no frame {frame} in sequence ({len(lines)} lines)")
 
 
 def _is_finite(x: float) -> bool:
@@ -133,10 +141,11 @@ def main() -> int:
     ap.add_argument("--eps-color", type=int, default=1, help="Color channel epsilon (0-255)")
     ap.add_argument("--ignore-page", action="store_true", help="Ignore atlas page mismatch")
     ap.add_argument("--ignore-blend", action="store_true", help="Ignore blend mode mismatch")
+    ap.add_argument("--frame", type=int, default=0, help="Frame index when an input is an NDJSON frame sequence")
     args = ap.parse_args()
 
-    doc_a = _load_json(args.a)
-    doc_b = _load_json(args.b)
+    doc_a = _load_json(args.a, args.frame)
+    doc_b = _load_json(args.b, args.frame)
     tris_a = _triangles(doc_a)
     tris_b = _triangles(doc_b)
 
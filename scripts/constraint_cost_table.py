@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+from __future__ import annotations
+
+import argparse
+import json
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+from typing import Any, Dict, List
+
+from bench_cross_runtime import ROOT_DIR
+
+BENCH_RUNNER = ROOT_DIR / "scripts" / "run_spine_cpp_lite_constraint_bench.zsh"
+CONSTRAINT_BENCH = ROOT_DIR / "target" / "release" / "examples" / "constraint_bench"
+
+
+def run_json(argv: List[str], allow_fail: bool = False) -> Dict[str, Any]:
+    proc = subprocess.run(argv, cwd=str(ROOT_DIR), capture_output=True, text=True)
+    if proc.returncode != 0 and not (allow_fail and proc.stdout.strip()):
+        raise RuntimeError(f"command failed (code {proc.returncode})\nargv: {argv}\nstderr:\n{proc.stderr}")
+    return json.loads(proc.stdout.strip().splitlines()[-1])
+
+
+def us(ns: Any) -> str:
+    return f"{ns / 1000:>8.2f}u" if isinstance(ns, (int, float)) else f"{'-':>9}"
+
+
+def variant_label(mode: str, v: Dict[str, Any]) -> str:
+    if mode == "ik":
+        flags = "".join(f for f, on in (("C", v["compress"]), ("S", v["stretch"]), ("U", v["uniform"])) if on)
+        return f"{v['bones']}-bone mix={v['mix']:g} soft={v['softness']:g} bend={v['bend']:+d} {flags or '-'}"
+    if mode == "transform-fanout":
+        flags = "".join(f for f, key in (("S", "localSource"), ("T", "localTarget"), ("A", "additive"), ("C", "clamp")) if v[key])
+        return f"{flags or '-'} x{v['bones']}"
+    return Path(v["file"]).stem
+
+
+def fanout_growth(sizes: List[Dict[str, Any]], key: str) -> Any:
+    """Per-bone `key` at the largest fan-out over that at the next largest (<= ~1 when linear)."""
+    if len(sizes) < 2 or not all(isinstance(s.get(key), (int, float)) for s in sizes[-2:]):
+        return None
+    prev, last = sizes[-2], sizes[-1]
+    return (last[key] / last["bones"]) / (prev[key] / prev["bones"]) if prev[key] else None
+
+
+def print_sliders(cpp: Dict[str, Any]) -> int:
+    print(
+        f"{'slider':<24} {'animation':<20} {'driver':<16} {'tl':>3} {'slider':>9} {'track':>9} {'x track':>7} "
+        f"{'swept':>13} {'pose diff':>9}"
+    )
+    failures = 0
+    for s in cpp["sliders"]:
+        driver = f"{s['bone']}.{s['property']}" if s["bone"] else "time"
+        if not s.get("active"):
+            print(f"{s['name']:<24} {s['animation']:<20} {driver:<16}  inactive")
+            continue
+        swept = f"{s['sweep']['minTime']:.2f}..{s['sweep']['maxTime']:.2f}"
+        diff = "(mixed)"
+        if s["comparable"]:
+            ok = s["poseDiffVsTrack"] <= cpp["tolerance"]
+            failures += 0 if ok else 1
+            diff = f"{s['poseDiffVsTrack']:.1e}" + ("" if ok else "!")
+        print(
+            f"{s['name']:<24} {s['animation']:<20} {driver:<16} {s['timelines']:>3} {us(s['sliderP50Ns'])} "
+            f"{us(s['trackApplyP50Ns'])} {s['costVsTrack']:>6.2f}x {swept:>13} {diff:>9}"
+        )
+    print(
+        "p50; u = microseconds; slider = its update re-run on the already-solved pose, track = AnimationState::apply "
+        "of the same animation; pose diff = max world transform difference vs the track at the time the slider reached"
+    )
+    if failures:
+        print(f"{failures} slider(s) differ from the track by more than {cpp['tolerance']:g}")
+    return failures
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(
+        description="Per-constraint solve cost in spine-cpp (spine_cpp_lite_constraint_bench) on an asset and on "
+        "synthetic skeletons, joined with spine2d's updateWorldTransform time on the same synthetic files "
+        "(constraint_bench example). IK variants are also checked pose by pose against spine-cpp, and transform fan-out "
+        "combinations for superlinear per-bone cost. --mode slider reports the asset's sliders against a plain track apply."
+    )
+    ap.add_argument("atlas", type=Path)
+    ap.add_argument("skeleton", type=Path)
+    ap.add_argument("--mode", choices=["path", "ik", "transform-fanout", "slider"], default="path", help="Constraint family to sweep (default path)")
+    ap.add_argument("--iterations", type=int, default=200, help="Timed frames per constraint (default 200)")
+    ap.add_argument(
+        "--bones",
+        default=None,
+        help="Constrained bones per synthetic variant, e.g. 1,4,16,64 (fan-out default 1,10,100,1000)",
+    )
+    ap.add_argument("--points", default=None, help="Path points per synthetic path, e.g. 2,8,32")
+    ap.add_argument("--targets", type=int, default=None, help="IK targets per constraint (default 16)")
+    ap.add_argument("--sweep-points", type=int, default=None, help="Slider: points across the animation (default 32)")
+    ap.add_argument(
+        "--tolerance", type=float, default=None, help="Slider: largest accepted pose diff vs the track (default 1e-3)"
+    )
+    ap.add_argument("--seed", type=int, default=None, help="IK target seed (default 1)")
+    ap.add_argument(
+        "--linearity-limit", type=float, default=None, help="Fan-out: largest accepted per-bone cost growth (default 1.5)"
+    )
+    ap.add_argument("--all-modes", action="store_true", help="Every mode combination, not just the asset's")
+    ap.add_argument("--no-rust", action="store_true", help="Skip the spine2d side")
+    ap.add_argument("--json-out", type=Path, default=None, help="Write all results as JSON")
+    args = ap.parse_args()
+
+    if args.mode == "slider":
+        args.no_rust = True
+    if not args.no_rust and not CONSTRAINT_BENCH.is_file():
+        raise SystemExit(
+            f"Missing {CONSTRAINT_BENCH}; run `cargo build --release -p spine2d --example constraint_bench --features json` "
+            "or pass --no-rust."
+        )
+
+    argv = [
+        str(BENCH_RUNNER),
+        str((ROOT_DIR / args.atlas).resolve()),
+        str((ROOT_DIR / args.skeleton).resolve()),
+        f"--{args.mode}",
+        "--iterations",
+        str(args.iterations),
+    ]
+    for flag, value in (
+        ("--bones", args.bones),
+        ("--points", args.points),
+        ("--targets", args.targets),
+        ("--seed", args.seed),
+        ("--linearity-limit", args.linearity_limit),
+        ("--sweep-points", args.sweep_points),
+        ("--tolerance", args.tolerance),
+    ):
+        if value is not None:
+            argv += [flag, str(value)]
+    if args.all_modes:
+        argv.append("--all-modes")
+
+    if args.mode == "slider":
+        cpp = run_json(argv, allow_fail=True)
+        failures = print_sliders(cpp)
+        if args.json_out:
+            args.json_out.write_text(json.dumps(cpp, indent=2) + "\n", encoding="utf-8")
+        return 0 if failures == 0 else 1
+
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        cpp = run_json(argv + ["--emit-dir", tmp_dir], allow_fail=True)
+        rust: Dict[str, Dict[str, Any]] = {}
+        if not args.no_rust:
+            report = run_json(
+                [str(CONSTRAINT_BENCH), str(Path(tmp_dir) / "manifest.json"), "--iterations", str(args.iterations)],
+                allow_fail=True,
+            )
+            rust = {v["file"]: v for v in report["variants"]}
+
+    print(f"{'asset constraint':<32} {'bones':>5} {'solve':>9} {'/bone':>9} {'world':>9}")
+    for c in cpp["asset"]:
+        if not c.get("active"):
+            print(f"{c['name']:<32} {c['bones']:>5}  inactive")
+            continue
+        print(f"{c['name']:<32} {c['bones']:>5} {us(c['solveP50Ns'])} {us(c.get('perBoneNs'))} {us(c['worldP50Ns'])}")
+
+    print()
+    print(
+        f"{'synthetic variant':<48} {'solve':>9} {'/bone':>9} {'cpp world':>9} {'rs world':>9} {'rs/cpp':>6} "
+        f"{'pose diff':>9}"
+    )
+    failures = 0
+    groups = cpp["synthetic"] if args.mode == "transform-fanout" else []
+    rows = [v for g in groups for v in g["sizes"]] if groups else cpp["synthetic"]
+    for v in rows:
+        r = rust.get(v["file"], {})
+        rust_world = r.get("rustWorldP50Ns")
+        ratio = f"{rust_world / v['worldP50Ns']:>6.2f}" if rust_world and v["worldP50Ns"] else f"{'-':>6}"
+        v["rustWorldP50Ns"] = rust_world
+        diff = "-"
+        if "maxPoseDiff" in r:
+            v["maxPoseDiff"] = r["maxPoseDiff"]
+            ok = r["maxPoseDiff"] <= report["tolerance"]
+            failures += 0 if ok else 1
+            diff = f"{r['maxPoseDiff']:.1e}" + ("" if ok else "!")
+        per_bone = v.get("perBoneNs", v["solveP50Ns"] / v["bones"])
+        print(
+            f"{variant_label(args.mode, v):<48} {us(v['solveP50Ns'])} {us(per_bone)} {us(v['worldP50Ns'])} "
+            f"{us(rust_world)} {ratio} {diff:>9}"
+        )
+    print("p50 per frame; u = microseconds; solve = the constraint's update re-run on the pose updateWorldTransform already solved")
+
+    if groups:
+        limit = cpp["linearityLimit"]
+        print()
+        print(f"{'fan-out flags':<16} {'cpp solve growth':>16} {'rs world growth':>16}")
+        for g in groups:
+            rust_growth = fanout_growth(g["sizes"], "rustWorldP50Ns")
+            g["rustGrowth"] = rust_growth
+            nonlinear = not g["linear"] or (rust_growth is not None and rust_growth > limit)
+            failures += 1 if nonlinear else 0
+            rs = f"{rust_growth:>16.2f}" if rust_growth is not None else f"{'-':>16}"
+            label = variant_label(args.mode, {**g, "bones": 0}).rsplit(" x", 1)[0]
+            print(f"{label:<16} {g['growth']:>16.2f} {rs}" + ("  SUPERLINEAR" if nonlinear else ""))
+        print(f"growth = per-bone cost at the largest size / at the next largest; limit {limit:g}")
+    if failures:
+        print(f"{failures} variant(s) failed the pose or linearity check")
+
+    if args.json_out:
+        args.json_out.write_text(json.dumps(cpp, indent=2) + "\n", encoding="utf-8")
+    return 0 if failures == 0 else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+from __future__ import annotations
+
+import argparse
+import json
+import math
+import os
+import re
+import subprocess
+import sys
+from pathlib import Path
+from typing import Dict, Iterable, List, Optional, Tuple
+
+from bench_cross_runtime import PHASES, ROOT_DIR
+from record_oracle_goldens import TESTS_RS, extract_scenarios, find_examples_root, iter_atlas_candidates
+from record_oracle_render_goldens import cases_json, scenario_cases_json
+
+
+POSE_RUNNER = ROOT_DIR / "scripts" / "run_spine_cpp_lite_oracle.zsh"
+RENDER_RUNNER = ROOT_DIR / "scripts" / "run_spine_cpp_lite_render_oracle.zsh"
+PROFILES = ["strict", "o3-native", "fast-math", "lto", "all"]
+
+
+def run(argv: List[str], profile: str) -> str:
+    env = dict(os.environ, SPINE2D_ORACLE_OPT=profile)
+    proc = subprocess.run(argv, cwd=str(ROOT_DIR), capture_output=True, text=True, env=env)
+    if proc.returncode != 0:
+        raise RuntimeError(f"[{profile}] command failed (code {proc.returncode})\nargv: {argv}\nstderr:\n{proc.stderr}")
+    return proc.stdout.strip().splitlines()[-1]
+
+
+def floats(values: Iterable) -> List[float]:
+    return [float(v) for v in values if isinstance(v, (int, float))]
+
+
+def max_abs_diff(a: List[float], b: List[float]) -> float:
+    if len(a) != len(b):
+        return math.inf
+    return max((abs(x - y) if math.isfinite(x) and math.isfinite(y) else math.inf for x, y in zip(a, b)), default=0.0)
+
+
+def pose_vector(doc: dict) -> List[float]:
+    """Bone world/applied transforms and slot colors, in output order."""
+    out: List[float] = []
+    for b in doc.get("bones", []):
+        out += floats(b.get("world", {}).get(k) for k in ["a", "b", "c", "d", "x", "y"])
+        out += floats(b.get("applied", {}).get(k) for k in ["x", "y", "rotation", "scaleX", "scaleY", "shearX", "shearY"])
+    for s in doc.get("slots", []):
+        out += floats(s.get("color", []))
+        out += floats(s.get("darkColor", []))
+    return out
+
+
+def render_vector(doc: dict) -> List[float]:
+    """Draw positions and UVs, in draw order (only comparable when `render_shape` matches)."""
+    out: List[float] = []
+    for d in doc.get("draws", []):
+        out += floats(d.get("positions", []))
+        out += floats(d.get("uvs", []))
+    return out
+
+
+def render_shape(doc: dict) -> List[Tuple[int, str, int, int]]:
+    return [(int(d["page"]), str(d["blend"]), int(d["num_vertices"]), int(d["num_indices"])) for d in doc.get("draws", [])]
+
+
+def pose_cases(examples_root: Path, only: Optional[re.Pattern], limit: int) -> List[Tuple[str, List[str]]]:
+    out: List[Tuple[str, List[str]]] = []
+    for s in sorted(extract_scenarios(TESTS_RS), key=lambda s: s.golden_file):
+        if s.golden_is_skel or (only and not only.search(s.golden_file)):
+            continue
+        skel = examples_root / s.skeleton_rel
+        atlases = iter_atlas_candidates(skel.parent)
+        if not skel.is_file() or not atlases:
+            continue
+        out.append((s.golden_file, [str(atlases[0]), str(skel), *s.commands]))
+        if limit and len(out) >= limit:
+            break
+    return out
+
+
+def render_cases(examples_root: Path, only: Optional[re.Pattern], limit: int) -> List[Tuple[str, List[str]]]:
+    out: List[Tuple[str, List[str]]] = []
+    for c in cases_json():
+        args = [str(examples_root / c.atlas), str(examples_root / c.skeleton), "--anim", c.anim]
+        args += ["--time", c.time.replace("_", "."), "--loop", c.looped, "--physics", c.physics]
+        if c.skin is not None:
+            args += ["--skin", c.skin]
+        out.append((c.golden_name(), args))
+    for c in scenario_cases_json():
+        out.append((c.golden_name(), [str(examples_root / c.atlas), str(examples_root / c.skeleton), *c.commands]))
+    out = [(n, a) for n, a in out if Path(a[1]).is_file() and (not only or only.search(n))]
+    return out[:limit] if limit else out
+
+
+def bench_us(result: dict) -> float:
+    steps = max(1, int(result.get("steps", 1)))
+    return sum(float(result["phases"][p]["p50Ns"]) for p in PHASES) / steps / 1000.0
+
+
+def geomean(xs: List[float]) -> float:
+    xs = [x for x in xs if x > 0 and math.isfinite(x)]
+    return math.exp(sum(math.log(x) for x in xs) / len(xs)) if xs else 0.0
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(
+        description="Build the spine-cpp oracle under several optimization profiles, run the golden scenarios, and "
+        "report speedup and pose/render drift against the strict (-O2) build."
+    )
+    ap.add_argument("--profiles", type=str, default=",".join(PROFILES[1:]), help="Profiles to compare against strict")
+    ap.add_argument("--only", type=str, default="", help="Regex filter on golden filename")
+    ap.add_argument("--limit", type=int, default=0, help="Max scenarios per kind (pose, render)")
+    ap.add_argument("--iterations", type=int, default=10, help="--bench iterations per pose scenario")
+    ap.add_argument("--warmup", type=int, default=2)
+    ap.add_argument("--json-out", type=Path, default=None, help="Write per-scenario results as JSON")
+    args = ap.parse_args()
+
+    profiles = [p for p in args.profiles.split(",") if p and p != "strict"]
+    unknown = [p for p in profiles if p not in PROFILES]
+    if unknown:
+        raise SystemExit(f"unknown profiles: {unknown} (choose from {PROFILES})")
+
+    examples_root = find_examples_root()
+    only = re.compile(args.only) if args.only else None
+    poses = pose_cases(examples_root, only, args.limit)
+    renders = render_cases(examples_root, only, args.limit)
+    if not poses and not renders:
+        print("No scenarios selected.")
+        return 0
+    bench_args = ["--bench", str(args.iterations), "--bench-warmup", str(args.warmup)]
+
+    def run_profile(profile: str) -> Dict[str, dict]:
+        out: Dict[str, dict] = {"pose": {}, "render": {}, "bench": {}}
+        for name, argv in poses:
+            out["pose"][name] = json.loads(run([str(POSE_RUNNER), *argv], profile))
+            # Legacy (`<animation> <time>`) goldens have no scenario commands to time.
+            if len(argv) > 2 and argv[2].startswith("--"):
+                bench_argv = [str(POSE_RUNNER), argv[0], argv[1], *bench_args, *argv[2:]]
+                out["bench"][name] = bench_us(json.loads(run(bench_argv, profile)))
+        for name, argv in renders:
+            out["render"][name] = json.loads(run([str(RENDER_RUNNER), *argv], profile))
+        return out
+
+    print(f"strict: {len(poses)} pose + {len(renders)} render scenarios", flush=True)
+    strict = run_profile("strict")
+
+    header = f"{'profile':<10} {'speedup':>8} {'max pose dev':>13} {'max render dev':>15} {'shape diffs':>11}  worst"
+    rows = []
+    report = {"strict": strict, "profiles": {}}
+    for profile in profiles:
+        print(f"{profile}: building + running", flush=True)
+        cur = run_profile(profile)
+        speedups = [strict["bench"][n] / cur["bench"][n] for n in cur["bench"] if cur["bench"][n] > 0]
+        pose_dev = {n: max_abs_diff(pose_vector(strict["pose"][n]), pose_vector(cur["pose"][n])) for n in cur["pose"]}
+        render_dev: Dict[str, float] = {}
+        shape_diffs = 0
+        for n, doc in cur["render"].items():
+            if render_shape(doc) != render_shape(strict["render"][n]):
+                shape_diffs += 1
+                render_dev[n] = math.inf
+            else:
+                render_dev[n] = max_abs_diff(render_vector(strict["render"][n]), render_vector(doc))
+        worst = max(list(pose_dev.items()) + list(render_dev.items()), key=lambda kv: kv[1], default=("-", 0.0))
+        rows.append(
+            f"{profile:<10} {geomean(speedups):>7.2f}x {max(pose_dev.values(), default=0.0):>13.3g} "
+            f"{max(render_dev.values(), default=0.0):>15.3g} {shape_diffs:>11}  {worst[0]} ({worst[1]:.3g})"
+        )
+        report["profiles"][profile] = {
+            "speedupGeomean": geomean(speedups),
+            "poseDeviation": pose_dev,
+            "renderDeviation": render_dev,
+            "renderShapeDiffs": shape_diffs,
+            "benchUsPerStep": cur["bench"],
+        }
+
+    print()
+    print(header)
+    print("-" * len(header))
+    print(f"{'strict':<10} {1.0:>7.2f}x {0.0:>13.3g} {0.0:>15.3g} {0:>11}")
+    for row in rows:
+        print(row)
+
+    if args.json_out:
+        # Infinite deviations (shape mismatch, non-finite values) are written as null.
+        def clean(v):
+            if isinstance(v, dict):
+                return {k: clean(x) for k, x in v.items()}
+            if isinstance(v, float) and not math.isfinite(v):
+                return None
+            return v
+
+        args.json_out.write_text(json.dumps(clean(report["profiles"]), indent=2) + "\n", encoding="utf-8")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -64,17 +64,92 @@ def patch_spine_cpp_slider_cpp(text: str) -> str:
     return text2
 
 
+UPDATE_PROBE_MARKER = "SPINE2D_ORACLE_PATCH_UPDATE_CACHE_PROBE"
+
+
+def patch_spine_cpp_skeleton_cpp_update_probe(text: str) -> str:
+    """Wraps each update cache entry in `Skeleton::updateWorldTransform` with a steady_clock probe.
+
+    The probe is the `spine::spine2d_oracle_update_probe` function pointer defined by the patch; it is
+    null (one branch per entry) unless the oracle installs it for `--update-cache-timing`.
+    """
+    if UPDATE_PROBE_MARKER in text:
+        return text
+
+    includes = list(re.finditer(r"^#include\s*[<\"][^>\"]+[>\"][ \t]*$", text, re.MULTILINE))
+    if not includes:
+        raise RuntimeError("Unexpected Skeleton.cpp: no #include lines")
+
+    signature = re.search(r"void\s+Skeleton::updateWorldTransform\s*\(\s*Physics\s+physics\s*\)\s*\{", text)
+    if not signature:
+        raise RuntimeError("Failed to patch Skeleton.cpp: updateWorldTransform(Physics) not found (upstream changed?)")
+    depth, end = 1, signature.end()
+    while depth and end < len(text):
+        depth += {"{": 1, "}": -1}.get(text[end], 0)
+        end += 1
+    body = text[signature.end() : end]
+
+    call = re.compile(r"(?P<entry>[A-Za-z_][\w.>-]*(?:\(\))?\[i\])->update\(\s*\*this\s*,\s*physics\s*\)\s*;")
+    match = call.search(body)
+    if not match:
+        raise RuntimeError("Failed to patch Skeleton.cpp: update cache loop not found (upstream changed?)")
+    entry = match.group("entry")
+    probed = "\n".join(
+        [
+            "if (spine2d_oracle_update_probe) {",
+            "\t\t\tstd::chrono::steady_clock::time_point spine2d_t0 = std::chrono::steady_clock::now();",
+            f"\t\t\t{entry}->update(*this, physics);",
+            f"\t\t\tspine2d_oracle_update_probe({entry}, (long long) std::chrono::duration_cast<std::chrono::nanoseconds>(",
+            "\t\t\t\tstd::chrono::steady_clock::now() - spine2d_t0).count());",
+            "\t\t} else {",
+            f"\t\t\t{entry}->update(*this, physics);",
+            "\t\t}",
+        ]
+    )
+    body = body[: match.start()] + probed + body[match.end() :]
+    text = text[: signature.end()] + body + text[end:]
+
+    last_include = includes[-1]
+    declaration = "\n".join(
+        [
+            "",
+            "#include <chrono>",
+            f"// {UPDATE_PROBE_MARKER}",
+            "namespace spine {",
+            "\tclass Update;",
+            "\tvoid (*spine2d_oracle_update_probe)(Update *entry, long long ns) = nullptr;",
+            "}",
+        ]
+    )
+    return text[: last_include.end()] + declaration + text[last_include.end() :]
+
+
+PATCHES = {
+    "slider": patch_spine_cpp_slider_cpp,
+    "update-probe": patch_spine_cpp_skeleton_cpp_update_probe,
+}
+
+
 def main() -> int:
     ap = argparse.ArgumentParser()
-    ap.add_argument("--in", dest="inp", required=True, help="Input Slider.cpp path")
-    ap.add_argument("--out", dest="out", required=True, help="Output patched Slider.cpp path")
+    ap.add_argument("--in", dest="inp", required=True, help="Input source path (Slider.cpp, or Skeleton.cpp for update-probe)")
+    ap.add_argument("--out", dest="out", required=True, help="Output patched source path")
+    ap.add_argument(
+        "--patch",
+        choices=sorted(PATCHES),
+        default="slider",
+        help="slider: Slider.cpp slot timeline cast fix (default); update-probe: Skeleton.cpp per-update-cache-entry timing",
+    )
     args = ap.parse_args()
 
     inp = Path(args.inp)
     out = Path(args.out)
     src = inp.read_text(encoding="utf-8")
-    patched = patch_spine_cpp_slider_cpp(src)
+    patched = PATCHES[args.patch](src)
 
+    # Leave an up-to-date output untouched so its mtime does not force a rebuild of the object.
+    if out.is_file() and out.read_text(encoding="utf-8") == patched:
+        return 0
     out.parent.mkdir(parents=True, exist_ok=True)
     out.write_text(patched, encoding="utf-8")
     return 0
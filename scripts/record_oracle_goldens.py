@@ -238,6 +238,22 @@ def parse_commands_no_loops(body: str, env: Dict[str, float]) -> List[str]:
         r"skeleton\s*\.\s*set_skin\s*\(\s*None\s*\)",
         lambda m: ["--set-skin", "none"],
     )
+    add(
+        r"skeleton\s*\.\s*set_wind\s*\(\s*([^\),]+?)\s*,\s*([^\)]+?)\s*\)",
+        lambda m: [
+            "--wind",
+            value_to_string(parse_value(m.group(1), env)),
+            value_to_string(parse_value(m.group(2), env)),
+        ],
+    )
+    add(
+        r"skeleton\s*\.\s*set_gravity\s*\(\s*([^\),]+?)\s*,\s*([^\)]+?)\s*\)",
+        lambda m: [
+            "--gravity",
+            value_to_string(parse_value(m.group(1), env)),
+            value_to_string(parse_value(m.group(2), env)),
+        ],
+    )
 
     # TrackEntry / last-entry mutations.
     add(
@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+from __future__ import annotations
+
+import argparse
+import json
+import math
+import statistics
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+from bench_cross_runtime import ORACLE_RUNNER, ROOT_DIR
+
+CONVERTER = ROOT_DIR / "target" / "release" / "examples" / "skel_convert"
+
+FrameKey = Tuple[str, str, float]
+
+
+def run(argv: List[str]) -> str:
+    proc = subprocess.run(argv, cwd=str(ROOT_DIR), capture_output=True, text=True)
+    if proc.returncode != 0:
+        raise RuntimeError(
+            f"command failed (code {proc.returncode})\nargv: {argv}\nstdout:\n{proc.stdout}\nstderr:\n{proc.stderr}"
+        )
+    return proc.stdout
+
+
+def load_sweep(path: Path) -> Dict[FrameKey, dict]:
+    """`--sweep` frames keyed by (animation, skin, time): the JSON and .skel loaders may order
+    animations and skins differently."""
+    frames: Dict[FrameKey, dict] = {}
+    for line in path.read_text(encoding="utf-8").splitlines():
+        if line.strip():
+            doc = json.loads(line)
+            frames[(doc["animation"], doc["skin"], round(float(doc["time"]), 6))] = doc
+    return frames
+
+
+def frame_diff(a: dict, b: dict) -> float:
+    """Max abs difference over bone/slot numbers; inf when shapes or attachments differ."""
+    worst = 0.0
+    for key in ["bones", "slots"]:
+        if len(a[key]) != len(b[key]):
+            return math.inf
+        for ra, rb in zip(a[key], b[key]):
+            if len(ra) != len(rb):
+                return math.inf
+            for x, y in zip(ra, rb):
+                if isinstance(x, (int, float)) and isinstance(y, (int, float)):
+                    worst = max(worst, abs(x - y) if math.isfinite(x) and math.isfinite(y) else math.inf)
+                elif x != y:
+                    return math.inf
+    return worst
+
+
+def skeleton_load_us(atlas: Path, skeleton: Path, tmp: Path) -> float:
+    """spine-cpp skeleton load time from the oracle's `--trace-out` "load/skeleton" zone."""
+    trace = tmp / "load-trace.json"
+    run([str(ORACLE_RUNNER), str(atlas), str(skeleton), "--trace-out", str(trace), "--sweep", str(tmp / "load.ndjson"), "--sweep-hz", "1"])
+    events = json.loads(trace.read_text(encoding="utf-8"))["traceEvents"]
+    return next(float(e["dur"]) for e in events if e.get("cat") == "load" and e.get("name") == "skeleton")
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(
+        description="Convert a JSON skeleton to .skel with spine2d, check that spine-cpp poses both files identically over "
+        "every animation x skin x time grid, and compare spine-cpp load times."
+    )
+    ap.add_argument("atlas", type=Path)
+    ap.add_argument("skeleton", type=Path, help="Input .json")
+    ap.add_argument("--out", type=Path, default=None, help="Output .skel (default: next to the input)")
+    ap.add_argument("--hz", type=float, default=30.0)
+    ap.add_argument("--tolerance", type=float, default=1e-4)
+    ap.add_argument("--load-runs", type=int, default=10, help="Oracle runs per format for load timing (0 = skip)")
+    ap.add_argument(
+        "--load-iterations", type=int, default=100, help="spine2d in-process loads per format for load timing (0 = skip)"
+    )
+    ap.add_argument("--json-out", type=Path, default=None, help="Write the report as JSON")
+    args = ap.parse_args()
+
+    if not CONVERTER.is_file():
+        raise SystemExit(f"Missing {CONVERTER}; run `cargo build --release -p spine2d --example skel_convert --features json,binary`.")
+    atlas = (ROOT_DIR / args.atlas).resolve()
+    json_path = (ROOT_DIR / args.skeleton).resolve()
+    skel_path = args.out.resolve() if args.out else json_path.with_suffix(".converted.skel")
+
+    convert_argv = [str(CONVERTER), str(json_path), str(skel_path), "--check", "--hz", repr(args.hz)]
+    convert_argv += ["--load-iterations", str(args.load_iterations)]
+    convert = json.loads(run(convert_argv).strip().splitlines()[-1])
+
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        tmp = Path(tmp_dir)
+        sweeps: Dict[str, Dict[FrameKey, dict]] = {}
+        for name, path in [("json", json_path), ("skel", skel_path)]:
+            out = tmp / f"{name}.ndjson"
+            run([str(ORACLE_RUNNER), str(atlas), str(path), "--sweep", str(out), "--sweep-hz", repr(args.hz)])
+            sweeps[name] = load_sweep(out)
+
+        missing = sorted(set(sweeps["json"]) ^ set(sweeps["skel"]))
+        worst: Tuple[float, Optional[FrameKey]] = (0.0, None)
+        for key, a in sweeps["json"].items():
+            b = sweeps["skel"].get(key)
+            if b is not None:
+                d = frame_diff(a, b)
+                if d > worst[0] or (d == math.inf and worst[1] is None):
+                    worst = (d, key)
+
+        load: Dict[str, List[float]] = {"json": [], "skel": []}
+        for _ in range(args.load_runs):
+            for name, path in [("json", json_path), ("skel", skel_path)]:
+                load[name].append(skeleton_load_us(atlas, path, tmp))
+
+    ok = not missing and worst[0] <= args.tolerance
+    print(f"{'file':<6} {'bytes':>10} {'spine-cpp load us (median)':>27} {'spine2d load us (median)':>25}")
+    rust_load = convert.get("load", {})
+    for name, path in [("json", json_path), ("skel", skel_path)]:
+        cpp = f"{statistics.median(load[name]):.1f}" if load[name] else "-"
+        rust = rust_load.get(f"{name}MedianUs")
+        print(f"{name:<6} {path.stat().st_size:>10} {cpp:>27} {(f'{rust:.1f}' if rust else '-'):>25}")
+    print()
+    print(f"frames compared: {len(sweeps['json']) - len(missing)}  missing on one side: {len(missing)}")
+    print(f"max spine-cpp pose diff json vs skel: {worst[0]:.3g}" + (f" at {worst[1]}" if worst[1] else ""))
+    print(f"max spine2d pose diff json vs skel: {convert['check']['maxDiff']}")
+    print("OK" if ok else "MISMATCH")
+
+    if args.json_out:
+        report = {
+            "json": str(json_path),
+            "skel": str(skel_path),
+            "hz": args.hz,
+            "converter": convert,
+            "spineCpp": {
+                "framesCompared": len(sweeps["json"]) - len(missing),
+                "missing": [list(k) for k in missing],
+                "maxDiff": worst[0] if math.isfinite(worst[0]) else None,
+                "worst": list(worst[1]) if worst[1] else None,
+                "loadUs": load,
+            },
+            "ok": ok,
+        }
+        args.json_out.write_text(json.dumps(report, indent=2) + "\n", encoding="utf-8")
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,299 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "spine-c.h"
+#include "spine_cpp_lite_oracle_core.h"
+
+// Bakes an `.atlas` into the binary atlas index read by `spine2d::AtlasIndex` (layout documented in
+// `spine2d/src/atlas_index.rs`): spine-cpp parses the text once, the pages and regions are written
+// as fixed-size records plus a name -> region hash table, and the tool times text loading against
+// index loading. `spine2d/examples/atlas_index.rs --cpp-index` checks the result against
+// `spine2d::Atlas::parse`.
+
+static void usage() {
+  std::cerr << "Usage:\n"
+               "  spine_cpp_lite_atlas_index <atlas.atlas> <out.atlasidx> [--iterations <n>]\n"
+               "\n"
+               "  --iterations <n>   timed loads per format (default 200, after 10% warmup)\n";
+}
+
+static const uint32_t INDEX_VERSION = 1;
+static const size_t HEADER_SIZE = 32;
+static const size_t PAGE_SIZE = 24;
+static const size_t REGION_SIZE = 52;
+
+static uint32_t fnv1a(const char *s, size_t n) {
+  uint32_t h = 0x811c9dc5u;
+  for (size_t i = 0; i < n; i++) h = (h ^ (uint8_t) s[i]) * 0x01000193u;
+  return h;
+}
+
+static void put_u32(std::string &out, uint32_t v) {
+  for (int i = 0; i < 4; i++) out.push_back((char) (uint8_t) (v >> (8 * i)));
+}
+
+static void set_u32(std::string &out, size_t at, uint32_t v) {
+  for (int i = 0; i < 4; i++) out[at + i] = (char) (uint8_t) (v >> (8 * i));
+}
+
+static uint32_t get_u32(const std::string &in, size_t at) {
+  const unsigned char *p = (const unsigned char *) in.data() + at;
+  return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static uint8_t filter_code(spine_texture_filter f) {
+  switch (f) {
+    case SPINE_TEXTURE_FILTER_NEAREST: return 0;
+    case SPINE_TEXTURE_FILTER_LINEAR: return 1;
+    case SPINE_TEXTURE_FILTER_MIP_MAP: return 2;
+    case SPINE_TEXTURE_FILTER_MIP_MAP_NEAREST_NEAREST: return 3;
+    case SPINE_TEXTURE_FILTER_MIP_MAP_NEAREST_LINEAR: return 4;
+    case SPINE_TEXTURE_FILTER_MIP_MAP_LINEAR_NEAREST: return 5;
+    case SPINE_TEXTURE_FILTER_MIP_MAP_LINEAR_LINEAR: return 6;
+    default: return 255;
+  }
+}
+
+static uint8_t wrap_code(spine_texture_wrap w) {
+  switch (w) {
+    case SPINE_TEXTURE_WRAP_REPEAT: return 1;
+    case SPINE_TEXTURE_WRAP_MIRRORED_REPEAT: return 2;
+    default: return 0;
+  }
+}
+
+struct IndexStats {
+  size_t pages = 0;
+  size_t regions = 0;
+  size_t duplicates = 0;
+};
+
+// Regions are written in spine-cpp order (atlas file order) and inserted into the hash table in
+// that order, so a duplicated name resolves to its first region, like `Atlas::findRegion`.
+static std::string build_index(spine_atlas atlas, IndexStats &stats) {
+  spine_array_atlas_page pages = spine_atlas_get_pages(atlas);
+  spine_atlas_page *page_buf = spine_array_atlas_page_buffer(pages);
+  const size_t page_count = spine_array_atlas_page_size(pages);
+  spine_array_atlas_region regions = spine_atlas_get_regions(atlas);
+  spine_atlas_region *region_buf = spine_array_atlas_region_buffer(regions);
+  const size_t region_count = spine_array_atlas_region_size(regions);
+  size_t bucket_count = 1;
+  while (bucket_count < region_count * 2) bucket_count <<= 1;
+
+  std::string strings;
+  const size_t strings_offset = HEADER_SIZE + page_count * PAGE_SIZE + region_count * REGION_SIZE + bucket_count * 4;
+  std::string out = "SPAI";
+  const uint32_t header[7] = {INDEX_VERSION, (uint32_t) page_count, (uint32_t) region_count, (uint32_t) bucket_count,
+                              (uint32_t) strings_offset, 0, 0};
+  for (int i = 0; i < 7; i++) put_u32(out, header[i]);
+
+  for (size_t i = 0; i < page_count; i++) {
+    spine_atlas_page page = page_buf[i];
+    const char *name = spine_atlas_page_get_name(page);
+    const size_t name_len = name ? std::strlen(name) : 0;
+    put_u32(out, (uint32_t) strings.size());
+    put_u32(out, (uint32_t) name_len);
+    strings.append(name ? name : "", name_len);
+    strings.push_back('\0');
+    const int width = spine_atlas_page_get_width(page);
+    const int height = spine_atlas_page_get_height(page);
+    put_u32(out, (uint32_t) width);
+    put_u32(out, (uint32_t) height);
+    // spine-cpp's AtlasPage does not keep the `scale:` entry; the index records 1.
+    const float scale = 1.0f;
+    uint32_t scale_bits;
+    std::memcpy(&scale_bits, &scale, sizeof scale_bits);
+    put_u32(out, scale_bits);
+    out.push_back((char) (spine_atlas_page_get_pma(page) ? 1 : 0));
+    out.push_back((char) filter_code(spine_atlas_page_get_min_filter(page)));
+    out.push_back((char) filter_code(spine_atlas_page_get_mag_filter(page)));
+    out.push_back((char) (wrap_code(spine_atlas_page_get_u_wrap(page)) | (wrap_code(spine_atlas_page_get_v_wrap(page)) << 2)));
+  }
+
+  std::vector<uint32_t> buckets(bucket_count, 0);
+  for (size_t i = 0; i < region_count; i++) {
+    spine_atlas_region r = region_buf[i];
+    const char *name = spine_atlas_region_get_name(r);
+    const size_t name_len = name ? std::strlen(name) : 0;
+    const uint32_t hash = fnv1a(name ? name : "", name_len);
+    spine_atlas_page page = spine_atlas_region_get_page(r);
+    uint32_t page_index = 0;
+    for (size_t p = 0; p < page_count; p++) {
+      if (page_buf[p] == page) page_index = (uint32_t) p;
+    }
+    put_u32(out, (uint32_t) strings.size());
+    put_u32(out, (uint32_t) name_len);
+    strings.append(name ? name : "", name_len);
+    strings.push_back('\0');
+    put_u32(out, hash);
+    put_u32(out, page_index);
+    const int degrees = spine_atlas_region_get_degrees(r);
+    const int x = spine_atlas_region_get_x(r);
+    const int y = spine_atlas_region_get_y(r);
+    const int width = spine_atlas_region_get_region_width(r);
+    const int height = spine_atlas_region_get_region_height(r);
+    const float offset_x = spine_atlas_region_get_offset_x(r);
+    const float offset_y = spine_atlas_region_get_offset_y(r);
+    const int original_width = spine_atlas_region_get_original_width(r);
+    const int original_height = spine_atlas_region_get_original_height(r);
+    const uint32_t fields[9] = {(uint32_t) degrees, (uint32_t) x, (uint32_t) y, (uint32_t) width, (uint32_t) height,
+                                (uint32_t) (int32_t) offset_x, (uint32_t) (int32_t) offset_y,
+                                (uint32_t) original_width, (uint32_t) original_height};
+    for (int f = 0; f < 9; f++) put_u32(out, fields[f]);
+
+    size_t b = hash & (bucket_count - 1);
+    bool duplicate = false;
+    while (buckets[b] != 0) {
+      const uint32_t other = buckets[b] - 1;
+      const char *other_name = spine_atlas_region_get_name(region_buf[other]);
+      if (other_name && name && std::strcmp(other_name, name) == 0) duplicate = true;
+      b = (b + 1) & (bucket_count - 1);
+    }
+    if (duplicate) stats.duplicates++;
+    buckets[b] = (uint32_t) i + 1;
+  }
+  for (size_t b = 0; b < bucket_count; b++) put_u32(out, buckets[b]);
+
+  set_u32(out, 24, (uint32_t) strings.size());
+  out += strings;
+  stats.pages = page_count;
+  stats.regions = region_count;
+  return out;
+}
+
+// Minimal reader mirroring `spine2d::AtlasIndex`: header validation plus hash lookup.
+struct IndexView {
+  const std::string *bytes = nullptr;
+  size_t pages = 0, regions = 0, buckets = 0, strings = 0, strings_len = 0;
+
+  bool open(const std::string &in) {
+    if (in.size() < HEADER_SIZE || in.compare(0, 4, "SPAI") != 0 || get_u32(in, 4) != INDEX_VERSION) return false;
+    bytes = &in;
+    pages = get_u32(in, 8);
+    regions = get_u32(in, 12);
+    buckets = get_u32(in, 16);
+    strings = get_u32(in, 20);
+    strings_len = get_u32(in, 24);
+    const size_t tables_end = HEADER_SIZE + pages * PAGE_SIZE + regions * REGION_SIZE + buckets * 4;
+    return buckets != 0 && (buckets & (buckets - 1)) == 0 && strings >= tables_end && strings + strings_len <= in.size();
+  }
+
+  size_t region_at(size_t i) const { return HEADER_SIZE + pages * PAGE_SIZE + i * REGION_SIZE; }
+
+  // Region record index of `name`, or -1.
+  long find(const char *name) const {
+    const size_t n = std::strlen(name);
+    const uint32_t hash = fnv1a(name, n);
+    const size_t table = region_at(regions);
+    for (size_t probe = 0, b = hash & (buckets - 1); probe < buckets; probe++, b = (b + 1) & (buckets - 1)) {
+      const uint32_t slot = get_u32(*bytes, table + b * 4);
+      if (slot == 0) return -1;
+      const size_t at = region_at(slot - 1);
+      if (get_u32(*bytes, at + 8) == hash && get_u32(*bytes, at + 4) == n &&
+          bytes->compare(strings + get_u32(*bytes, at), n, name) == 0)
+        return (long) slot - 1;
+    }
+    return -1;
+  }
+};
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    usage();
+    return 2;
+  }
+  const char *atlas_path = argv[1];
+  const char *out_path = argv[2];
+  int iterations = 200;
+  for (int i = 3; i < argc; i++) {
+    if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+      iterations = std::atoi(argv[++i]);
+      if (iterations < 1) {
+        std::cerr << "invalid --iterations: " << argv[i] << "\n";
+        return 2;
+      }
+    } else {
+      usage();
+      return 2;
+    }
+  }
+
+  const std::string atlas_text = read_file(atlas_path);
+  spine_atlas_result atlas_result = nullptr;
+  spine_atlas atlas = load_atlas_or_die(atlas_path, atlas_result);
+  IndexStats stats;
+  const std::string index = build_index(atlas, stats);
+  {
+    std::ofstream out(out_path, std::ios::binary);
+    out.write(index.data(), (std::streamsize) index.size());
+    if (!out) {
+      std::cerr << "Failed to write " << out_path << "\n";
+      return 2;
+    }
+  }
+
+  std::vector<std::string> names;
+  {
+    spine_array_atlas_region regions = spine_atlas_get_regions(atlas);
+    spine_atlas_region *buf = spine_array_atlas_region_buffer(regions);
+    for (size_t i = 0, n = spine_array_atlas_region_size(regions); i < n; i++) {
+      const char *name = spine_atlas_region_get_name(buf[i]);
+      names.push_back(name ? name : "");
+    }
+  }
+
+  // "load" = text parse vs index header validation; "lookup" = resolving every region by name,
+  // which is what attachment loading does right after.
+  const int warmup = iterations / 10;
+  std::vector<int64_t> text_load, text_lookup, index_load, index_lookup;
+  size_t misses = 0;
+  for (int it = -warmup; it < iterations; it++) {
+    const BenchClock::time_point t0 = BenchClock::now();
+    spine_atlas_result result = spine_atlas_load(atlas_text.c_str());
+    spine_atlas loaded = spine_atlas_result_get_atlas(result);
+    const BenchClock::time_point t1 = BenchClock::now();
+    for (size_t i = 0; i < names.size(); i++) {
+      if (!spine_atlas_find_region(loaded, names[i].c_str())) misses++;
+    }
+    const BenchClock::time_point t2 = BenchClock::now();
+    spine_atlas_dispose(loaded);
+    spine_atlas_result_dispose(result);
+
+    const BenchClock::time_point t3 = BenchClock::now();
+    IndexView view;
+    const bool ok = view.open(index);
+    const BenchClock::time_point t4 = BenchClock::now();
+    for (size_t i = 0; i < names.size(); i++) {
+      if (!ok || view.find(names[i].c_str()) < 0) misses++;
+    }
+    const BenchClock::time_point t5 = BenchClock::now();
+    if (it >= 0) {
+      text_load.push_back(elapsed_ns(t0, t1));
+      text_lookup.push_back(elapsed_ns(t1, t2));
+      index_load.push_back(elapsed_ns(t3, t4));
+      index_lookup.push_back(elapsed_ns(t4, t5));
+    }
+  }
+
+  const int64_t text_total = percentile_ns(text_load, 0.5) + percentile_ns(text_lookup, 0.5);
+  const int64_t index_total = percentile_ns(index_load, 0.5) + percentile_ns(index_lookup, 0.5);
+  std::cout << "{\"mode\":\"atlas-index\",\"atlas\":\"" << json_escape(atlas_path) << "\",\"index\":\""
+            << json_escape(out_path) << "\",\"pages\":" << stats.pages << ",\"regions\":" << stats.regions
+            << ",\"duplicates\":" << stats.duplicates << ",\"textBytes\":" << atlas_text.size()
+            << ",\"indexBytes\":" << index.size() << ",\"iterations\":" << iterations
+            << ",\"textLoadP50Ns\":" << percentile_ns(text_load, 0.5)
+            << ",\"textLookupP50Ns\":" << percentile_ns(text_lookup, 0.5)
+            << ",\"indexLoadP50Ns\":" << percentile_ns(index_load, 0.5)
+            << ",\"indexLookupP50Ns\":" << percentile_ns(index_lookup, 0.5)
+            << ",\"speedup\":" << (index_total > 0 ? (double) text_total / (double) index_total : 0.0)
+            << ",\"lookupMisses\":" << misses << "}\n";
+
+  spine_atlas_dispose(atlas);
+  spine_atlas_result_dispose(atlas_result);
+  return misses == 0 ? 0 : 1;
+}
@@ -0,0 +1,1007 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "spine-c.h"
+#include "spine_cpp_lite_oracle_core.h"
+
+// Per-constraint solve cost in spine-cpp, on the loaded asset and (except `--slider`) on synthetic
+// skeletons generated in-process (JSON text loaded through `spine_skeleton_data_load_json`). A
+// constraint is timed by re-running its `Update::update` right after an untimed
+// `updateWorldTransform`, which has already applied it: the cost is that of solving an
+// already-solved pose, not a fresh one. `--emit-dir` writes each synthetic skeleton plus a manifest
+// for the Rust `constraint_bench` example, which times the same files.
+
+static void usage() {
+  std::cerr
+      << "Usage:\n"
+         "  spine_cpp_lite_constraint_bench <atlas.atlas> <skeleton.(json|skel)> <mode> [options]\n"
+         "\n"
+         "Modes:\n"
+         "  --path                        path constraints: the asset's (modes as printed by\n"
+         "                                spine_cpp_lite_dump_constraints), then synthetic variants over\n"
+         "                                position x spacing x rotate mode, constrained bones and path points\n"
+         "  --ik                          IK constraints: the asset's, then one/two-bone micro-skeletons over\n"
+         "                                mix x softness x bend x compress x stretch x uniform, each solved\n"
+         "                                against randomized targets; emitted skeletons carry spine-cpp's\n"
+         "                                poses at every target for the Rust side to check\n"
+         "  --transform-fanout            transform constraints: the asset's, then one constraint driving\n"
+         "                                --bones siblings (default 1,10,100,1000) under each localSource x\n"
+         "                                localTarget x additive x clamp combination; exits 1 when the\n"
+         "                                per-bone cost grows superlinearly\n"
+         "  --slider                      slider constraints of the asset: each is swept over its animation's\n"
+         "                                duration through its driving bone property (or its time), timed\n"
+         "                                against applying the same animation on a track, and its pose\n"
+         "                                compared with the track's at the time it reached; exits 1 when a\n"
+         "                                full-mix replace slider differs by more than --tolerance\n"
+         "\n"
+         "Options:\n"
+         "  --iterations <n>              timed frames per constraint (default 200, after 10% warmup)\n"
+         "  --bones <n0,n1,...>           constrained bones per synthetic variant (default 1,4,16,64)\n"
+         "  --linearity-limit <x>         fan-out: largest accepted per-bone cost ratio between the two\n"
+         "                                largest sizes (default 1.5)\n"
+         "  --points <n0,n1,...>          path points per synthetic path (default 2,8,32)\n"
+         "  --all-modes                   every mode combination, not just those used by the asset\n"
+         "  --targets <n>                 IK targets per constraint, cycled while timing (default 16)\n"
+         "  --seed <n>                    IK target seed (default 1)\n"
+         "  --sweep-points <n>            slider: points across the animation's duration (default 32)\n"
+         "  --tolerance <x>               slider: largest accepted world transform difference against the\n"
+         "                                track (default 1e-3)\n"
+         "  --emit-dir <dir>              write each synthetic skeleton as JSON plus <dir>/manifest.json\n";
+}
+
+static bool parse_counts(const char *s, std::vector<int> &out) {
+  out.clear();
+  std::stringstream ss(s);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    const int v = std::atoi(item.c_str());
+    if (v < 1) return false;
+    out.push_back(v);
+  }
+  return !out.empty();
+}
+
+// One synthetic skeleton, loaded against the asset's atlas (synthetic skeletons have no region
+// attachments, so the atlas is never consulted).
+struct Synthetic {
+  spine_skeleton_data_result result = nullptr;
+  spine_skeleton_drawable drawable = nullptr;
+  spine_skeleton skeleton = nullptr;
+};
+
+static bool load_synthetic(spine_atlas atlas, const std::string &json, const char *name, Synthetic &out) {
+  out.result = spine_skeleton_data_load_json(atlas, json.c_str(), name);
+  const char *err = out.result ? spine_skeleton_data_result_get_error(out.result) : "load failed";
+  spine_skeleton_data data = out.result ? spine_skeleton_data_result_get_data(out.result) : nullptr;
+  if ((err && err[0]) || !data) {
+    std::cerr << "synthetic skeleton " << name << ": " << (err && err[0] ? err : "missing data") << "\n";
+    return false;
+  }
+  out.drawable = spine_skeleton_drawable_create(data);
+  if (!out.drawable) {
+    std::cerr << "spine_skeleton_drawable_create failed\n";
+    return false;
+  }
+  out.skeleton = spine_skeleton_drawable_get_skeleton(out.drawable);
+  spine_skeleton_setup_pose(out.skeleton);
+  spine_skeleton_update_world_transform(out.skeleton, SPINE_PHYSICS_NONE);
+  return true;
+}
+
+static void dispose_synthetic(Synthetic &s) {
+  if (s.drawable) spine_skeleton_drawable_dispose(s.drawable);
+  if (s.result) spine_skeleton_data_result_dispose(s.result);
+  s = Synthetic();
+}
+
+// The named constraint's update cache entry, or null if it is not in the cache (inactive).
+static spine_update find_constraint_update(spine_skeleton skeleton, const char *name) {
+  spine_array_constraint constraints = spine_skeleton_get_constraints(skeleton);
+  const size_t nc = spine_array_constraint_size(constraints);
+  spine_constraint *buf = spine_array_constraint_buffer(constraints);
+  spine_update found = nullptr;
+  for (size_t i = 0; i < nc && !found; i++) {
+    spine_constraint_data cd = spine_constraint_get_data(buf[i]);
+    const char *n = cd ? spine_constraint_data_get_name(cd) : nullptr;
+    if (n && std::strcmp(n, name) == 0) found = spine_constraint_cast_to_update(buf[i]);
+  }
+  if (!found) return nullptr;
+  spine_array_update cache = spine_skeleton_get_update_cache(skeleton);
+  const size_t nuc = spine_array_update_size(cache);
+  spine_update *cache_buf = spine_array_update_buffer(cache);
+  for (size_t i = 0; i < nuc; i++) {
+    if (cache_buf[i] == found) return found;
+  }
+  return nullptr;
+}
+
+struct SolveTiming {
+  int64_t solve_p50 = 0;  // the constraint's update alone, on the pose it already solved
+  int64_t world_p50 = 0;  // the whole updateWorldTransform it was re-run after
+};
+
+// Poses the skeleton's inputs for frame `frame` (counting warmup frames) before it is timed.
+typedef void (*FrameHook)(void *context, int frame);
+
+static SolveTiming time_constraint(spine_skeleton skeleton, spine_update update, int iterations,
+                                   FrameHook before_frame = nullptr, void *context = nullptr) {
+  const int warmup = iterations / 10 + 1;
+  std::vector<int64_t> solve, world;
+  solve.reserve((size_t)iterations);
+  world.reserve((size_t)iterations);
+  for (int it = -warmup; it < iterations; it++) {
+    if (before_frame) before_frame(context, it + warmup);
+    const BenchClock::time_point t0 = BenchClock::now();
+    spine_skeleton_update_world_transform(skeleton, SPINE_PHYSICS_NONE);
+    const BenchClock::time_point t1 = BenchClock::now();
+    spine_update_update(update, skeleton, SPINE_PHYSICS_NONE);
+    const BenchClock::time_point t2 = BenchClock::now();
+    if (it < 0) continue;
+    world.push_back(elapsed_ns(t0, t1));
+    solve.push_back(elapsed_ns(t1, t2));
+  }
+  SolveTiming t;
+  t.solve_p50 = percentile_ns(solve, 0.5);
+  t.world_p50 = percentile_ns(world, 0.5);
+  return t;
+}
+
+// Shared JSON header for synthetic skeletons: `root` plus a chain `b0..b{n-1}` of 20-unit bones
+// along +x.
+static void write_bone_chain(std::ostringstream &js, int bones) {
+  js << "{\"skeleton\":{\"spine\":\"4.3.00\"},\"bones\":[{\"name\":\"root\"}";
+  for (int i = 0; i < bones; i++) {
+    js << ",{\"name\":\"b" << i << "\",\"parent\":\"" << (i ? "b" + std::to_string(i - 1) : std::string("root"))
+       << "\",\"x\":" << (i ? 20 : 0) << ",\"length\":20}";
+  }
+  js << "]";
+}
+
+static const char *const kPositionModes[] = {"fixed", "percent"};
+static const char *const kSpacingModes[] = {"length", "fixed", "percent", "proportional"};
+static const char *const kRotateModes[] = {"tangent", "chain", "chainScale"};
+
+template <size_t N> static const char *mode_name(const char *const (&names)[N], int mode) {
+  assert(mode >= 0 && (size_t)mode < N);
+  return names[mode];
+}
+
+struct PathModes {
+  int position, spacing, rotate;
+  const char *position_name() const { return mode_name(kPositionModes, position); }
+  const char *spacing_name() const { return mode_name(kSpacingModes, spacing); }
+  const char *rotate_name() const { return mode_name(kRotateModes, rotate); }
+};
+
+// Open, constant-speed path of `points` points along a sine wave over 1.25x the chain length, and a
+// path constraint over the whole chain. Position/spacing values keep every bone on the path.
+static std::string path_skeleton_json(const PathModes &m, int bones, int points) {
+  std::ostringstream js;
+  js << std::setprecision(std::numeric_limits<float>::max_digits10);
+  write_bone_chain(js, bones);
+  const float length = 20.0f * (float)bones * 1.25f;
+  const int curves = points > 1 ? points - 1 : 1;
+  const float step = length / (float)curves;
+  js << ",\"slots\":[{\"name\":\"path\",\"bone\":\"root\",\"attachment\":\"path\"}]"
+     << ",\"skins\":[{\"name\":\"default\",\"attachments\":{\"path\":{\"path\":{\"type\":\"path\",\"closed\":false,"
+        "\"constantSpeed\":true,\"vertexCount\":"
+     << points * 3 << ",\"vertices\":[";
+  for (int i = 0; i < points; i++) {
+    const float x = step * (float)i;
+    const float y = 30.0f * std::sin(0.9f * (float)i);
+    if (i) js << ",";
+    js << x - step / 3.0f << "," << y << "," << x << "," << y << "," << x + step / 3.0f << "," << y;
+  }
+  js << "],\"lengths\":[";
+  for (int i = 0; i < points; i++) js << (i ? "," : "") << step * (float)(i + 1);
+  js << "]}}}}]";
+
+  const bool percent_position = m.position == 1;
+  float spacing = 0.0f;
+  if (m.spacing == 1) spacing = 20.0f;
+  else if (m.spacing == 2) spacing = 0.8f / (float)bones;
+  else if (m.spacing == 3) spacing = 0.8f;
+  js << ",\"constraints\":[{\"type\":\"path\",\"name\":\"pc\",\"bones\":[";
+  for (int i = 0; i < bones; i++) js << (i ? "," : "") << "\"b" << i << "\"";
+  js << "],\"target\":\"path\",\"positionMode\":\"" << m.position_name() << "\",\"spacingMode\":\""
+     << m.spacing_name() << "\",\"rotateMode\":\"" << m.rotate_name()
+     << "\",\"position\":" << (percent_position ? 0.1f : 10.0f) << ",\"spacing\":" << spacing
+     << ",\"mixRotate\":1,\"mixX\":1,\"mixY\":1}],\"animations\":{}}";
+  return js.str();
+}
+
+struct Options {
+  int iterations = 200;
+  std::vector<int> bones;
+  std::vector<int> points;
+  bool all_modes = false;
+  int targets = 16;
+  uint32_t seed = 1;
+  double linearity_limit = 1.5;
+  int sweep_points = 32;
+  double tolerance = 1e-3;
+  const char *emit_dir = nullptr;
+};
+
+// `--emit-dir` bookkeeping: the manifest lists every synthetic file with its spine-cpp timings.
+struct Emitter {
+  const char *dir = nullptr;
+  std::ostringstream manifest;
+  int files = 0;
+
+  bool write(const std::string &name, const std::string &json) {
+    if (!dir) return true;
+    std::ofstream out((std::string(dir) + "/" + name).c_str(), std::ios::binary);
+    out << json;
+    return (bool)out;
+  }
+
+  void add(const std::string &entry) {
+    if (files++) manifest << ",";
+    manifest << entry;
+  }
+};
+
+static int run_path(spine_atlas atlas, spine_skeleton_data data, const Options &opt, Emitter &emit) {
+  spine_skeleton_drawable drawable = spine_skeleton_drawable_create(data);
+  if (!drawable) {
+    std::cerr << "spine_skeleton_drawable_create failed\n";
+    return 2;
+  }
+  spine_skeleton skeleton = spine_skeleton_drawable_get_skeleton(drawable);
+  spine_skeleton_setup_pose(skeleton);
+  spine_skeleton_update_world_transform(skeleton, SPINE_PHYSICS_NONE);
+
+  std::vector<PathModes> modes;
+  std::cout << "{\"mode\":\"path-cost\",\"iterations\":" << opt.iterations << ",\"asset\":[";
+  spine_array_constraint_data cds = spine_skeleton_data_get_constraints(data);
+  const size_t ncd = spine_array_constraint_data_size(cds);
+  spine_constraint_data *cd_buf = spine_array_constraint_data_buffer(cds);
+  bool first = true;
+  for (size_t i = 0; i < ncd; i++) {
+    if (!spine_rtti_instance_of(spine_constraint_data_get_rtti(cd_buf[i]), spine_path_constraint_data_rtti())) continue;
+    spine_path_constraint_data pcd = spine_constraint_data_cast_to_path_constraint_data(cd_buf[i]);
+    const char *name = spine_constraint_data_get_name(cd_buf[i]);
+    // spine-cpp's binary loader decodes percent as 2 (`(flags >> 1) & 2`); fold it to `kPositionModes`.
+    const spine_position_mode position = spine_path_constraint_data_get_position_mode(pcd);
+    const PathModes m = {position != SPINE_POSITION_MODE_FIXED ? 1 : 0,
+                         (int)spine_path_constraint_data_get_spacing_mode(pcd),
+                         (int)spine_path_constraint_data_get_rotate_mode(pcd)};
+    bool seen = false;
+    for (size_t k = 0; k < modes.size(); k++) {
+      seen = seen || (modes[k].position == m.position && modes[k].spacing == m.spacing && modes[k].rotate == m.rotate);
+    }
+    if (!seen) modes.push_back(m);
+
+    spine_array_bone_data bones = spine_path_constraint_data_get_bones(pcd);
+    const size_t nbones = spine_array_bone_data_size(bones);
+    spine_slot_data target = spine_path_constraint_data_get_slot(pcd);
+    spine_slot slot = target ? spine_skeleton_find_slot(skeleton, spine_slot_data_get_name(target)) : nullptr;
+    spine_attachment att = slot ? spine_slot_pose_get_attachment(spine_slot_get_applied_pose(slot)) : nullptr;
+    const bool is_path = att && spine_rtti_instance_of(spine_attachment_get_rtti(att), spine_path_attachment_rtti());
+    size_t path_vertices = 0;
+    if (is_path) {
+      path_vertices = spine_vertex_attachment_get_world_vertices_length(spine_attachment_cast_to_vertex_attachment(att));
+      path_vertices /= 2;
+    }
+
+    if (!first) std::cout << ",";
+    first = false;
+    std::cout << "{\"name\":\"" << json_escape(name) << "\",\"positionMode\":\"" << m.position_name()
+              << "\",\"spacingMode\":\"" << m.spacing_name() << "\",\"rotateMode\":\"" << m.rotate_name()
+              << "\",\"bones\":" << nbones << ",\"pathVertices\":" << path_vertices;
+    if (is_path) {
+      spine_path_attachment pa = spine_attachment_cast_to_path_attachment(att);
+      std::cout << ",\"closed\":" << (spine_path_attachment_get_closed(pa) ? "true" : "false")
+                << ",\"constantSpeed\":" << (spine_path_attachment_get_constant_speed(pa) ? "true" : "false");
+    }
+    const spine_update u = find_constraint_update(skeleton, name);
+    if (!u || !is_path) {
+      std::cout << ",\"active\":false}";
+      continue;
+    }
+    const SolveTiming t = time_constraint(skeleton, u, opt.iterations);
+    std::cout << ",\"active\":true,\"solveP50Ns\":" << t.solve_p50
+              << ",\"perBoneNs\":" << (nbones ? (double)t.solve_p50 / (double)nbones : 0.0)
+              << ",\"worldP50Ns\":" << t.world_p50 << "}";
+  }
+  spine_skeleton_drawable_dispose(drawable);
+
+  if (opt.all_modes || modes.empty()) {
+    modes.clear();
+    for (int p = 0; p < 2; p++) {
+      for (int s = 0; s < 4; s++) {
+        for (int r = 0; r < 3; r++) {
+          const PathModes m = {p, s, r};
+          modes.push_back(m);
+        }
+      }
+    }
+  }
+
+  std::cout << "],\"synthetic\":[";
+  first = true;
+  for (size_t mi = 0; mi < modes.size(); mi++) {
+    const PathModes &m = modes[mi];
+    for (size_t bi = 0; bi < opt.bones.size(); bi++) {
+      for (size_t pi = 0; pi < opt.points.size(); pi++) {
+        const int nbones = opt.bones[bi];
+        const int npoints = opt.points[pi];
+        const std::string file = std::string("path-") + m.position_name() + "-" + m.spacing_name() + "-" +
+                                 m.rotate_name() + "-b" + std::to_string(nbones) + "-p" + std::to_string(npoints) +
+                                 ".json";
+        const std::string json = path_skeleton_json(m, nbones, npoints);
+        Synthetic s;
+        if (!load_synthetic(atlas, json, file.c_str(), s)) return 2;
+        const spine_update u = find_constraint_update(s.skeleton, "pc");
+        if (!u) {
+          std::cerr << file << ": path constraint not in the update cache\n";
+          dispose_synthetic(s);
+          return 2;
+        }
+        const SolveTiming t = time_constraint(s.skeleton, u, opt.iterations);
+        dispose_synthetic(s);
+        if (!emit.write(file, json)) {
+          std::cerr << "failed to write " << emit.dir << "/" << file << "\n";
+          return 2;
+        }
+
+        std::ostringstream row;
+        row << "{\"file\":\"" << file << "\",\"positionMode\":\"" << m.position_name()
+            << "\",\"spacingMode\":\"" << m.spacing_name() << "\",\"rotateMode\":\"" << m.rotate_name()
+            << "\",\"bones\":" << nbones << ",\"pathPoints\":" << npoints << ",\"solveP50Ns\":" << t.solve_p50
+            << ",\"perBoneNs\":" << (double)t.solve_p50 / (double)nbones << ",\"worldP50Ns\":" << t.world_p50 << "}";
+        if (!first) std::cout << ",";
+        first = false;
+        std::cout << row.str();
+        emit.add(row.str());
+      }
+    }
+  }
+  std::cout << "]}\n";
+  return 0;
+}
+
+// An IK constraint's setup flags plus its chain length (1 or 2 bones).
+struct IkVariant {
+  int bones;
+  float mix, softness;
+  int bend;
+  bool compress, stretch, uniform;
+};
+
+static bool same_ik_variant(const IkVariant &a, const IkVariant &b) {
+  return a.bones == b.bones && a.mix == b.mix && a.softness == b.softness && a.bend == b.bend &&
+         a.compress == b.compress && a.stretch == b.stretch && a.uniform == b.uniform;
+}
+
+static void write_ik_fields(std::ostream &out, const IkVariant &v) {
+  out << "\"bones\":" << v.bones << ",\"mix\":" << v.mix << ",\"softness\":" << v.softness << ",\"bend\":" << v.bend
+      << ",\"compress\":" << (v.compress ? "true" : "false") << ",\"stretch\":" << (v.stretch ? "true" : "false")
+      << ",\"uniform\":" << (v.uniform ? "true" : "false");
+}
+
+// `p` (and `c` for two-bone variants): 50-unit bones from the origin along +x; `t`: the target,
+// under root.
+static std::string ik_skeleton_json(const IkVariant &v) {
+  std::ostringstream js;
+  js << std::setprecision(std::numeric_limits<float>::max_digits10);
+  js << "{\"skeleton\":{\"spine\":\"4.3.00\"},\"bones\":[{\"name\":\"root\"},"
+        "{\"name\":\"p\",\"parent\":\"root\",\"length\":50}";
+  if (v.bones == 2) js << ",{\"name\":\"c\",\"parent\":\"p\",\"x\":50,\"length\":50}";
+  js << ",{\"name\":\"t\",\"parent\":\"root\",\"x\":60,\"y\":30}],\"constraints\":[{\"type\":\"ik\",\"name\":\"ik\",\"bones\":[\"p\""
+     << (v.bones == 2 ? ",\"c\"" : "") << "],\"target\":\"t\",\"mix\":" << v.mix << ",\"softness\":" << v.softness
+     << ",\"bendPositive\":" << (v.bend > 0 ? "true" : "false") << ",\"compress\":" << (v.compress ? "true" : "false")
+     << ",\"stretch\":" << (v.stretch ? "true" : "false") << ",\"uniform\":" << (v.uniform ? "true" : "false")
+     << "}],\"animations\":{}}";
+  return js.str();
+}
+
+static float next_unit(uint32_t &state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return (float)(state >> 8) / 16777216.0f;
+}
+
+// `count` deterministic targets uniform over a disk of `radius` around (cx, cy). With the radius at
+// 1.5x the chain length, targets past the chain's reach exercise stretch and those near its root
+// exercise compress and softness.
+static std::vector<float> random_targets(uint32_t seed, int count, float cx, float cy, float radius) {
+  uint32_t state = seed ? seed : 1;
+  std::vector<float> xy;
+  xy.reserve((size_t)count * 2);
+  for (int i = 0; i < count; i++) {
+    const float r = radius * std::sqrt(next_unit(state));
+    const float angle = next_unit(state) * 6.28318531f;
+    xy.push_back(cx + r * std::cos(angle));
+    xy.push_back(cy + r * std::sin(angle));
+  }
+  return xy;
+}
+
+// `time_constraint` frame hook: moves the target bone (local pose) to the next of `xy`.
+struct TargetCycle {
+  spine_bone_local target;
+  const std::vector<float> *xy;
+};
+
+static void set_cycled_target(void *context, int frame) {
+  const TargetCycle &c = *(const TargetCycle *)context;
+  const size_t i = (size_t)frame % (c.xy->size() / 2);
+  spine_bone_local_set_x(c.target, (*c.xy)[i * 2]);
+  spine_bone_local_set_y(c.target, (*c.xy)[i * 2 + 1]);
+}
+
+static void write_world(std::ostream &out, spine_bone bone) {
+  spine_bone_pose pose = spine_bone_get_applied_pose(bone);
+  out << "[" << spine_bone_pose_get_a(pose) << "," << spine_bone_pose_get_b(pose) << "," << spine_bone_pose_get_c(pose)
+      << "," << spine_bone_pose_get_d(pose) << "," << spine_bone_pose_get_world_x(pose) << ","
+      << spine_bone_pose_get_world_y(pose) << "]";
+}
+
+static int run_ik(spine_atlas atlas, spine_skeleton_data data, const Options &opt, Emitter &emit) {
+  spine_skeleton_drawable drawable = spine_skeleton_drawable_create(data);
+  if (!drawable) {
+    std::cerr << "spine_skeleton_drawable_create failed\n";
+    return 2;
+  }
+  spine_skeleton skeleton = spine_skeleton_drawable_get_skeleton(drawable);
+  spine_skeleton_setup_pose(skeleton);
+  spine_skeleton_update_world_transform(skeleton, SPINE_PHYSICS_NONE);
+
+  std::vector<IkVariant> variants;
+  std::cout << "{\"mode\":\"ik-cost\",\"iterations\":" << opt.iterations << ",\"targets\":" << opt.targets
+            << ",\"seed\":" << opt.seed << ",\"asset\":[";
+  spine_array_constraint_data cds = spine_skeleton_data_get_constraints(data);
+  const size_t ncd = spine_array_constraint_data_size(cds);
+  spine_constraint_data *cd_buf = spine_array_constraint_data_buffer(cds);
+  bool first = true;
+  for (size_t i = 0; i < ncd; i++) {
+    if (!spine_rtti_instance_of(spine_constraint_data_get_rtti(cd_buf[i]), spine_ik_constraint_data_rtti())) continue;
+    spine_ik_constraint_data ik = spine_constraint_data_cast_to_ik_constraint_data(cd_buf[i]);
+    spine_ik_constraint_pose setup = spine_ik_constraint_data_get_setup_pose(ik);
+    const char *name = spine_constraint_data_get_name(cd_buf[i]);
+    spine_array_bone_data bones = spine_ik_constraint_data_get_bones(ik);
+    IkVariant v;
+    v.bones = (int)spine_array_bone_data_size(bones);
+    v.mix = spine_ik_constraint_pose_get_mix(setup);
+    v.softness = spine_ik_constraint_pose_get_softness(setup);
+    v.bend = spine_ik_constraint_pose_get_bend_direction(setup);
+    v.compress = spine_ik_constraint_pose_get_compress(setup);
+    v.stretch = spine_ik_constraint_pose_get_stretch(setup);
+    v.uniform = spine_ik_constraint_data_get_uniform(ik);
+    bool seen = false;
+    for (size_t k = 0; k < variants.size(); k++) seen = seen || same_ik_variant(variants[k], v);
+    if (!seen && (v.bones == 1 || v.bones == 2)) variants.push_back(v);
+
+    if (!first) std::cout << ",";
+    first = false;
+    std::cout << "{\"name\":\"" << json_escape(name) << "\",";
+    write_ik_fields(std::cout, v);
+    const spine_update u = find_constraint_update(skeleton, name);
+    spine_bone_data target_data = spine_ik_constraint_data_get_target(ik);
+    spine_bone target = target_data ? spine_skeleton_find_bone(skeleton, spine_bone_data_get_name(target_data)) : nullptr;
+    if (!u || !target) {
+      std::cout << ",\"active\":false}";
+      continue;
+    }
+    spine_bone_data *bone_buf = spine_array_bone_data_buffer(bones);
+    float reach = 0.0f;
+    for (int b = 0; b < v.bones; b++) {
+      const float length = spine_bone_data_get_length(bone_buf[b]);
+      reach += length;
+    }
+    spine_bone_local target_pose = spine_bone_get_pose(target);
+    const std::vector<float> xy =
+        random_targets(opt.seed, opt.targets, spine_bone_local_get_x(target_pose), spine_bone_local_get_y(target_pose),
+                       reach > 0.0f ? reach * 1.5f : 100.0f);
+    TargetCycle cycle = {target_pose, &xy};
+    const SolveTiming t = time_constraint(skeleton, u, opt.iterations, set_cycled_target, &cycle);
+    spine_skeleton_setup_pose(skeleton);
+    std::cout << ",\"active\":true,\"solveP50Ns\":" << t.solve_p50 << ",\"worldP50Ns\":" << t.world_p50 << "}";
+  }
+  spine_skeleton_drawable_dispose(drawable);
+
+  if (opt.all_modes || variants.empty()) {
+    variants.clear();
+    for (int bones = 1; bones <= 2; bones++) {
+      for (int flags = 0; flags < 32; flags++) {
+        IkVariant v = {bones,
+                       (flags & 1) ? 0.5f : 1.0f,
+                       (flags & 2) ? 20.0f : 0.0f,
+                       (flags & 4) ? -1 : 1,
+                       (flags & 8) != 0,
+                       (flags & 16) != 0,
+                       false};
+        // Softness and bend direction only affect two-bone chains.
+        if (bones == 1 && (v.softness != 0.0f || v.bend != 1)) continue;
+        variants.push_back(v);
+        v.uniform = true;
+        variants.push_back(v);
+      }
+    }
+  }
+
+  std::cout << "],\"synthetic\":[";
+  for (size_t vi = 0; vi < variants.size(); vi++) {
+    const IkVariant &v = variants[vi];
+    std::ostringstream file;
+    file << "ik-" << vi << "-b" << v.bones << ".json";
+    const std::string json = ik_skeleton_json(v);
+    Synthetic s;
+    if (!load_synthetic(atlas, json, file.str().c_str(), s)) return 2;
+    const spine_update u = find_constraint_update(s.skeleton, "ik");
+    spine_bone target = spine_skeleton_find_bone(s.skeleton, "t");
+    if (!u || !target) {
+      std::cerr << file.str() << ": IK constraint not in the update cache\n";
+      dispose_synthetic(s);
+      return 2;
+    }
+    const std::vector<float> xy = random_targets(opt.seed, opt.targets, 0.0f, 0.0f, 75.0f * (float)v.bones);
+    TargetCycle cycle = {spine_bone_get_pose(target), &xy};
+    const SolveTiming t = time_constraint(s.skeleton, u, opt.iterations, set_cycled_target, &cycle);
+
+    // Reference poses for the Rust side: the full updateWorldTransform at each target.
+    std::ostringstream checks;
+    checks << std::setprecision(std::numeric_limits<float>::max_digits10) << ",\"checks\":[";
+    for (int k = 0; k < opt.targets; k++) {
+      set_cycled_target(&cycle, k);
+      spine_skeleton_update_world_transform(s.skeleton, SPINE_PHYSICS_NONE);
+      checks << (k ? "," : "") << "{\"target\":[" << xy[(size_t)k * 2] << "," << xy[(size_t)k * 2 + 1]
+             << "],\"bones\":[";
+      write_world(checks, spine_skeleton_find_bone(s.skeleton, "p"));
+      if (v.bones == 2) {
+        checks << ",";
+        write_world(checks, spine_skeleton_find_bone(s.skeleton, "c"));
+      }
+      checks << "]}";
+    }
+    checks << "]";
+    dispose_synthetic(s);
+    if (!emit.write(file.str(), json)) {
+      std::cerr << "failed to write " << emit.dir << "/" << file.str() << "\n";
+      return 2;
+    }
+
+    std::ostringstream row;
+    row << std::setprecision(std::numeric_limits<float>::max_digits10) << "{\"file\":\"" << file.str() << "\",";
+    write_ik_fields(row, v);
+    row << ",\"solveP50Ns\":" << t.solve_p50 << ",\"worldP50Ns\":" << t.world_p50;
+    std::cout << (vi ? "," : "") << row.str() << "}";
+    emit.add(row.str() + checks.str() + "}");
+  }
+  std::cout << "]}\n";
+  return 0;
+}
+
+static const char *const kTransformFlags[] = {"localSource", "localTarget", "additive", "clamp"};
+
+static void write_transform_flags(std::ostream &out, int flags) {
+  for (int f = 0; f < 4; f++) {
+    out << (f ? "," : "") << "\"" << kTransformFlags[f] << "\":" << ((flags >> f) & 1 ? "true" : "false");
+  }
+}
+
+// One transform constraint from source `s` onto `bones` siblings `b0..` under root, mapping rotate,
+// x, y, scaleX and shearY onto themselves with a `max` the source exceeds, so `clamp` has work.
+static std::string transform_skeleton_json(int flags, int bones) {
+  std::ostringstream js;
+  js << "{\"skeleton\":{\"spine\":\"4.3.00\"},\"bones\":[{\"name\":\"root\"},"
+        "{\"name\":\"s\",\"parent\":\"root\",\"x\":10,\"y\":20,\"rotation\":30,\"scaleX\":1.5,\"shearY\":15}";
+  for (int i = 0; i < bones; i++) {
+    js << ",{\"name\":\"b" << i << "\",\"parent\":\"root\",\"x\":" << i % 50 << ",\"y\":" << i / 50
+       << ",\"rotation\":" << (i % 7) * 5 << "}";
+  }
+  js << "],\"constraints\":[{\"type\":\"transform\",\"name\":\"tc\",\"bones\":[";
+  for (int i = 0; i < bones; i++) js << (i ? "," : "") << "\"b" << i << "\"";
+  js << "],\"source\":\"s\",";
+  write_transform_flags(js, flags);
+  js << ",\"properties\":{";
+  const char *const props[] = {"rotate", "x", "y", "scaleX", "shearY"};
+  for (int p = 0; p < 5; p++) {
+    js << (p ? "," : "") << "\"" << props[p] << "\":{\"to\":{\"" << props[p] << "\":{\"max\":"
+       << (p == 3 ? "1.25" : "10") << "}}}";
+  }
+  js << "},\"mixRotate\":1,\"mixX\":1,\"mixY\":1,\"mixScaleX\":1,\"mixShearY\":1}],\"animations\":{}}";
+  return js.str();
+}
+
+static int run_transform_fanout(spine_atlas atlas, spine_skeleton_data data, const Options &opt, Emitter &emit) {
+  spine_skeleton_drawable drawable = spine_skeleton_drawable_create(data);
+  if (!drawable) {
+    std::cerr << "spine_skeleton_drawable_create failed\n";
+    return 2;
+  }
+  spine_skeleton skeleton = spine_skeleton_drawable_get_skeleton(drawable);
+  spine_skeleton_setup_pose(skeleton);
+  spine_skeleton_update_world_transform(skeleton, SPINE_PHYSICS_NONE);
+
+  std::cout << "{\"mode\":\"transform-fanout\",\"iterations\":" << opt.iterations
+            << ",\"linearityLimit\":" << opt.linearity_limit << ",\"asset\":[";
+  spine_array_constraint_data cds = spine_skeleton_data_get_constraints(data);
+  const size_t ncd = spine_array_constraint_data_size(cds);
+  spine_constraint_data *cd_buf = spine_array_constraint_data_buffer(cds);
+  bool first = true;
+  for (size_t i = 0; i < ncd; i++) {
+    if (!spine_rtti_instance_of(spine_constraint_data_get_rtti(cd_buf[i]), spine_transform_constraint_data_rtti()))
+      continue;
+    spine_transform_constraint_data tr = spine_constraint_data_cast_to_transform_constraint_data(cd_buf[i]);
+    const char *name = spine_constraint_data_get_name(cd_buf[i]);
+    const size_t nbones = spine_array_bone_data_size(spine_transform_constraint_data_get_bones(tr));
+    const int flags = (spine_transform_constraint_data_get_local_source(tr) ? 1 : 0) |
+                      (spine_transform_constraint_data_get_local_target(tr) ? 2 : 0) |
+                      (spine_transform_constraint_data_get_additive(tr) ? 4 : 0) |
+                      (spine_transform_constraint_data_get_clamp(tr) ? 8 : 0);
+    if (!first) std::cout << ",";
+    first = false;
+    std::cout << "{\"name\":\"" << json_escape(name) << "\",\"bones\":" << nbones << ",";
+    write_transform_flags(std::cout, flags);
+    const spine_update u = find_constraint_update(skeleton, name);
+    if (!u) {
+      std::cout << ",\"active\":false}";
+      continue;
+    }
+    const SolveTiming t = time_constraint(skeleton, u, opt.iterations);
+    std::cout << ",\"active\":true,\"solveP50Ns\":" << t.solve_p50
+              << ",\"perBoneNs\":" << (nbones ? (double)t.solve_p50 / (double)nbones : 0.0)
+              << ",\"worldP50Ns\":" << t.world_p50 << "}";
+  }
+  spine_skeleton_drawable_dispose(drawable);
+
+  // Per flag combination, per-bone cost at the largest fan-out over that at the next largest: a
+  // fixed overhead spread over more bones keeps it <= 1, a superlinear path pushes it past the limit.
+  int nonlinear = 0;
+  std::vector<int> counts = opt.bones;
+  std::sort(counts.begin(), counts.end());
+  counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+  std::cout << "],\"synthetic\":[";
+  for (int flags = 0; flags < 16; flags++) {
+    std::vector<double> per_bone;
+    std::cout << (flags ? "," : "") << "{";
+    write_transform_flags(std::cout, flags);
+    std::cout << ",\"sizes\":[";
+    for (size_t ci = 0; ci < counts.size(); ci++) {
+      const int nbones = counts[ci];
+      const std::string file = "transform-" + std::to_string(flags) + "-b" + std::to_string(nbones) + ".json";
+      const std::string json = transform_skeleton_json(flags, nbones);
+      Synthetic s;
+      if (!load_synthetic(atlas, json, file.c_str(), s)) return 2;
+      const spine_update u = find_constraint_update(s.skeleton, "tc");
+      if (!u) {
+        std::cerr << file << ": transform constraint not in the update cache\n";
+        dispose_synthetic(s);
+        return 2;
+      }
+      const SolveTiming t = time_constraint(s.skeleton, u, opt.iterations);
+      dispose_synthetic(s);
+      if (!emit.write(file, json)) {
+        std::cerr << "failed to write " << emit.dir << "/" << file << "\n";
+        return 2;
+      }
+      per_bone.push_back((double)t.solve_p50 / (double)nbones);
+
+      std::ostringstream row;
+      row << "{\"file\":\"" << file << "\",";
+      write_transform_flags(row, flags);
+      row << ",\"bones\":" << nbones << ",\"solveP50Ns\":" << t.solve_p50 << ",\"perBoneNs\":" << per_bone.back()
+          << ",\"worldP50Ns\":" << t.world_p50 << "}";
+      std::cout << (ci ? "," : "") << row.str();
+      emit.add(row.str());
+    }
+    const size_t n = per_bone.size();
+    const double growth = n > 1 && per_bone[n - 2] > 0.0 ? per_bone[n - 1] / per_bone[n - 2] : 1.0;
+    const bool linear = growth <= opt.linearity_limit;
+    if (!linear) {
+      nonlinear++;
+      std::cerr << "transform fan-out flags " << flags << ": per-bone cost grew " << growth << "x from "
+                << counts[n - 2] << " to " << counts[n - 1] << " bones\n";
+    }
+    std::cout << "],\"growth\":" << growth << ",\"linear\":" << (linear ? "true" : "false") << "}";
+  }
+  std::cout << "],\"nonlinear\":" << nonlinear << "}\n";
+  return nonlinear ? 1 : 0;
+}
+
+static const char *const kBoneProperties[] = {"rotate", "x", "y", "scaleX", "scaleY", "shearY"};
+
+// Index into `kBoneProperties` of a `FromRotate`..`FromShearY` property, or -1.
+static int from_property_kind(spine_from_property property) {
+  static const char *const classes[] = {"FromRotate", "FromX", "FromY", "FromScaleX", "FromScaleY", "FromShearY"};
+  const char *name = spine_rtti_get_class_name(spine_from_property_get_rtti(property));
+  for (int i = 0; name && i < 6; i++) {
+    if (std::strcmp(name, classes[i]) == 0) return i;
+  }
+  return -1;
+}
+
+// Drives a slider to `times[frame % size]`: through its bone's local property, inverting
+// `time = offset + (value - property offset) * scale`, or through the slider pose's time when it
+// has no bone. Non-local sliders read the world value, so the time actually reached can differ.
+struct SliderDriver {
+  spine_slider_pose pose;
+  spine_bone_local bone;
+  int kind;
+  float from_offset, offset, scale;
+  const std::vector<float> *times;
+};
+
+static void drive_slider(void *context, int frame) {
+  const SliderDriver &d = *(const SliderDriver *)context;
+  const float t = (*d.times)[(size_t)frame % d.times->size()];
+  if (!d.bone) {
+    spine_slider_pose_set_time(d.pose, t);
+    return;
+  }
+  const float v = d.from_offset + (d.scale != 0.0f ? (t - d.offset) / d.scale : 0.0f);
+  switch (d.kind) {
+    case 0: spine_bone_local_set_rotation(d.bone, v); break;
+    case 1: spine_bone_local_set_x(d.bone, v); break;
+    case 2: spine_bone_local_set_y(d.bone, v); break;
+    case 3: spine_bone_local_set_scale_x(d.bone, v); break;
+    case 4: spine_bone_local_set_scale_y(d.bone, v); break;
+    case 5: spine_bone_local_set_shear_y(d.bone, v); break;
+    default: break;
+  }
+}
+
+static void capture_world(spine_skeleton skeleton, std::vector<float> &out) {
+  out.clear();
+  spine_array_bone bones = spine_skeleton_get_bones(skeleton);
+  spine_bone *buf = spine_array_bone_buffer(bones);
+  for (size_t i = 0, n = spine_array_bone_size(bones); i < n; i++) {
+    spine_bone_pose pose = spine_bone_get_applied_pose(buf[i]);
+    const float v[6] = {spine_bone_pose_get_a(pose), spine_bone_pose_get_b(pose), spine_bone_pose_get_c(pose),
+                        spine_bone_pose_get_d(pose), spine_bone_pose_get_world_x(pose),
+                        spine_bone_pose_get_world_y(pose)};
+    out.insert(out.end(), v, v + 6);
+  }
+}
+
+static int run_slider(spine_skeleton_data data, const Options &opt) {
+  spine_skeleton_drawable drawable = spine_skeleton_drawable_create(data);
+  if (!drawable) {
+    std::cerr << "spine_skeleton_drawable_create failed\n";
+    return 2;
+  }
+  spine_skeleton skeleton = spine_skeleton_drawable_get_skeleton(drawable);
+  spine_animation_state state = spine_skeleton_drawable_get_animation_state(drawable);
+
+  std::cout << "{\"mode\":\"slider-cost\",\"iterations\":" << opt.iterations << ",\"sweepPoints\":" << opt.sweep_points
+            << ",\"tolerance\":" << opt.tolerance << ",\"sliders\":[";
+  spine_array_constraint constraints = spine_skeleton_get_constraints(skeleton);
+  const size_t nc = spine_array_constraint_size(constraints);
+  spine_constraint *buf = spine_array_constraint_buffer(constraints);
+  bool first = true;
+  int mismatched = 0;
+  for (size_t i = 0; i < nc; i++) {
+    if (!spine_rtti_instance_of(spine_constraint_get_rtti(buf[i]), spine_slider_rtti())) continue;
+    spine_slider slider = spine_constraint_cast_to_slider(buf[i]);
+    spine_slider_data sd = spine_constraint_data_cast_to_slider_data(spine_constraint_get_data(buf[i]));
+    const char *name = spine_constraint_data_get_name(spine_constraint_get_data(buf[i]));
+    spine_animation anim = spine_slider_data_get_animation(sd);
+    spine_bone_data bone_data = spine_slider_data_get_bone(sd);
+    spine_from_property property = spine_slider_data_get_property(sd);
+    const float mix = spine_slider_pose_get_mix(spine_slider_data_get_setup_pose(sd));
+    const bool additive = spine_slider_data_get_additive(sd);
+    const bool loop = spine_slider_data_get_loop(sd);
+    const int kind = property ? from_property_kind(property) : -1;
+
+    if (!first) std::cout << ",";
+    first = false;
+    std::cout << "{\"name\":\"" << json_escape(name) << "\",\"animation\":\""
+              << json_escape(anim ? spine_animation_get_name(anim) : "") << "\"";
+    if (anim) {
+      std::cout << ",\"timelines\":" << spine_array_timeline_size(spine_animation_get_timelines(anim))
+                << ",\"duration\":" << spine_animation_get_duration(anim);
+    }
+    std::cout << ",\"bone\":\"" << json_escape(bone_data ? spine_bone_data_get_name(bone_data) : "")
+              << "\",\"property\":\"" << (kind >= 0 ? kBoneProperties[kind] : "") << "\",\"scale\":"
+              << spine_slider_data_get_scale(sd) << ",\"offset\":" << spine_slider_data_get_offset(sd)
+              << ",\"local\":" << (spine_slider_data_get_local(sd) ? "true" : "false") << ",\"additive\":"
+              << (additive ? "true" : "false") << ",\"loop\":" << (loop ? "true" : "false") << ",\"mix\":" << mix;
+
+    spine_skeleton_setup_pose(skeleton);
+    spine_skeleton_update_world_transform(skeleton, SPINE_PHYSICS_NONE);
+    const spine_update u = find_constraint_update(skeleton, name);
+    spine_bone bone = bone_data ? spine_skeleton_find_bone(skeleton, spine_bone_data_get_name(bone_data)) : nullptr;
+    if (!u || !anim || (bone_data && (!bone || kind < 0))) {
+      std::cout << ",\"active\":false}";
+      continue;
+    }
+
+    const float duration = spine_animation_get_duration(anim);
+    std::vector<float> times;
+    for (int k = 0; k < opt.sweep_points; k++) {
+      times.push_back(opt.sweep_points > 1 ? duration * (float)k / (float)(opt.sweep_points - 1) : 0.0f);
+    }
+    SliderDriver driver = {spine_slider_get_pose(slider), bone ? spine_bone_get_pose(bone) : nullptr, kind,
+                           property ? spine_from_property_get_offset(property) : 0.0f,
+                           spine_slider_data_get_offset(sd), spine_slider_data_get_scale(sd), &times};
+    const SolveTiming t = time_constraint(skeleton, u, opt.iterations, drive_slider, &driver);
+
+    // The same animation as a plain track: track time set to each sweep time, then
+    // `AnimationState::apply` from setup pose.
+    spine_track_entry entry = spine_animation_state_set_animation_1(state, 0, spine_animation_get_name(anim), loop);
+    spine_animation_state_update(state, 0.0f);
+    const int warmup = opt.iterations / 10 + 1;
+    std::vector<int64_t> apply;
+    apply.reserve((size_t)opt.iterations);
+    for (int it = -warmup; it < opt.iterations; it++) {
+      spine_track_entry_set_track_time(entry, times[(size_t)(it + warmup) % times.size()]);
+      spine_skeleton_setup_pose(skeleton);
+      const BenchClock::time_point t0 = BenchClock::now();
+      spine_animation_state_apply(state, skeleton);
+      const BenchClock::time_point t1 = BenchClock::now();
+      if (it >= 0) apply.push_back(elapsed_ns(t0, t1));
+    }
+    const int64_t apply_p50 = percentile_ns(apply, 0.5);
+
+    // Correctness: at each sweep point, the slider's pose against the track applying its animation
+    // at the time the slider reached (slider mix 0). Only a full-mix replace slider must match.
+    float min_time = std::numeric_limits<float>::max(), max_time = -std::numeric_limits<float>::max();
+    float max_diff = 0.0f;
+    std::vector<float> by_slider, by_track;
+    for (int k = 0; k < opt.sweep_points; k++) {
+      spine_animation_state_clear_track(state, 0);
+      spine_skeleton_setup_pose(skeleton);
+      drive_slider(&driver, k);
+      spine_skeleton_update_world_transform(skeleton, SPINE_PHYSICS_NONE);
+      const float reached = spine_slider_pose_get_time(spine_slider_get_applied_pose(slider));
+      min_time = std::min(min_time, reached);
+      max_time = std::max(max_time, reached);
+      capture_world(skeleton, by_slider);
+
+      entry = spine_animation_state_set_animation_1(state, 0, spine_animation_get_name(anim), loop);
+      spine_animation_state_update(state, 0.0f);
+      spine_track_entry_set_track_time(entry, reached);
+      spine_skeleton_setup_pose(skeleton);
+      drive_slider(&driver, k);
+      spine_slider_pose_set_mix(spine_slider_get_pose(slider), 0.0f);
+      spine_animation_state_apply(state, skeleton);
+      spine_skeleton_update_world_transform(skeleton, SPINE_PHYSICS_NONE);
+      capture_world(skeleton, by_track);
+      for (size_t j = 0; j < by_slider.size() && j < by_track.size(); j++) {
+        max_diff = std::max(max_diff, std::fabs(by_slider[j] - by_track[j]));
+      }
+    }
+    spine_animation_state_clear_tracks(state);
+    spine_skeleton_setup_pose(skeleton);
+    const bool comparable = mix == 1.0f && !additive;
+    if (comparable && max_diff > opt.tolerance) {
+      mismatched++;
+      std::cerr << "slider " << name << ": pose differs from the track by " << max_diff << " (tolerance "
+                << opt.tolerance << ")\n";
+    }
+
+    std::cout << ",\"active\":true,\"sweep\":{\"minTime\":" << min_time << ",\"maxTime\":" << max_time
+              << "},\"sliderP50Ns\":" << t.solve_p50 << ",\"trackApplyP50Ns\":" << apply_p50
+              << ",\"costVsTrack\":" << (apply_p50 ? (double)t.solve_p50 / (double)apply_p50 : 0.0)
+              << ",\"worldP50Ns\":" << t.world_p50
+              << ",\"comparable\":" << (comparable ? "true" : "false")
+              << ",\"poseDiffVsTrack\":" << max_diff << "}";
+  }
+  std::cout << "],\"mismatched\":" << mismatched << "}\n";
+  spine_skeleton_drawable_dispose(drawable);
+  return mismatched ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 4) {
+    usage();
+    return 2;
+  }
+
+  std::cout << std::setprecision(std::numeric_limits<float>::max_digits10);
+
+  const char *atlas_path = argv[1];
+  const char *skeleton_path = argv[2];
+
+  const char *mode = nullptr;
+  Options opt;
+  opt.bones = {1, 4, 16, 64};
+  opt.points = {2, 8, 32};
+  bool bones_given = false;
+  for (int i = 3; i < argc; i++) {
+    const char *arg = argv[i];
+    if (std::strcmp(arg, "--path") == 0 || std::strcmp(arg, "--ik") == 0 ||
+        std::strcmp(arg, "--transform-fanout") == 0 || std::strcmp(arg, "--slider") == 0) {
+      mode = arg;
+    } else if (std::strcmp(arg, "--iterations") == 0 && i + 1 < argc) {
+      opt.iterations = std::atoi(argv[++i]);
+      if (opt.iterations < 1) {
+        std::cerr << "invalid --iterations: " << argv[i] << "\n";
+        return 2;
+      }
+    } else if (std::strcmp(arg, "--bones") == 0 && i + 1 < argc) {
+      bones_given = true;
+      if (!parse_counts(argv[++i], opt.bones)) {
+        std::cerr << "invalid --bones: " << argv[i] << "\n";
+        return 2;
+      }
+    } else if (std::strcmp(arg, "--points") == 0 && i + 1 < argc) {
+      if (!parse_counts(argv[++i], opt.points)) {
+        std::cerr << "invalid --points: " << argv[i] << "\n";
+        return 2;
+      }
+    } else if (std::strcmp(arg, "--all-modes") == 0) {
+      opt.all_modes = true;
+    } else if (std::strcmp(arg, "--targets") == 0 && i + 1 < argc) {
+      opt.targets = std::atoi(argv[++i]);
+      if (opt.targets < 1) {
+        std::cerr << "invalid --targets: " << argv[i] << "\n";
+        return 2;
+      }
+    } else if (std::strcmp(arg, "--linearity-limit") == 0 && i + 1 < argc) {
+      opt.linearity_limit = std::atof(argv[++i]);
+      if (!(opt.linearity_limit > 0.0)) {
+        std::cerr << "invalid --linearity-limit: " << argv[i] << "\n";
+        return 2;
+      }
+    } else if (std::strcmp(arg, "--sweep-points") == 0 && i + 1 < argc) {
+      opt.sweep_points = std::atoi(argv[++i]);
+      if (opt.sweep_points < 1) {
+        std::cerr << "invalid --sweep-points: " << argv[i] << "\n";
+        return 2;
+      }
+    } else if (std::strcmp(arg, "--tolerance") == 0 && i + 1 < argc) {
+      opt.tolerance = std::atof(argv[++i]);
+      if (!(opt.tolerance >= 0.0)) {
+        std::cerr << "invalid --tolerance: " << argv[i] << "\n";
+        return 2;
+      }
+    } else if (std::strcmp(arg, "--seed") == 0 && i + 1 < argc) {
+      opt.seed = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+    } else if (std::strcmp(arg, "--emit-dir") == 0 && i + 1 < argc) {
+      opt.emit_dir = argv[++i];
+    } else {
+      std::cerr << "unknown arg: " << arg << "\n";
+      usage();
+      return 2;
+    }
+  }
+  if (!mode) {
+    usage();
+    return 2;
+  }
+  if (!bones_given && std::strcmp(mode, "--transform-fanout") == 0) opt.bones = {1, 10, 100, 1000};
+
+  spine_atlas_result atlas_result = nullptr;
+  spine_atlas atlas = load_atlas_or_die(atlas_path, atlas_result);
+  spine_skeleton_data_result data_result = nullptr;
+  spine_skeleton_data data = load_skeleton_data_or_die(atlas, skeleton_path, data_result);
+
+  Emitter emit;
+  emit.dir = opt.emit_dir;
+  int rc;
+  if (std::strcmp(mode, "--ik") == 0) rc = run_ik(atlas, data, opt, emit);
+  else if (std::strcmp(mode, "--transform-fanout") == 0) rc = run_transform_fanout(atlas, data, opt, emit);
+  else if (std::strcmp(mode, "--slider") == 0) rc = run_slider(data, opt);
+  else rc = run_path(atlas, data, opt, emit);
+
+  if (rc != 2 && opt.emit_dir && emit.files) {
+    const std::string path = std::string(opt.emit_dir) + "/manifest.json";
+    std::ofstream out(path.c_str(), std::ios::binary);
+    out << "{\"mode\":\"" << (mode + 2) << "\",\"variants\":[" << emit.manifest.str() << "]}\n";
+    if (!out) {
+      std::cerr << "failed to write " << path << "\n";
+      return 2;
+    }
+  }
+
+  spine_skeleton_data_result_dispose(data_result);
+  spine_atlas_dispose(atlas);
+  spine_atlas_result_dispose(atlas_result);
+  return rc;
+}
@@ -1,32 +1,553 @@
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <iostream>
-#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "spine-c.h"
+#include "spine_cpp_lite_oracle_core.h"
 
-static std::string read_file(const char *path) {
-  std::ifstream file(path, std::ios::binary);
-  if (!file) {
-    std::cerr << "failed to open: " << path << "\n";
-    std::exit(2);
+static void usage() {
+  std::cerr << "Usage:\n"
+               "  spine_cpp_lite_dump_constraints <atlas.atlas> <skeleton.(json|skel)> [--y-down 0|1] [--dump-animation <name>]\n"
+               "                                 [--model-out <model.bin>]\n";
+}
+
+// Canonical model dump (`--model-out`): a flat record stream that spine2d's `model_dump` example
+// writes from the Rust loaders, so `scripts/compare_model_dump.py` can diff the two field by field.
+//
+//   "SPMD" u32 version, then per record:
+//   u16 key length, key bytes, u8 tag ('f' f32[] / 'i' i32[] / 's' strings), u32 count, payload
+//
+// Little-endian; strings are u32 length + bytes. Records come in canonical order (bones/slots/
+// constraints by index, skins/events/animations by name, attachments by slot then key, timelines by
+// "<class>/<target>") so neither loader's container order leaks into the dump.
+static const uint32_t MODEL_DUMP_VERSION = 1;
+
+// spine-cpp CurveTimeline: curves[frame] is LINEAR (0), STEPPED (1) or BEZIER (2) + offset of the
+// frame's first channel's 9 sampled (x, y) pairs; channels follow consecutively.
+static const size_t BEZIER_SIZE = 18;
+
+struct ModelDump {
+  std::string out;
+
+  void u8(uint8_t v) { out.push_back((char) v); }
+  void u16(uint16_t v) {
+    u8((uint8_t) v);
+    u8((uint8_t) (v >> 8));
+  }
+  void u32(uint32_t v) {
+    for (int i = 0; i < 4; i++) u8((uint8_t) (v >> (8 * i)));
   }
-  std::ostringstream ss;
-  ss << file.rdbuf();
-  return ss.str();
+  void record(const std::string &key, char tag, size_t count) {
+    u16((uint16_t) key.size());
+    out += key;
+    u8((uint8_t) tag);
+    u32((uint32_t) count);
+  }
+  void floats(const std::string &key, const std::vector<float> &v) {
+    record(key, 'f', v.size());
+    for (float f : v) {
+      uint32_t bits;
+      std::memcpy(&bits, &f, sizeof bits);
+      u32(bits);
+    }
+  }
+  void ints(const std::string &key, const std::vector<int> &v) {
+    record(key, 'i', v.size());
+    for (int i : v) u32((uint32_t) i);
+  }
+  void strings(const std::string &key, const std::vector<std::string> &v) {
+    record(key, 's', v.size());
+    for (const std::string &s : v) {
+      u32((uint32_t) s.size());
+      out += s;
+    }
+  }
+};
+
+static std::string str(const char *s) { return s ? s : ""; }
+
+static std::vector<std::string> opt_string(const char *s) {
+  return s ? std::vector<std::string>{s} : std::vector<std::string>{};
 }
 
-static bool ends_with(const std::string &s, const char *suffix) {
-  const size_t n = std::strlen(suffix);
-  if (s.size() < n) return false;
-  return s.compare(s.size() - n, n, suffix) == 0;
+static std::vector<float> float_array(spine_array_float a) {
+  const float *buf = spine_array_float_buffer(a);
+  const size_t n = spine_array_float_size(a);
+  return std::vector<float>(buf, buf + n);
 }
 
-static void usage() {
-  std::cerr << "Usage:\n"
-               "  spine_cpp_lite_dump_constraints <atlas.atlas> <skeleton.(json|skel)> [--y-down 0|1] [--dump-animation <name>]\n";
+static std::vector<int> int_array(spine_array_int a) {
+  const int *buf = spine_array_int_buffer(a);
+  const size_t n = spine_array_int_size(a);
+  return std::vector<int>(buf, buf + n);
+}
+
+static std::vector<float> color4(spine_color c) {
+  return {spine_color_get_r(c), spine_color_get_g(c), spine_color_get_b(c), spine_color_get_a(c)};
+}
+
+static std::vector<int> bone_indices(spine_array_bone_data bones) {
+  std::vector<int> out;
+  spine_bone_data *buf = spine_array_bone_data_buffer(bones);
+  for (size_t i = 0, n = spine_array_bone_data_size(bones); i < n; i++) out.push_back(spine_bone_data_get_index(buf[i]));
+  return out;
+}
+
+static int bone_index(spine_bone_data bone) { return bone ? spine_bone_data_get_index(bone) : -1; }
+
+static int constraint_index(spine_array_constraint_data constraints, spine_constraint_data c) {
+  spine_constraint_data *buf = spine_array_constraint_data_buffer(constraints);
+  for (size_t i = 0, n = spine_array_constraint_data_size(constraints); i < n; i++) {
+    if (buf[i] == c) return (int) i;
+  }
+  return -1;
+}
+
+// Rotate, X, Y, ScaleX, ScaleY, ShearY: spine2d's `TransformProperty` / the .skel property kinds.
+static int property_kind(spine_rtti rt) {
+  static const char *const names[] = {"Rotate", "X", "Y", "ScaleX", "ScaleY", "ShearY"};
+  std::string name = str(spine_rtti_get_class_name(rt));
+  if (name.rfind("From", 0) == 0) name = name.substr(4);
+  else if (name.rfind("To", 0) == 0) name = name.substr(2);
+  for (int i = 0; i < 6; i++) {
+    if (name == names[i]) return i;
+  }
+  return -1;
+}
+
+static std::vector<int> sequence_fields(spine_sequence seq) {
+  return {(int) spine_array_texture_region_size(spine_sequence_get_regions(seq)), spine_sequence_get_start(seq),
+          spine_sequence_get_digits(seq), spine_sequence_get_setup_index(seq)};
+}
+
+static void dump_vertex_fields(ModelDump &dump, const std::string &prefix, spine_vertex_attachment va) {
+  dump.ints(prefix + "bones", int_array(spine_vertex_attachment_get_bones(va)));
+  dump.floats(prefix + "vertices", float_array(spine_vertex_attachment_get_vertices(va)));
+  dump.ints(prefix + "worldVerticesLength", {(int) spine_vertex_attachment_get_world_vertices_length(va)});
+}
+
+static void dump_attachment(ModelDump &dump, const std::string &prefix, spine_attachment a) {
+  const spine_rtti rt = spine_attachment_get_rtti(a);
+  const std::string name = str(spine_attachment_get_name(a));
+  if (spine_rtti_instance_of(rt, spine_region_attachment_rtti())) {
+    spine_region_attachment r = spine_attachment_cast_to_region_attachment(a);
+    dump.strings(prefix + "type", {"region"});
+    dump.strings(prefix + "name", {name});
+    dump.strings(prefix + "path", {str(spine_region_attachment_get_path(r))});
+    dump.floats(prefix + "color", color4(spine_region_attachment_get_color(r)));
+    dump.floats(prefix + "setup",
+                {spine_region_attachment_get_x(r), spine_region_attachment_get_y(r), spine_region_attachment_get_rotation(r),
+                 spine_region_attachment_get_scale_x(r), spine_region_attachment_get_scale_y(r),
+                 spine_region_attachment_get_width(r), spine_region_attachment_get_height(r)});
+    if (spine_sequence seq = spine_region_attachment_get_sequence(r)) dump.ints(prefix + "sequence", sequence_fields(seq));
+  } else if (spine_rtti_instance_of(rt, spine_mesh_attachment_rtti())) {
+    spine_mesh_attachment m = spine_attachment_cast_to_mesh_attachment(a);
+    dump.strings(prefix + "type", {"mesh"});
+    dump.strings(prefix + "name", {name});
+    dump.strings(prefix + "path", {str(spine_mesh_attachment_get_path(m))});
+    dump.floats(prefix + "color", color4(spine_mesh_attachment_get_color(m)));
+    dump_vertex_fields(dump, prefix, spine_attachment_cast_to_vertex_attachment(a));
+    dump.floats(prefix + "uvs", float_array(spine_mesh_attachment_get_region_uvs(m)));
+    spine_array_unsigned_short triangles = spine_mesh_attachment_get_triangles(m);
+    const unsigned short *tbuf = spine_array_unsigned_short_buffer(triangles);
+    const size_t triangle_count = spine_array_unsigned_short_size(triangles);
+    dump.ints(prefix + "triangles", std::vector<int>(tbuf, tbuf + triangle_count));
+    spine_attachment timeline = spine_mesh_attachment_get_timeline_attachment(m);
+    dump.strings(prefix + "timelineAttachment", {timeline ? str(spine_attachment_get_name(timeline)) : name});
+    if (spine_sequence seq = spine_mesh_attachment_get_sequence(m)) dump.ints(prefix + "sequence", sequence_fields(seq));
+  } else if (spine_rtti_instance_of(rt, spine_path_attachment_rtti())) {
+    spine_path_attachment p = spine_attachment_cast_to_path_attachment(a);
+    dump.strings(prefix + "type", {"path"});
+    dump.strings(prefix + "name", {name});
+    dump_vertex_fields(dump, prefix, spine_attachment_cast_to_vertex_attachment(a));
+    dump.floats(prefix + "lengths", float_array(spine_path_attachment_get_lengths(p)));
+    dump.ints(prefix + "flags",
+              {spine_path_attachment_get_closed(p) ? 1 : 0, spine_path_attachment_get_constant_speed(p) ? 1 : 0});
+  } else if (spine_rtti_instance_of(rt, spine_bounding_box_attachment_rtti())) {
+    dump.strings(prefix + "type", {"boundingbox"});
+    dump.strings(prefix + "name", {name});
+    dump_vertex_fields(dump, prefix, spine_attachment_cast_to_vertex_attachment(a));
+  } else if (spine_rtti_instance_of(rt, spine_clipping_attachment_rtti())) {
+    spine_clipping_attachment c = spine_attachment_cast_to_clipping_attachment(a);
+    dump.strings(prefix + "type", {"clipping"});
+    dump.strings(prefix + "name", {name});
+    dump_vertex_fields(dump, prefix, spine_attachment_cast_to_vertex_attachment(a));
+    spine_slot_data end = spine_clipping_attachment_get_end_slot(c);
+    dump.ints(prefix + "endSlot", {end ? spine_slot_data_get_index(end) : -1});
+  } else if (spine_rtti_instance_of(rt, spine_point_attachment_rtti())) {
+    spine_point_attachment p = spine_attachment_cast_to_point_attachment(a);
+    dump.strings(prefix + "type", {"point"});
+    dump.strings(prefix + "name", {name});
+    dump.floats(prefix + "setup",
+                {spine_point_attachment_get_x(p), spine_point_attachment_get_y(p), spine_point_attachment_get_rotation(p)});
+  } else {
+    dump.strings(prefix + "type", {str(spine_rtti_get_class_name(rt))});
+    dump.strings(prefix + "name", {name});
+  }
+}
+
+static void dump_constraint(ModelDump &dump, const std::string &prefix, spine_constraint_data c) {
+  const spine_rtti rt = spine_constraint_data_get_rtti(c);
+  const int skin = spine_constraint_data_get_skin_required(c) ? 1 : 0;
+  dump.strings(prefix + "name", {str(spine_constraint_data_get_name(c))});
+  if (spine_rtti_instance_of(rt, spine_ik_constraint_data_rtti())) {
+    spine_ik_constraint_data ik = spine_constraint_data_cast_to_ik_constraint_data(c);
+    spine_ik_constraint_pose setup = spine_ik_constraint_data_get_setup_pose(ik);
+    dump.strings(prefix + "kind", {"ik"});
+    dump.ints(prefix + "bones", bone_indices(spine_ik_constraint_data_get_bones(ik)));
+    dump.ints(prefix + "flags", {bone_index(spine_ik_constraint_data_get_target(ik)),
+                                 spine_ik_constraint_pose_get_bend_direction(setup),
+                                 spine_ik_constraint_pose_get_compress(setup) ? 1 : 0,
+                                 spine_ik_constraint_pose_get_stretch(setup) ? 1 : 0,
+                                 spine_ik_constraint_data_get_uniform(ik) ? 1 : 0, skin});
+    dump.floats(prefix + "setup", {spine_ik_constraint_pose_get_mix(setup), spine_ik_constraint_pose_get_softness(setup)});
+  } else if (spine_rtti_instance_of(rt, spine_transform_constraint_data_rtti())) {
+    spine_transform_constraint_data tr = spine_constraint_data_cast_to_transform_constraint_data(c);
+    spine_transform_constraint_pose setup = spine_transform_constraint_data_get_setup_pose(tr);
+    dump.strings(prefix + "kind", {"transform"});
+    dump.ints(prefix + "bones", bone_indices(spine_transform_constraint_data_get_bones(tr)));
+    dump.ints(prefix + "flags", {bone_index(spine_transform_constraint_data_get_source(tr)),
+                                 spine_transform_constraint_data_get_local_source(tr) ? 1 : 0,
+                                 spine_transform_constraint_data_get_local_target(tr) ? 1 : 0,
+                                 spine_transform_constraint_data_get_additive(tr) ? 1 : 0,
+                                 spine_transform_constraint_data_get_clamp(tr) ? 1 : 0, skin});
+    dump.floats(prefix + "setup",
+                {spine_transform_constraint_pose_get_mix_rotate(setup), spine_transform_constraint_pose_get_mix_x(setup),
+                 spine_transform_constraint_pose_get_mix_y(setup), spine_transform_constraint_pose_get_mix_scale_x(setup),
+                 spine_transform_constraint_pose_get_mix_scale_y(setup),
+                 spine_transform_constraint_pose_get_mix_shear_y(setup)});
+    dump.floats(prefix + "offsets",
+                {spine_transform_constraint_data_get_offset_rotation(tr), spine_transform_constraint_data_get_offset_x(tr),
+                 spine_transform_constraint_data_get_offset_y(tr), spine_transform_constraint_data_get_offset_scale_x(tr),
+                 spine_transform_constraint_data_get_offset_scale_y(tr),
+                 spine_transform_constraint_data_get_offset_shear_y(tr)});
+    // Per source property: kind, offset, target count, then kind, offset, max, scale per target.
+    std::vector<float> properties;
+    spine_array_from_property froms = spine_transform_constraint_data_get_properties(tr);
+    spine_from_property *fbuf = spine_array_from_property_buffer(froms);
+    for (size_t i = 0, n = spine_array_from_property_size(froms); i < n; i++) {
+      spine_array_to_property tos = spine_from_property_get_to(fbuf[i]);
+      spine_to_property *tbuf = spine_array_to_property_buffer(tos);
+      const size_t tn = spine_array_to_property_size(tos);
+      const float from_offset = spine_from_property_get_offset(fbuf[i]);
+      properties.insert(properties.end(), {(float) property_kind(spine_from_property_get_rtti(fbuf[i])), from_offset,
+                                           (float) tn});
+      for (size_t j = 0; j < tn; j++) {
+        const float to_offset = spine_to_property_get_offset(tbuf[j]);
+        const float to_max = spine_to_property_get_max(tbuf[j]);
+        const float to_scale = spine_to_property_get_scale(tbuf[j]);
+        properties.insert(properties.end(),
+                          {(float) property_kind(spine_to_property_get_rtti(tbuf[j])), to_offset, to_max, to_scale});
+      }
+    }
+    dump.floats(prefix + "properties", properties);
+  } else if (spine_rtti_instance_of(rt, spine_path_constraint_data_rtti())) {
+    spine_path_constraint_data pc = spine_constraint_data_cast_to_path_constraint_data(c);
+    spine_path_constraint_pose setup = spine_path_constraint_data_get_setup_pose(pc);
+    spine_slot_data target = spine_path_constraint_data_get_slot(pc);
+    // The binary loader decodes percent as 2 (`(flags >> 1) & 2`); dump 0 fixed / 1 percent as spine2d does.
+    const spine_position_mode position = spine_path_constraint_data_get_position_mode(pc);
+    dump.strings(prefix + "kind", {"path"});
+    dump.ints(prefix + "bones", bone_indices(spine_path_constraint_data_get_bones(pc)));
+    dump.ints(prefix + "flags", {target ? spine_slot_data_get_index(target) : -1,
+                                 position != SPINE_POSITION_MODE_FIXED ? 1 : 0,
+                                 (int) spine_path_constraint_data_get_spacing_mode(pc),
+                                 (int) spine_path_constraint_data_get_rotate_mode(pc), skin});
+    dump.floats(prefix + "setup",
+                {spine_path_constraint_data_get_offset_rotation(pc), spine_path_constraint_pose_get_position(setup),
+                 spine_path_constraint_pose_get_spacing(setup), spine_path_constraint_pose_get_mix_rotate(setup),
+                 spine_path_constraint_pose_get_mix_x(setup), spine_path_constraint_pose_get_mix_y(setup)});
+  } else if (spine_rtti_instance_of(rt, spine_physics_constraint_data_rtti())) {
+    spine_physics_constraint_data ph = spine_constraint_data_cast_to_physics_constraint_data(c);
+    spine_physics_constraint_pose setup = spine_physics_constraint_data_get_setup_pose(ph);
+    dump.strings(prefix + "kind", {"physics"});
+    dump.ints(prefix + "flags", {bone_index(spine_physics_constraint_data_get_bone(ph)), skin,
+                                 spine_physics_constraint_data_get_inertia_global(ph) ? 1 : 0,
+                                 spine_physics_constraint_data_get_strength_global(ph) ? 1 : 0,
+                                 spine_physics_constraint_data_get_damping_global(ph) ? 1 : 0,
+                                 spine_physics_constraint_data_get_mass_global(ph) ? 1 : 0,
+                                 spine_physics_constraint_data_get_wind_global(ph) ? 1 : 0,
+                                 spine_physics_constraint_data_get_gravity_global(ph) ? 1 : 0,
+                                 spine_physics_constraint_data_get_mix_global(ph) ? 1 : 0});
+    dump.floats(prefix + "setup",
+                {spine_physics_constraint_data_get_x(ph), spine_physics_constraint_data_get_y(ph),
+                 spine_physics_constraint_data_get_rotate(ph), spine_physics_constraint_data_get_scale_x(ph),
+                 spine_physics_constraint_data_get_shear_x(ph), spine_physics_constraint_data_get_limit(ph),
+                 spine_physics_constraint_data_get_step(ph), spine_physics_constraint_pose_get_inertia(setup),
+                 spine_physics_constraint_pose_get_strength(setup), spine_physics_constraint_pose_get_damping(setup),
+                 spine_physics_constraint_pose_get_mass_inverse(setup), spine_physics_constraint_pose_get_wind(setup),
+                 spine_physics_constraint_pose_get_gravity(setup), spine_physics_constraint_pose_get_mix(setup)});
+  } else if (spine_rtti_instance_of(rt, spine_slider_data_rtti())) {
+    spine_slider_data sd = spine_constraint_data_cast_to_slider_data(c);
+    spine_slider_pose setup = spine_slider_data_get_setup_pose(sd);
+    spine_animation anim = spine_slider_data_get_animation(sd);
+    spine_from_property property = spine_slider_data_get_property(sd);
+    dump.strings(prefix + "kind", {"slider"});
+    dump.strings(prefix + "animation", opt_string(anim ? spine_animation_get_name(anim) : nullptr));
+    dump.ints(prefix + "flags", {bone_index(spine_slider_data_get_bone(sd)),
+                                 property ? property_kind(spine_from_property_get_rtti(property)) : -1,
+                                 spine_slider_data_get_loop(sd) ? 1 : 0, spine_slider_data_get_additive(sd) ? 1 : 0,
+                                 spine_slider_data_get_local(sd) ? 1 : 0, skin});
+    const float property_from = property ? spine_from_property_get_offset(property) : 0.0f;
+    dump.floats(prefix + "setup", {spine_slider_pose_get_time(setup), spine_slider_pose_get_mix(setup), property_from,
+                                   spine_slider_data_get_offset(sd), spine_slider_data_get_scale(sd)});
+  } else {
+    dump.strings(prefix + "kind", {str(spine_rtti_get_class_name(rt))});
+  }
+}
+
+static std::string indexed(const char *prefix, int index) { return prefix + std::to_string(index); }
+
+static std::string slot_attachment_target(int slot, spine_attachment a) {
+  return indexed("slot", slot) + "/" + (a ? str(spine_attachment_get_name(a)) : "");
+}
+
+template <typename T>
+static bool by_name(const std::pair<std::string, T> &a, const std::pair<std::string, T> &b) {
+  return a.first < b.first;
+}
+
+// "<target>" half of a timeline key: bone<i>, slot<i>[/<attachment>], constraint<i> (-1 = all
+// physics constraints) or "all" for draw order/event timelines.
+static std::string timeline_target(spine_timeline t, spine_rtti rt) {
+  if (spine_rtti_instance_of(rt, spine_bone_timeline1_rtti()))
+    return indexed("bone", spine_bone_timeline1_get_bone_index(spine_timeline_cast_to_bone_timeline1(t)));
+  if (spine_rtti_instance_of(rt, spine_bone_timeline2_rtti()))
+    return indexed("bone", spine_bone_timeline2_get_bone_index(spine_timeline_cast_to_bone_timeline2(t)));
+  if (spine_rtti_instance_of(rt, spine_inherit_timeline_rtti()))
+    return indexed("bone", spine_inherit_timeline_get_bone_index(spine_timeline_cast_to_inherit_timeline(t)));
+  if (spine_rtti_instance_of(rt, spine_deform_timeline_rtti())) {
+    spine_deform_timeline dt = spine_timeline_cast_to_deform_timeline(t);
+    spine_vertex_attachment va = spine_deform_timeline_get_attachment(dt);
+    return slot_attachment_target(spine_slot_timeline_get_slot_index(spine_deform_timeline_cast_to_slot_timeline(dt)),
+                                  va ? spine_vertex_attachment_cast_to_attachment(va) : nullptr);
+  }
+  if (spine_rtti_instance_of(rt, spine_sequence_timeline_rtti())) {
+    spine_sequence_timeline qt = spine_timeline_cast_to_sequence_timeline(t);
+    return slot_attachment_target(spine_slot_timeline_get_slot_index(spine_sequence_timeline_cast_to_slot_timeline(qt)),
+                                  spine_sequence_timeline_get_attachment(qt));
+  }
+  if (spine_rtti_instance_of(rt, spine_slot_curve_timeline_rtti())) {
+    spine_slot_curve_timeline sct = spine_timeline_cast_to_slot_curve_timeline(t);
+    return indexed("slot", spine_slot_timeline_get_slot_index(spine_slot_curve_timeline_cast_to_slot_timeline(sct)));
+  }
+  if (spine_rtti_instance_of(rt, spine_alpha_timeline_rtti())) {
+    spine_alpha_timeline at = spine_timeline_cast_to_alpha_timeline(t);
+    return indexed("slot", spine_slot_timeline_get_slot_index(spine_alpha_timeline_cast_to_slot_timeline(at)));
+  }
+  if (spine_rtti_instance_of(rt, spine_attachment_timeline_rtti())) {
+    spine_attachment_timeline at = spine_timeline_cast_to_attachment_timeline(t);
+    return indexed("slot", spine_slot_timeline_get_slot_index(spine_attachment_timeline_cast_to_slot_timeline(at)));
+  }
+  spine_constraint_timeline ct = nullptr;
+  if (spine_rtti_instance_of(rt, spine_ik_constraint_timeline_rtti()))
+    ct = spine_ik_constraint_timeline_cast_to_constraint_timeline(spine_timeline_cast_to_ik_constraint_timeline(t));
+  else if (spine_rtti_instance_of(rt, spine_transform_constraint_timeline_rtti()))
+    ct = spine_transform_constraint_timeline_cast_to_constraint_timeline(
+        spine_timeline_cast_to_transform_constraint_timeline(t));
+  else if (spine_rtti_instance_of(rt, spine_path_constraint_mix_timeline_rtti()))
+    ct = spine_path_constraint_mix_timeline_cast_to_constraint_timeline(
+        spine_timeline_cast_to_path_constraint_mix_timeline(t));
+  else if (spine_rtti_instance_of(rt, spine_physics_constraint_reset_timeline_rtti()))
+    ct = spine_physics_constraint_reset_timeline_cast_to_constraint_timeline(
+        spine_timeline_cast_to_physics_constraint_reset_timeline(t));
+  else if (spine_rtti_instance_of(rt, spine_constraint_timeline1_rtti()))
+    ct = spine_constraint_timeline1_cast_to_constraint_timeline(spine_timeline_cast_to_constraint_timeline1(t));
+  if (ct) return indexed("constraint", spine_constraint_timeline_get_constraint_index(ct));
+  return "all";
+}
+
+// Curves of frames 0..n-2 (spine-cpp forces the last frame to STEPPED): 0 linear, 1 stepped, or 2
+// followed by `channels` x 18 bezier samples.
+static std::vector<float> canonical_curves(spine_timeline t, size_t channels) {
+  std::vector<float> out;
+  const float *curves = spine_array_float_buffer(spine_curve_timeline_get_curves(spine_timeline_cast_to_curve_timeline(t)));
+  const size_t frame_count = spine_timeline_get_frame_count(t);
+  for (size_t frame = 0; frame + 1 < frame_count; frame++) {
+    const int type = (int) curves[frame];
+    if (type < 2) {
+      out.push_back((float) type);
+      continue;
+    }
+    out.push_back(2.0f);
+    const float *samples = curves + (type - 2);
+    out.insert(out.end(), samples, samples + channels * BEZIER_SIZE);
+  }
+  return out;
+}
+
+static void dump_timeline(ModelDump &dump, const std::string &prefix, spine_timeline t, spine_rtti rt) {
+  dump.floats(prefix + "frames", float_array(spine_timeline_get_frames(t)));
+  if (spine_rtti_instance_of(rt, spine_curve_timeline_rtti())) {
+    const size_t entries = spine_timeline_get_frame_entries(t);
+    size_t channels = entries - 1;
+    if (spine_rtti_instance_of(rt, spine_ik_constraint_timeline_rtti())) channels = 2;
+    else if (spine_rtti_instance_of(rt, spine_deform_timeline_rtti())) channels = 1;
+    dump.floats(prefix + "curves", canonical_curves(t, channels));
+  }
+  if (spine_rtti_instance_of(rt, spine_attachment_timeline_rtti())) {
+    spine_array_string names = spine_attachment_timeline_get_attachment_names(spine_timeline_cast_to_attachment_timeline(t));
+    const char **buf = spine_array_string_buffer(names);
+    std::vector<std::string> out;
+    for (size_t i = 0, n = spine_array_string_size(names); i < n; i++) out.push_back(str(buf[i]));
+    dump.strings(prefix + "names", out);
+  } else if (spine_rtti_instance_of(rt, spine_deform_timeline_rtti())) {
+    spine_array_array_float vertices = spine_deform_timeline_get_vertices(spine_timeline_cast_to_deform_timeline(t));
+    spine_array_float *buf = spine_array_array_float_buffer(vertices);
+    for (size_t i = 0, n = spine_array_array_float_size(vertices); i < n; i++)
+      dump.floats(prefix + "vertices/" + std::to_string(i), float_array(buf[i]));
+  } else if (spine_rtti_instance_of(rt, spine_draw_order_timeline_rtti())) {
+    spine_array_array_int orders = spine_draw_order_timeline_get_draw_orders(spine_timeline_cast_to_draw_order_timeline(t));
+    spine_array_int *buf = spine_array_array_int_buffer(orders);
+    for (size_t i = 0, n = spine_array_array_int_size(orders); i < n; i++)
+      dump.ints(prefix + "drawOrder/" + std::to_string(i), int_array(buf[i]));
+  } else if (spine_rtti_instance_of(rt, spine_event_timeline_rtti())) {
+    spine_array_event events = spine_event_timeline_get_events(spine_timeline_cast_to_event_timeline(t));
+    spine_event *buf = spine_array_event_buffer(events);
+    for (size_t i = 0, n = spine_array_event_size(events); i < n; i++) {
+      const std::string key = prefix + "events/" + std::to_string(i) + "/";
+      dump.strings(key + "strings", {str(spine_event_data_get_name(spine_event_get_data(buf[i]))),
+                                     str(spine_event_get_string(buf[i]))});
+      dump.ints(key + "int", {spine_event_get_int(buf[i])});
+      dump.floats(key + "values", {spine_event_get_float(buf[i]), spine_event_get_volume(buf[i]),
+                                   spine_event_get_balance(buf[i])});
+    }
+  }
+}
+
+static bool write_model_dump(spine_skeleton_data data, const char *out_path) {
+  ModelDump dump;
+  dump.out = "SPMD";
+  dump.u32(MODEL_DUMP_VERSION);
+  dump.floats("skeleton/referenceScale", {spine_skeleton_data_get_reference_scale(data)});
+
+  spine_array_bone_data bones = spine_skeleton_data_get_bones(data);
+  spine_bone_data *bone_buf = spine_array_bone_data_buffer(bones);
+  for (size_t i = 0, n = spine_array_bone_data_size(bones); i < n; i++) {
+    spine_bone_data b = bone_buf[i];
+    spine_bone_local setup = spine_bone_data_get_setup_pose(b);
+    const std::string prefix = "bone/" + std::to_string(i) + "/";
+    dump.strings(prefix + "name", {str(spine_bone_data_get_name(b))});
+    dump.ints(prefix + "parent", {bone_index(spine_bone_data_get_parent(b))});
+    dump.floats(prefix + "setup", {spine_bone_local_get_x(setup), spine_bone_local_get_y(setup),
+                                   spine_bone_local_get_rotation(setup), spine_bone_local_get_scale_x(setup),
+                                   spine_bone_local_get_scale_y(setup), spine_bone_local_get_shear_x(setup),
+                                   spine_bone_local_get_shear_y(setup), spine_bone_data_get_length(b)});
+    dump.ints(prefix + "flags",
+              {(int) spine_bone_local_get_inherit(setup), spine_bone_data_get_skin_required(b) ? 1 : 0});
+  }
+
+  spine_array_slot_data slots = spine_skeleton_data_get_slots(data);
+  spine_slot_data *slot_buf = spine_array_slot_data_buffer(slots);
+  const size_t slot_count = spine_array_slot_data_size(slots);
+  for (size_t i = 0; i < slot_count; i++) {
+    spine_slot_data s = slot_buf[i];
+    spine_slot_pose setup = spine_slot_data_get_setup_pose(s);
+    const bool has_dark = spine_slot_pose_has_dark_color(setup);
+    const std::string prefix = "slot/" + std::to_string(i) + "/";
+    dump.strings(prefix + "name", {str(spine_slot_data_get_name(s))});
+    dump.ints(prefix + "flags", {bone_index(spine_slot_data_get_bone_data(s)), (int) spine_slot_data_get_blend_mode(s),
+                                 has_dark ? 1 : 0});
+    dump.floats(prefix + "color", color4(spine_slot_pose_get_color(setup)));
+    if (has_dark) {
+      spine_color dark = spine_slot_pose_get_dark_color(setup);
+      dump.floats(prefix + "dark", {spine_color_get_r(dark), spine_color_get_g(dark), spine_color_get_b(dark)});
+    }
+    dump.strings(prefix + "attachment", opt_string(spine_slot_data_get_attachment_name(s)));
+  }
+
+  spine_array_constraint_data constraints = spine_skeleton_data_get_constraints(data);
+  spine_constraint_data *constraint_buf = spine_array_constraint_data_buffer(constraints);
+  for (size_t i = 0, n = spine_array_constraint_data_size(constraints); i < n; i++)
+    dump_constraint(dump, "constraint/" + std::to_string(i) + "/", constraint_buf[i]);
+
+  spine_array_skin skins = spine_skeleton_data_get_skins(data);
+  spine_skin *skin_buf = spine_array_skin_buffer(skins);
+  std::vector<std::pair<std::string, spine_skin>> sorted_skins;
+  for (size_t i = 0, n = spine_array_skin_size(skins); i < n; i++)
+    sorted_skins.emplace_back(str(spine_skin_get_name(skin_buf[i])), skin_buf[i]);
+  std::sort(sorted_skins.begin(), sorted_skins.end(), by_name<spine_skin>);
+  for (size_t k = 0; k < sorted_skins.size(); k++) {
+    spine_skin skin = sorted_skins[k].second;
+    const std::string &skin_name = sorted_skins[k].first;
+    const std::string prefix = "skin/" + skin_name + "/";
+    std::vector<int> skin_bones = bone_indices(spine_skin_get_bones(skin));
+    std::sort(skin_bones.begin(), skin_bones.end());
+    dump.ints(prefix + "bones", skin_bones);
+    std::vector<int> skin_constraints;
+    spine_array_constraint_data sc = spine_skin_get_constraints(skin);
+    spine_constraint_data *sc_buf = spine_array_constraint_data_buffer(sc);
+    for (size_t i = 0, n = spine_array_constraint_data_size(sc); i < n; i++)
+      skin_constraints.push_back(constraint_index(constraints, sc_buf[i]));
+    std::sort(skin_constraints.begin(), skin_constraints.end());
+    dump.ints(prefix + "constraints", skin_constraints);
+
+    spine_array_string names = spine_array_string_create();
+    for (size_t slot = 0; slot < slot_count; slot++) {
+      spine_array_string_clear(names);
+      spine_skin_find_names_for_slot(skin, slot, names);
+      const char **name_buf = spine_array_string_buffer(names);
+      const size_t name_count = spine_array_string_size(names);
+      std::vector<std::string> keys(name_buf, name_buf + name_count);
+      std::sort(keys.begin(), keys.end());
+      for (const std::string &key : keys) {
+        spine_attachment a = spine_skin_get_attachment(skin, slot, key.c_str());
+        if (a) dump_attachment(dump, prefix + std::to_string(slot) + "/" + key + "/", a);
+      }
+    }
+    spine_array_string_dispose(names);
+  }
+
+  spine_array_event_data events = spine_skeleton_data_get_events(data);
+  spine_event_data *event_buf = spine_array_event_data_buffer(events);
+  std::vector<std::pair<std::string, spine_event_data>> sorted_events;
+  for (size_t i = 0, n = spine_array_event_data_size(events); i < n; i++)
+    sorted_events.emplace_back(str(spine_event_data_get_name(event_buf[i])), event_buf[i]);
+  std::sort(sorted_events.begin(), sorted_events.end(), by_name<spine_event_data>);
+  for (size_t k = 0; k < sorted_events.size(); k++) {
+    spine_event_data e = sorted_events[k].second;
+    const std::string &event_name = sorted_events[k].first;
+    const std::string prefix = "event/" + event_name + "/";
+    dump.ints(prefix + "int", {spine_event_data_get_int_value(e)});
+    dump.floats(prefix + "values",
+                {spine_event_data_get_float_value(e), spine_event_data_get_volume(e), spine_event_data_get_balance(e)});
+    dump.strings(prefix + "strings", {str(spine_event_data_get_string_value(e)), str(spine_event_data_get_audio_path(e))});
+  }
+
+  spine_array_animation animations = spine_skeleton_data_get_animations(data);
+  spine_animation *anim_buf = spine_array_animation_buffer(animations);
+  std::vector<std::pair<std::string, spine_animation>> sorted_animations;
+  for (size_t i = 0, n = spine_array_animation_size(animations); i < n; i++)
+    sorted_animations.emplace_back(str(spine_animation_get_name(anim_buf[i])), anim_buf[i]);
+  std::sort(sorted_animations.begin(), sorted_animations.end(), by_name<spine_animation>);
+  for (size_t k = 0; k < sorted_animations.size(); k++) {
+    spine_animation anim = sorted_animations[k].second;
+    const std::string &anim_name = sorted_animations[k].first;
+    const std::string prefix = "animation/" + anim_name + "/";
+    dump.floats(prefix + "duration", {spine_animation_get_duration(anim)});
+    spine_array_timeline timelines = spine_animation_get_timelines(anim);
+    spine_timeline *tbuf = spine_array_timeline_buffer(timelines);
+    std::vector<std::pair<std::string, spine_timeline>> sorted_timelines;
+    for (size_t i = 0, n = spine_array_timeline_size(timelines); i < n; i++) {
+      const spine_rtti rt = spine_timeline_get_rtti(tbuf[i]);
+      sorted_timelines.emplace_back(str(spine_rtti_get_class_name(rt)) + "/" + timeline_target(tbuf[i], rt), tbuf[i]);
+    }
+    std::stable_sort(sorted_timelines.begin(), sorted_timelines.end(), by_name<spine_timeline>);
+    for (size_t i = 0; i < sorted_timelines.size(); i++) {
+      spine_timeline t = sorted_timelines[i].second;
+      dump_timeline(dump, prefix + sorted_timelines[i].first + "/", t, spine_timeline_get_rtti(t));
+    }
+  }
+
+  std::ofstream out(out_path, std::ios::binary);
+  out.write(dump.out.data(), (std::streamsize) dump.out.size());
+  return (bool) out;
 }
 
 int main(int argc, char **argv) {
@@ -40,6 +561,7 @@ int main(int argc, char **argv) {
 
   int y_down = 0;
   const char *dump_animation = nullptr;
+  const char *model_out = nullptr;
   for (int i = 3; i < argc; i++) {
     if (std::strcmp(argv[i], "--y-down") == 0 && i + 1 < argc) {
       y_down = std::atoi(argv[i + 1]) ? 1 : 0;
@@ -51,59 +573,20 @@ int main(int argc, char **argv) {
       i++;
       continue;
     }
+    if (std::strcmp(argv[i], "--model-out") == 0 && i + 1 < argc) {
+      model_out = argv[i + 1];
+      i++;
+      continue;
+    }
   }
 
   spine_bone_set_y_down(y_down ? true : false);
 
   spine_atlas_result atlas_result = nullptr;
-  spine_atlas atlas = nullptr;
-  {
-    std::string atlas_text = read_file(atlas_path);
-    atlas_result = spine_atlas_load(atlas_text.c_str());
-    if (!atlas_result) {
-      std::cerr << "spine_atlas_load failed\n";
-      return 2;
-    }
-    const char *err = spine_atlas_result_get_error(atlas_result);
-    if (err && err[0]) {
-      std::cerr << "atlas error: " << err << "\n";
-      return 2;
-    }
-    atlas = spine_atlas_result_get_atlas(atlas_result);
-    if (!atlas) {
-      std::cerr << "missing atlas\n";
-      return 2;
-    }
-  }
+  spine_atlas atlas = load_atlas_or_die(atlas_path, atlas_result);
 
   spine_skeleton_data_result data_result = nullptr;
-  spine_skeleton_data data = nullptr;
-  {
-    const std::string sk_path(skeleton_path);
-    if (ends_with(sk_path, ".skel")) {
-      std::string bytes = read_file(skeleton_path);
-      data_result = spine_skeleton_data_load_binary(
-          atlas, reinterpret_cast<const uint8_t *>(bytes.data()), (int32_t)bytes.size(), skeleton_path);
-    } else {
-      std::string json_text = read_file(skeleton_path);
-      data_result = spine_skeleton_data_load_json(atlas, json_text.c_str(), skeleton_path);
-    }
-
-    if (!data_result) {
-      std::cerr << "spine_skeleton_data_load_* failed\n";
-      return 2;
-    }
-    const char *err = spine_skeleton_data_result_get_error(data_result);
-    if (err && err[0]) {
-      std::cerr << "skeleton data error: " << err << "\n";
-      return 2;
-    }
-    data = spine_skeleton_data_result_get_data(data_result);
-    if (!data) {
-      std::cerr << "missing skeleton data\n";
-      return 2;
-    }
-  }
+  spine_skeleton_data data = load_skeleton_data_or_die(atlas, skeleton_path, data_result);
 
   spine_array_constraint_data constraints = spine_skeleton_data_get_constraints(data);
   const size_t n = spine_array_constraint_data_size(constraints);
@@ -205,9 +688,10 @@ int main(int argc, char **argv) {
     }
   }
 
-  spine_skeleton_data_result_dispose(data_result);
-  spine_atlas_dispose(atlas);
-  spine_atlas_result_dispose(atlas_result);
+  if (model_out != nullptr && !write_model_dump(data, model_out)) {
+    std::cerr << "Failed to write " << model_out << "\n";
+    return 2;
+  }
 
   if (dump_animation != nullptr) {
     spine_animation anim = spine_skeleton_data_find_animation(data, dump_animation);
@@ -284,5 +768,8 @@ int main(int argc, char **argv) {
     }
   }
 
+  spine_skeleton_data_result_dispose(data_result);
+  spine_atlas_dispose(atlas);
+  spine_atlas_result_dispose(atlas_result);
   return 0;
 }
@@ -1,17 +1,17 @@
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
-#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
-#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "spine-c.h"
+#include "spine_cpp_lite_oracle_core.h"
 
 // PhysicsConstraint runtime state fields are private in spine-cpp. For oracle/debugging, we
 // temporarily widen access to compare internal state to our Rust implementation.
@@ -19,17 +19,6 @@
 #include <spine/PhysicsConstraint.h>
 #undef private
 
-static std::string read_file(const char *path) {
-  std::ifstream file(path, std::ios::binary);
-  if (!file) {
-    std::cerr << "failed to open: " << path << "\n";
-    std::exit(2);
-  }
-  std::ostringstream ss;
-  ss << file.rdbuf();
-  return ss.str();
-}
-
 static void usage() {
   std::cerr
       << "Usage:\n"
@@ -41,6 +30,8 @@ static void usage() {
          "Commands (scenario mode):\n"
          "  --set-skin <name|none>\n"
          "  --physics <none|reset|update|pose>\n"
+         "  --wind <x> <y>\n"
+         "  --gravity <x> <y>\n"
          "  --mix <from> <to> <duration>\n"
          "  --set <track> <animation> <loop 0|1>\n"
          "  --add <track> <animation> <loop 0|1> <delay>\n"
@@ -58,22 +49,49 @@ static void usage() {
          "  --entry-shortest-rotation <0|1>\n"
          "  --entry-reset-rotation-directions\n"
          "  --dump-update-cache\n"
-         "  --step <dt>\n";
-}
-
-static std::string json_escape(const char *s) {
-  if (!s) return "";
-  std::string out;
-  for (const char *p = s; *p; p++) {
-    const unsigned char c = static_cast<unsigned char>(*p);
-    if (c == '\\') out += "\\\\";
-    else if (c == '\"') out += "\\\"";
-    else if (c == '\n') out += "\\n";
-    else if (c == '\r') out += "\\r";
-    else if (c == '\t') out += "\\t";
-    else out += static_cast<char>(c);
-  }
-  return out;
+         "  --update-cache-timing         (SPINE2D_ORACLE_UPDATE_PROBE=1 builds: per update cache entry calls and\n"
+         "                                 total/mean/max ns over every world transform of the run, labeled as\n"
+         "                                 in --dump-update-cache, plus totals per bone/ik/transform/path/\n"
+         "                                 physics/slider)\n"
+         "  --dump-all-slot-vertices      (world vertices of every vertex attachment + offset table)\n"
+         "  --check-invariants            (after every --step: abort with exit 1 on NaN/Inf or |value| > limit\n"
+         "                                 in bone world matrices, slot colors or physics state)\n"
+         "  --invariant-limit <abs>       (default 1e6)\n"
+         "  --step <dt>\n"
+         "\n"
+         "Physics sweep (scenario mode; runs the command stream once per grid point, NDJSON output):\n"
+         "  --sweep-wind-x <v0,v1,...|start:stop:count>\n"
+         "  --sweep-wind-y <v0,v1,...|start:stop:count>\n"
+         "  --sweep-gravity-x <v0,v1,...|start:stop:count>\n"
+         "  --sweep-gravity-y <v0,v1,...|start:stop:count>\n"
+         "\n"
+         "Benchmark (scenario mode; per-phase update/apply/world/render timings as JSON):\n"
+         "  --bench <iterations>\n"
+         "  --bench-warmup <iterations>   (default 1)\n"
+         "  --bench-counters              (Linux perf_event_open: cycles, instructions, L1D/LLC/branch misses\n"
+         "                                 per phase per frame; adds read overhead to the timings)\n"
+         "\n"
+         "Animation x skin sweep (replaces the command stream; NDJSON + <out>.index.json):\n"
+         "  --sweep <out.ndjson>          every animation x every skin x a time grid over [0, duration], each\n"
+         "                                combination from setup pose; one line per frame with bones as\n"
+         "                                [a,b,c,d,worldX,worldY] and slots as [r,g,b,a,attachment]\n"
+         "  --sweep-hz <hz>               (default 30; `--physics <mode>` applies to every frame)\n"
+         "\n"
+         "Mixing-depth profile (scenario mode; JSON):\n"
+         "  --mix-profile <iterations>    per step: active track entries, mixingFrom depth per track and\n"
+         "                                spine_animation_state_apply time (median over iterations), plus\n"
+         "                                an apply-cost-per-depth curve and the deepest chains seen\n"
+         "\n"
+         "Tracing (any mode):\n"
+         "  --trace-out <file.json>       (Chrome Trace Event zones: load atlas/skeleton, per-step\n"
+         "                                 update/apply/world[/render], serialization; open in ui.perfetto.dev)\n"
+         "\n"
+         "Heap guard (batch modes: --sweep, physics sweep, --bench, --mix-profile):\n"
+         "  --heap-guard <bytes>          count spine-cpp allocations; after each scenario's drawable is\n"
+         "                                disposed, fail with exit 1 if live bytes exceed the post-load\n"
+         "                                baseline by more than <bytes>\n"
+         "  --heap-out <file.json>        per-scenario retained/peak bytes over the baseline (alone: report\n"
+         "                                only, never fails)\n";
 }
 
 struct AttachmentTypeInfo {
@@ -93,63 +111,644 @@ static AttachmentTypeInfo attachment_type_info(spine_attachment att) {
   return {-1, "unknown"};
 }
 
-static spine_atlas load_atlas_or_die(const char *atlas_path, spine_atlas_result &out_result) {
-  std::string atlas_text = read_file(atlas_path);
-  out_result = spine_atlas_load(atlas_text.c_str());
-  if (!out_result) {
-    std::cerr << "spine_atlas_load failed\n";
-    std::exit(2);
+// `"allSlotVertices":{"slots":[...],"vertices":[...]}`: world vertices of every slot whose applied
+// attachment is a vertex attachment (mesh, path, bounding box, clipping), concatenated in slot
+// order into one flat array. Each `slots` entry gives the `offset`/`length` (in floats) of its run.
+static void print_all_slot_vertices(spine_skeleton skeleton) {
+  spine_array_slot slots = spine_skeleton_get_slots(skeleton);
+  const size_t ns = spine_array_slot_size(slots);
+  spine_slot *slots_buf = spine_array_slot_buffer(slots);
+  std::vector<float> all;
+  std::vector<float> verts;
+  std::cout << "\"allSlotVertices\":{\"slots\":[";
+  bool first = true;
+  for (size_t i = 0; i < ns; i++) {
+    spine_slot slot = slots_buf[i];
+    spine_attachment att = spine_slot_pose_get_attachment(spine_slot_get_applied_pose(slot));
+    if (!att) continue;
+    const AttachmentTypeInfo info = attachment_type_info(att);
+    if (info.type < 1 || info.type > 4) continue;  // mesh, clipping, bounding box, path
+    spine_vertex_attachment va = spine_attachment_cast_to_vertex_attachment(att);
+    const size_t len = spine_vertex_attachment_get_world_vertices_length(va);
+    verts.assign(len, 0.0f);
+    if (len > 0) spine_vertex_attachment_compute_world_vertices_1(va, skeleton, slot, 0, len, verts.data(), 0, 2);
+    spine_slot_data sd = spine_slot_get_data(slot);
+    if (!first) std::cout << ",";
+    first = false;
+    std::cout << "{\"slot\":" << i << ",\"name\":\"" << json_escape(sd ? spine_slot_data_get_name(sd) : "<unknown>")
+              << "\",\"attachment\":\"" << json_escape(spine_attachment_get_name(att)) << "\",\"type\":\""
+              << info.name << "\",\"offset\":" << all.size() << ",\"length\":" << len << "}";
+    all.insert(all.end(), verts.begin(), verts.end());
+  }
+  std::cout << "],\"vertices\":[";
+  for (size_t j = 0; j < all.size(); j++) {
+    if (j) std::cout << ",";
+    std::cout << all[j];
+  }
+  std::cout << "]}";
+}
+
+// Labels for update cache entries keyed by `spine_update`: "bone <name>", "ik <name>", "transform <name>",
+// "path <name>", "physics <name>", "slider <name>" (other constraints: "constraint <name>").
+static std::unordered_map<const void *, std::string> update_cache_labels(spine_skeleton skeleton) {
+  spine_array_bone bones = spine_skeleton_get_bones(skeleton);
+  const size_t nb = spine_array_bone_size(bones);
+  spine_bone *bones_buf = spine_array_bone_buffer(bones);
+  spine_array_constraint constraints = spine_skeleton_get_constraints(skeleton);
+  const size_t nc = spine_array_constraint_size(constraints);
+  spine_constraint *constraints_buf = spine_array_constraint_buffer(constraints);
+
+  std::unordered_map<const void *, std::string> labels;
+  labels.reserve(nb + nc + 8);
+  for (size_t i = 0; i < nb; i++) {
+    spine_bone bone = bones_buf[i];
+    spine_bone_data bd = spine_bone_get_data(bone);
+    const char *name = bd ? spine_bone_data_get_name(bd) : "<unknown>";
+    spine_bone_pose pose = spine_bone_get_applied_pose(bone);
+    const spine_update u = spine_bone_pose_cast_to_update(pose);
+    labels[(const void *)u] = std::string("bone ") + name;
+  }
+  for (size_t i = 0; i < nc; i++) {
+    spine_constraint cst = constraints_buf[i];
+    spine_constraint_data cd = spine_constraint_get_data(cst);
+    const char *name = cd ? spine_constraint_data_get_name(cd) : "<unknown>";
+    const spine_rtti rt = spine_constraint_get_rtti(cst);
+    std::string prefix = "constraint ";
+    if (spine_rtti_instance_of(rt, spine_ik_constraint_rtti())) prefix = "ik ";
+    else if (spine_rtti_instance_of(rt, spine_transform_constraint_rtti())) prefix = "transform ";
+    else if (spine_rtti_instance_of(rt, spine_path_constraint_rtti())) prefix = "path ";
+    else if (spine_rtti_instance_of(rt, spine_physics_constraint_rtti())) prefix = "physics ";
+    else if (spine_rtti_instance_of(rt, spine_slider_rtti())) prefix = "slider ";
+    const spine_update u = spine_constraint_cast_to_update(cst);
+    labels[(const void *)u] = prefix + name;
+  }
+  return labels;
+}
+
+static std::string update_cache_label(const std::unordered_map<const void *, std::string> &labels, const void *u) {
+  auto it = labels.find(u);
+  return it == labels.end() ? std::string("<unknown>") : it->second;
+}
+
+// `--update-cache-timing`: wall time of every update cache entry across all of the run's
+// `Skeleton::updateWorldTransform` calls, recorded by the Skeleton.cpp probe patch
+// (`SPINE2D_ORACLE_UPDATE_PROBE=1` builds). Entries keep first-update (update cache) order.
+struct UpdateCacheTiming {
+  struct Entry {
+    const void *update;
+    int64_t calls;
+    int64_t total_ns;
+    int64_t max_ns;
+  };
+  std::unordered_map<const void *, size_t> index;
+  std::vector<Entry> entries;
+};
+
+static UpdateCacheTiming *g_update_timing = nullptr;
+
+#if SPINE2D_ORACLE_UPDATE_PROBE
+namespace spine {
+class Update;
+extern void (*spine2d_oracle_update_probe)(Update *entry, long long ns);
+}  // namespace spine
+
+static void record_update_probe(spine::Update *entry, long long ns) {
+  UpdateCacheTiming &timing = *g_update_timing;
+  const void *u = (const void *)entry;
+  auto it = timing.index.find(u);
+  if (it == timing.index.end()) {
+    it = timing.index.insert(std::make_pair(u, timing.entries.size())).first;
+    const UpdateCacheTiming::Entry e = {u, 0, 0, 0};
+    timing.entries.push_back(e);
   }
-  const char *err = spine_atlas_result_get_error(out_result);
-  if (err && err[0]) {
-    std::cerr << "atlas error: " << err << "\n";
-    std::exit(2);
+  UpdateCacheTiming::Entry &e = timing.entries[it->second];
+  e.calls++;
+  e.total_ns += ns;
+  e.max_ns = std::max(e.max_ns, (int64_t)ns);
+}
+#endif
+
+static bool update_cache_timing_begin(UpdateCacheTiming &timing) {
+#if SPINE2D_ORACLE_UPDATE_PROBE
+  g_update_timing = &timing;
+  spine::spine2d_oracle_update_probe = record_update_probe;
+  return true;
+#else
+  (void)timing;
+  std::cerr << "--update-cache-timing needs the probe build (SPINE2D_ORACLE_UPDATE_PROBE=1)\n";
+  return false;
+#endif
+}
+
+static void update_cache_timing_end() {
+#if SPINE2D_ORACLE_UPDATE_PROBE
+  spine::spine2d_oracle_update_probe = nullptr;
+#endif
+  g_update_timing = nullptr;
+}
+
+// Median cost of the probe's two clock reads, which every entry's time includes.
+static int64_t probe_clock_overhead_ns() {
+  std::vector<int64_t> samples(1001);
+  for (size_t i = 0; i < samples.size(); i++) {
+    const BenchClock::time_point t0 = BenchClock::now();
+    samples[i] = elapsed_ns(t0, BenchClock::now());
   }
-  spine_atlas atlas = spine_atlas_result_get_atlas(out_result);
-  if (!atlas) {
-    std::cerr << "missing atlas\n";
-    std::exit(2);
+  return percentile_ns(samples, 0.5);
+}
+
+// `"updateCacheTiming":{...}`: per-entry calls/total/mean/max ns, plus totals per entry type.
+static void print_update_cache_timing(spine_skeleton skeleton, const UpdateCacheTiming &timing) {
+  const std::unordered_map<const void *, std::string> labels = update_cache_labels(skeleton);
+  const char *const types[] = {"bone", "ik", "transform", "path", "physics", "slider", "constraint", "<unknown>"};
+  const size_t ntypes = sizeof(types) / sizeof(types[0]);
+  std::vector<int64_t> type_ns(ntypes, 0);
+  std::vector<int> type_entries(ntypes, 0);
+  int64_t total_ns = 0;
+
+  std::cout << "\"updateCacheTiming\":{\"clockOverheadNs\":" << probe_clock_overhead_ns() << ",\"entries\":[";
+  for (size_t i = 0; i < timing.entries.size(); i++) {
+    const UpdateCacheTiming::Entry &e = timing.entries[i];
+    const std::string label = update_cache_label(labels, e.update);
+    const std::string type = label.substr(0, label.find(' '));
+    size_t t = ntypes - 1;
+    for (size_t k = 0; k < ntypes; k++) {
+      if (type == types[k]) t = k;
+    }
+    type_ns[t] += e.total_ns;
+    type_entries[t]++;
+    total_ns += e.total_ns;
+    if (i) std::cout << ",";
+    std::cout << "{\"entry\":\"" << json_escape(label.c_str()) << "\",\"type\":\"" << types[t]
+              << "\",\"calls\":" << e.calls << ",\"totalNs\":" << e.total_ns
+              << ",\"meanNs\":" << (e.calls ? (double)e.total_ns / (double)e.calls : 0.0) << ",\"maxNs\":" << e.max_ns
+              << "}";
+  }
+  std::cout << "],\"byType\":[";
+  bool first = true;
+  for (size_t k = 0; k < ntypes; k++) {
+    if (!type_entries[k]) continue;
+    if (!first) std::cout << ",";
+    first = false;
+    std::cout << "{\"type\":\"" << types[k] << "\",\"entries\":" << type_entries[k] << ",\"totalNs\":" << type_ns[k]
+              << ",\"share\":" << (total_ns ? (double)type_ns[k] / (double)total_ns : 0.0) << "}";
+  }
+  std::cout << "],\"totalNs\":" << total_ns << "}";
+}
+
+static bool is_sweep_option(const char *arg) {
+  return std::strcmp(arg, "--sweep-wind-x") == 0 || std::strcmp(arg, "--sweep-wind-y") == 0 ||
+         std::strcmp(arg, "--sweep-gravity-x") == 0 || std::strcmp(arg, "--sweep-gravity-y") == 0;
+}
+
+// Parses a sweep axis: either a comma separated list (`0,0.5,1`) or an inclusive range
+// `<start>:<stop>:<count>`.
+static bool parse_sweep_axis(const char *spec, std::vector<float> &out) {
+  out.clear();
+  const std::string s(spec);
+  if (std::count(s.begin(), s.end(), ':') == 2) {
+    const size_t a = s.find(':');
+    const size_t b = s.find(':', a + 1);
+    const float start = std::strtof(s.substr(0, a).c_str(), nullptr);
+    const float stop = std::strtof(s.substr(a + 1, b - a - 1).c_str(), nullptr);
+    const int count = std::atoi(s.substr(b + 1).c_str());
+    if (count < 1) return false;
+    for (int i = 0; i < count; i++) {
+      const float t = count == 1 ? 0.0f : (float)i / (float)(count - 1);
+      out.push_back(start + (stop - start) * t);
+    }
+    return true;
+  }
+  size_t pos = 0;
+  while (pos <= s.size()) {
+    size_t end = s.find(',', pos);
+    if (end == std::string::npos) end = s.size();
+    if (end == pos) return false;
+    out.push_back(std::strtof(s.substr(pos, end - pos).c_str(), nullptr));
+    pos = end + 1;
   }
-  return atlas;
+  return !out.empty();
+}
+
+static bool is_bench_option(const char *arg) {
+  return std::strcmp(arg, "--bench") == 0 || std::strcmp(arg, "--bench-warmup") == 0;
 }
 
-static spine_skeleton_data load_skeleton_data_or_die(
-    spine_atlas atlas,
-    const char *skeleton_path,
-    spine_skeleton_data_result &out_result) {
-  out_result = nullptr;
-  const std::string path_s(skeleton_path);
-  if (path_s.size() >= 5 && path_s.compare(path_s.size() - 5, 5, ".skel") == 0) {
-    std::string bytes = read_file(skeleton_path);
-    out_result = spine_skeleton_data_load_binary(
-        atlas, reinterpret_cast<const uint8_t *>(bytes.data()), (int32_t)bytes.size(), skeleton_path);
+// Global options consumed by the pre-scan in `main` (skipped by `run_scenario_commands`).
+static int pose_option_arity(const char *arg) {
+  if (is_sweep_option(arg) || is_bench_option(arg) || std::strcmp(arg, "--mix-profile") == 0) return 1;
+  if (std::strcmp(arg, "--sweep") == 0 || std::strcmp(arg, "--sweep-hz") == 0) return 1;
+  if (std::strcmp(arg, "--bench-counters") == 0 || std::strcmp(arg, "--update-cache-timing") == 0) return 0;
+  return -1;
+}
+
+struct PhysicsSweep {
+  bool enabled = false;
+  std::vector<float> wind_x;
+  std::vector<float> wind_y;
+  std::vector<float> gravity_x;
+  std::vector<float> gravity_y;
+};
+
+// Runs the scenario once per (windX, windY, gravityX, gravityY) grid point, reusing the loaded
+// skeleton data. Output is NDJSON: a header line naming bones/physics constraints, then one
+// compact line per grid point. Axes that are not swept keep the skeleton defaults; explicit
+// `--wind/--gravity` commands in the scenario still override the grid values.
+static int run_physics_sweep(int argc, char **argv, spine_skeleton_data data, const PhysicsSweep &sweep) {
+  spine_skeleton_drawable probe = spine_skeleton_drawable_create(data);
+  if (!probe) {
+    std::cerr << "spine_skeleton_drawable_create failed\n";
+    return 2;
+  }
+  spine_skeleton probe_skeleton = spine_skeleton_drawable_get_skeleton(probe);
+  const std::vector<float> wind_x =
+      sweep.wind_x.empty() ? std::vector<float>{spine_skeleton_get_wind_x(probe_skeleton)} : sweep.wind_x;
+  const std::vector<float> wind_y =
+      sweep.wind_y.empty() ? std::vector<float>{spine_skeleton_get_wind_y(probe_skeleton)} : sweep.wind_y;
+  const std::vector<float> gravity_x =
+      sweep.gravity_x.empty() ? std::vector<float>{spine_skeleton_get_gravity_x(probe_skeleton)} : sweep.gravity_x;
+  const std::vector<float> gravity_y =
+      sweep.gravity_y.empty() ? std::vector<float>{spine_skeleton_get_gravity_y(probe_skeleton)} : sweep.gravity_y;
+
+  {
+    spine_array_bone bones = spine_skeleton_get_bones(probe_skeleton);
+    const size_t nb = spine_array_bone_size(bones);
+    spine_bone *bones_buf = spine_array_bone_buffer(bones);
+    spine_array_physics_constraint phys = spine_skeleton_get_physics_constraints(probe_skeleton);
+    const size_t nphys = spine_array_physics_constraint_size(phys);
+    spine_physics_constraint *phys_buf = spine_array_physics_constraint_buffer(phys);
+    std::cout << "{\"mode\":\"physics-sweep\",\"points\":"
+              << wind_x.size() * wind_y.size() * gravity_x.size() * gravity_y.size() << ",\"bones\":[";
+    for (size_t i = 0; i < nb; i++) {
+      spine_bone_data bd = spine_bone_get_data(bones_buf[i]);
+      std::cout << "\"" << json_escape(bd ? spine_bone_data_get_name(bd) : "<unknown>") << "\"";
+      if (i + 1 != nb) std::cout << ",";
+    }
+    std::cout << "],\"physicsConstraints\":[";
+    for (size_t i = 0; i < nphys; i++) {
+      spine_physics_constraint_data cd = spine_physics_constraint_get_data(phys_buf[i]);
+      std::cout << "\"" << json_escape(cd ? spine_physics_constraint_data_get_name(cd) : "<unknown>") << "\"";
+      if (i + 1 != nphys) std::cout << ",";
+    }
+    std::cout << "]}\n";
+  }
+  spine_skeleton_drawable_dispose(probe);
+
+  for (float wx : wind_x) {
+    for (float wy : wind_y) {
+      for (float gx : gravity_x) {
+        for (float gy : gravity_y) {
+          TraceZone point_zone("sweep", "point");
+          spine_skeleton_drawable drawable = spine_skeleton_drawable_create(data);
+          if (!drawable) {
+            std::cerr << "spine_skeleton_drawable_create failed\n";
+            return 2;
+          }
+          ScenarioRun run = scenario_run_for(drawable);
+          spine_skeleton_setup_pose(run.skeleton);
+          spine_skeleton_set_wind_x(run.skeleton, wx);
+          spine_skeleton_set_wind_y(run.skeleton, wy);
+          spine_skeleton_set_gravity_x(run.skeleton, gx);
+          spine_skeleton_set_gravity_y(run.skeleton, gy);
+          const int rc = run_scenario_commands(argc, argv, run, pose_option_arity, usage);
+          if (rc != 0) {
+            spine_skeleton_drawable_dispose(drawable);
+            return rc;
+          }
+
+          // Bones as [a,b,c,d,worldX,worldY]; physics as [xOffset,yOffset,rotateOffset,scaleOffset].
+          TraceZone serialize_zone("output", "serialize");
+          spine_array_bone bones = spine_skeleton_get_bones(run.skeleton);
+          const size_t nb = spine_array_bone_size(bones);
+          spine_bone *bones_buf = spine_array_bone_buffer(bones);
+          std::cout << "{\"wind\":[" << wx << "," << wy << "],\"gravity\":[" << gx << "," << gy
+                    << "],\"time\":" << run.total_time << ",\"bones\":[";
+          for (size_t i = 0; i < nb; i++) {
+            spine_bone_pose pose = spine_bone_get_applied_pose(bones_buf[i]);
+            std::cout << "[" << spine_bone_pose_get_a(pose) << "," << spine_bone_pose_get_b(pose) << ","
+                      << spine_bone_pose_get_c(pose) << "," << spine_bone_pose_get_d(pose) << ","
+                      << spine_bone_pose_get_world_x(pose) << "," << spine_bone_pose_get_world_y(pose) << "]";
+            if (i + 1 != nb) std::cout << ",";
+          }
+          spine_array_physics_constraint phys = spine_skeleton_get_physics_constraints(run.skeleton);
+          const size_t nphys = spine_array_physics_constraint_size(phys);
+          spine_physics_constraint *phys_buf = spine_array_physics_constraint_buffer(phys);
+          std::cout << "],\"physics\":[";
+          for (size_t i = 0; i < nphys; i++) {
+            const auto *cpp = reinterpret_cast<const spine::PhysicsConstraint *>(phys_buf[i]);
+            std::cout << "[" << cpp->_xOffset << "," << cpp->_yOffset << "," << cpp->_rotateOffset << ","
+                      << cpp->_scaleOffset << "]";
+            if (i + 1 != nphys) std::cout << ",";
+          }
+          std::cout << "]}\n";
+
+          spine_skeleton_drawable_dispose(drawable);
+          if (!heap_guard_after_scenario()) return 1;
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+// `--sweep` frame: bones as [a,b,c,d,worldX,worldY], slots as [r,g,b,a,attachmentName|null].
+static void write_sweep_pose(spine_skeleton_drawable drawable, const char *animation, const char *skin, float time,
+                             void *) {
+  spine_skeleton skeleton = spine_skeleton_drawable_get_skeleton(drawable);
+  spine_array_bone bones = spine_skeleton_get_bones(skeleton);
+  const size_t nb = spine_array_bone_size(bones);
+  spine_bone *bones_buf = spine_array_bone_buffer(bones);
+  std::cout << "{\"animation\":\"" << json_escape(animation) << "\",\"skin\":";
+  if (skin) {
+    std::cout << "\"" << json_escape(skin) << "\"";
   } else {
-    std::string json_text = read_file(skeleton_path);
-    out_result = spine_skeleton_data_load_json(atlas, json_text.c_str(), skeleton_path);
+    std::cout << "null";
+  }
+  std::cout << ",\"time\":" << time << ",\"bones\":[";
+  for (size_t i = 0; i < nb; i++) {
+    spine_bone_pose pose = spine_bone_get_applied_pose(bones_buf[i]);
+    std::cout << "[" << spine_bone_pose_get_a(pose) << "," << spine_bone_pose_get_b(pose) << ","
+              << spine_bone_pose_get_c(pose) << "," << spine_bone_pose_get_d(pose) << ","
+              << spine_bone_pose_get_world_x(pose) << "," << spine_bone_pose_get_world_y(pose) << "]";
+    if (i + 1 != nb) std::cout << ",";
+  }
+  spine_array_slot slots = spine_skeleton_get_slots(skeleton);
+  const size_t ns = spine_array_slot_size(slots);
+  spine_slot *slots_buf = spine_array_slot_buffer(slots);
+  std::cout << "],\"slots\":[";
+  for (size_t i = 0; i < ns; i++) {
+    spine_slot_pose sp = spine_slot_get_applied_pose(slots_buf[i]);
+    spine_color c = spine_slot_pose_get_color(sp);
+    spine_attachment att = spine_slot_pose_get_attachment(sp);
+    std::cout << "[" << spine_color_get_r(c) << "," << spine_color_get_g(c) << "," << spine_color_get_b(c) << ","
+              << spine_color_get_a(c) << ",";
+    if (att) {
+      std::cout << "\"" << json_escape(spine_attachment_get_name(att)) << "\"]";
+    } else {
+      std::cout << "null]";
+    }
+    if (i + 1 != ns) std::cout << ",";
+  }
+  std::cout << "]}";
+}
+
+// Runs the scenario `iterations` times (after `warmup` untimed runs) on fresh drawables created
+// from the already loaded skeleton data, and prints per-phase timings as a single JSON object.
+// `samplesNs` holds one entry per iteration so external tools can run their own statistics.
+static int run_bench(int argc, char **argv, spine_skeleton_data data, int iterations, int warmup, bool counters) {
+  BenchTimings timings;
+  PerfCounterGroup perf;
+  if (counters) {
+    if (perf_open(perf)) {
+      timings.perf = &perf;
+    } else {
+      std::cerr << "perf_event_open unavailable (check /proc/sys/kernel/perf_event_paranoid); counters disabled\n";
+    }
+  }
+  float total_time = 0.0f;
+  for (int iter = -warmup; iter < iterations; iter++) {
+    TraceZone iteration_zone("bench", iter < 0 ? "warmup" : "iteration");
+    spine_skeleton_drawable drawable = spine_skeleton_drawable_create(data);
+    if (!drawable) {
+      std::cerr << "spine_skeleton_drawable_create failed\n";
+      return 2;
+    }
+    ScenarioRun run = scenario_run_for(drawable);
+    run.bench = &timings;
+    spine_skeleton_setup_pose(run.skeleton);
+    for (int p = 0; p < BENCH_PHASE_COUNT; p++) timings.current[p] = 0;
+    timings.steps = 0;
+    timings.measuring = iter >= 0;
+    const int rc = run_scenario_commands(argc, argv, run, pose_option_arity, usage);
+    spine_skeleton_drawable_dispose(drawable);
+    if (rc != 0) return rc;
+    if (!heap_guard_after_scenario()) return 1;
+    total_time = run.total_time;
+    if (iter < 0) continue;
+    for (int p = 0; p < BENCH_PHASE_COUNT; p++) timings.samples[p].push_back(timings.current[p]);
   }
 
-  if (!out_result) {
-    std::cerr << "spine_skeleton_data_load_(json|binary) failed\n";
-    std::exit(2);
+  TraceZone serialize_zone("output", "serialize");
+  std::cout << "{\"mode\":\"bench\",\"runtime\":\"spine-cpp\",\"iterations\":" << iterations
+            << ",\"warmup\":" << warmup << ",\"steps\":" << timings.steps << ",\"time\":" << total_time
+            << ",\"phases\":{";
+  for (int p = 0; p < BENCH_PHASE_COUNT; p++) {
+    const std::vector<int64_t> &samples = timings.samples[p];
+    int64_t total = 0;
+    for (int64_t v : samples) total += v;
+    const double mean = samples.empty() ? 0.0 : (double)total / (double)samples.size();
+    if (p) std::cout << ",";
+    std::cout << "\"" << kBenchPhaseNames[p] << "\":{\"meanNs\":" << mean
+              << ",\"minNs\":" << percentile_ns(samples, 0.0) << ",\"p50Ns\":" << percentile_ns(samples, 0.5)
+              << ",\"p90Ns\":" << percentile_ns(samples, 0.9)
+              << ",\"perStepNs\":" << (timings.steps ? mean / (double)timings.steps : 0.0) << ",\"samplesNs\":[";
+    for (size_t j = 0; j < samples.size(); j++) {
+      if (j) std::cout << ",";
+      std::cout << samples[j];
+    }
+    std::cout << "]}";
   }
-  const char *err = spine_skeleton_data_result_get_error(out_result);
-  if (err && err[0]) {
-    std::cerr << "skeleton data error: " << err << "\n";
-    std::exit(2);
+  std::cout << "}";
+
+  // Counters are means over the measured iterations, per frame (step) and phase, in
+  // `kPerfCounterNames` order. Unavailable events read as 0 and are listed in `available`.
+  if (timings.perf) {
+    std::cout << ",\"counters\":{\"events\":[";
+    for (int k = 0; k < PERF_COUNTER_COUNT; k++) {
+      if (k) std::cout << ",";
+      std::cout << "\"" << kPerfCounterNames[k] << "\"";
+    }
+    std::cout << "],\"available\":[";
+    for (int k = 0; k < PERF_COUNTER_COUNT; k++) {
+      if (k) std::cout << ",";
+      std::cout << (perf.slot[k] >= 0 ? 1 : 0);
+    }
+    std::cout << "],\"frames\":[";
+    const size_t frames = timings.frame_counters.size() / BENCH_PHASE_COUNT;
+    const double inv = iterations > 0 ? 1.0 / (double)iterations : 0.0;
+    for (size_t f = 0; f < frames; f++) {
+      if (f) std::cout << ",";
+      std::cout << "{\"step\":" << f;
+      for (int p = 0; p < BENCH_PHASE_COUNT; p++) {
+        const PerfSample &sample = timings.frame_counters[f * BENCH_PHASE_COUNT + p];
+        std::cout << ",\"" << kBenchPhaseNames[p] << "\":[";
+        for (int k = 0; k < PERF_COUNTER_COUNT; k++) {
+          if (k) std::cout << ",";
+          std::cout << (double)sample.v[k] * inv;
+        }
+        std::cout << "]";
+      }
+      std::cout << "}";
+    }
+    std::cout << "]}";
+    perf_close(perf);
+  } else {
+    std::cout << ",\"counters\":null";
   }
-  spine_skeleton_data data = spine_skeleton_data_result_get_data(out_result);
-  if (!data) {
-    std::cerr << "missing skeleton data\n";
-    std::exit(2);
+  std::cout << "}\n";
+  return 0;
+}
+
+// `--mix-profile` state shared with the step hook. `depths[t]` counts the `mixingFrom` entries
+// behind track t's current entry (0 = no crossfade in progress).
+struct MixStep {
+  float time;
+  int entries;
+  int depth;  // sum of the per-track depths
+  std::vector<int> depths;
+  std::vector<int64_t> apply_ns;  // one per iteration
+};
+
+struct MixChain {
+  float time;
+  size_t step;
+  int track;
+  int depth;
+  int64_t apply_ns;
+  std::string chain;  // JSON array of animation names, newest entry first
+};
+
+struct MixProfile {
+  std::vector<MixStep> steps;
+  size_t step = 0;
+  bool first_iteration = true;
+  std::vector<MixChain> chains;
+};
+
+static void mix_profile_step(ScenarioRun &run, float dt) {
+  MixProfile &profile = *static_cast<MixProfile *>(run.step_context);
+  spine_animation_state_update(run.state, dt);
+
+  // The chain as `apply` is about to see it.
+  if (profile.first_iteration) {
+    MixStep step;
+    step.time = run.total_time;
+    step.entries = 0;
+    step.depth = 0;
+    spine_array_track_entry tracks = spine_animation_state_get_tracks(run.state);
+    const size_t nt = spine_array_track_entry_size(tracks);
+    spine_track_entry *tracks_buf = spine_array_track_entry_buffer(tracks);
+    for (size_t t = 0; t < nt; t++) {
+      int depth = 0;
+      std::string chain;
+      for (spine_track_entry e = tracks_buf[t]; e; e = spine_track_entry_get_mixing_from(e)) {
+        spine_animation anim = spine_track_entry_get_animation(e);
+        chain += chain.empty() ? "[" : ",";
+        chain += "\"" + json_escape(anim ? spine_animation_get_name(anim) : "<none>") + "\"";
+        step.entries += 1;
+        if (e != tracks_buf[t]) depth += 1;
+      }
+      step.depths.push_back(depth);
+      step.depth += depth;
+      if (depth > 0) {
+        MixChain c = {run.total_time, profile.steps.size(), (int)t, depth, 0, chain + "]"};
+        profile.chains.push_back(c);
+      }
+    }
+    profile.steps.push_back(step);
   }
-  return data;
+
+  const BenchClock::time_point t0 = BenchClock::now();
+  spine_animation_state_apply(run.state, run.skeleton);
+  const BenchClock::time_point t1 = BenchClock::now();
+  if (profile.step < profile.steps.size()) profile.steps[profile.step].apply_ns.push_back(elapsed_ns(t0, t1));
+  profile.step++;
+  if (g_trace) trace_complete("step", "apply", t0, t1, run.total_time);
+
+  spine_skeleton_update(run.skeleton, dt);
+  spine_skeleton_update_world_transform(run.skeleton, run.physics);
 }
 
-static bool ends_with(const char *s, const char *suffix) {
-  const size_t n = std::strlen(suffix);
-  const size_t m = std::strlen(s);
-  if (m < n) return false;
-  return std::strcmp(s + (m - n), suffix) == 0;
+// Runs the scenario `iterations` times with `mix_profile_step` and prints per-step samples, the
+// apply cost grouped by total mixing depth, and the deepest (then slowest) crossfade chains.
+static int run_mix_profile(int argc, char **argv, spine_skeleton_data data, int iterations) {
+  MixProfile profile;
+  float total_time = 0.0f;
+  for (int iter = 0; iter < iterations; iter++) {
+    TraceZone iteration_zone("mix-profile", "iteration");
+    spine_skeleton_drawable drawable = spine_skeleton_drawable_create(data);
+    if (!drawable) {
+      std::cerr << "spine_skeleton_drawable_create failed\n";
+      return 2;
+    }
+    ScenarioRun run = scenario_run_for(drawable);
+    run.step_hook = mix_profile_step;
+    run.step_context = &profile;
+    spine_skeleton_setup_pose(run.skeleton);
+    profile.step = 0;
+    const int rc = run_scenario_commands(argc, argv, run, pose_option_arity, usage);
+    spine_skeleton_drawable_dispose(drawable);
+    if (rc != 0) return rc;
+    if (!heap_guard_after_scenario()) return 1;
+    profile.first_iteration = false;
+    total_time = run.total_time;
+  }
+
+  TraceZone serialize_zone("output", "serialize");
+  std::vector<int64_t> step_ns(profile.steps.size());
+  int max_depth = 0;
+  for (size_t i = 0; i < profile.steps.size(); i++) {
+    step_ns[i] = percentile_ns(profile.steps[i].apply_ns, 0.5);
+    max_depth = std::max(max_depth, profile.steps[i].depth);
+  }
+
+  std::cout << "{\"mode\":\"mix-profile\",\"runtime\":\"spine-cpp\",\"iterations\":" << iterations
+            << ",\"steps\":" << profile.steps.size() << ",\"time\":" << total_time << ",\"samples\":[";
+  for (size_t i = 0; i < profile.steps.size(); i++) {
+    const MixStep &step = profile.steps[i];
+    if (i) std::cout << ",";
+    std::cout << "{\"time\":" << step.time << ",\"entries\":" << step.entries << ",\"depth\":" << step.depth
+              << ",\"trackDepths\":[";
+    for (size_t t = 0; t < step.depths.size(); t++) {
+      if (t) std::cout << ",";
+      std::cout << step.depths[t];
+    }
+    std::cout << "],\"applyNs\":" << step_ns[i] << "}";
+  }
+
+  // Apply cost per total mixing depth. `perEntryNs` divides by the mean active entry count, so a
+  // flat curve means apply scales linearly with stacked crossfades.
+  std::cout << "],\"costByDepth\":[";
+  bool first = true;
+  for (int depth = 0; depth <= max_depth; depth++) {
+    std::vector<int64_t> samples;
+    int64_t entries = 0;
+    for (size_t i = 0; i < profile.steps.size(); i++) {
+      if (profile.steps[i].depth != depth) continue;
+      samples.push_back(step_ns[i]);
+      entries += profile.steps[i].entries;
+    }
+    if (samples.empty()) continue;
+    int64_t total = 0;
+    for (int64_t v : samples) total += v;
+    const double mean = (double)total / (double)samples.size();
+    const double mean_entries = (double)entries / (double)samples.size();
+    if (!first) std::cout << ",";
+    first = false;
+    std::cout << "{\"depth\":" << depth << ",\"steps\":" << samples.size() << ",\"meanEntries\":" << mean_entries
+              << ",\"meanNs\":" << mean << ",\"p50Ns\":" << percentile_ns(samples, 0.5)
+              << ",\"p90Ns\":" << percentile_ns(samples, 0.9)
+              << ",\"perEntryNs\":" << (mean_entries > 0.0 ? mean / mean_entries : 0.0) << "}";
+  }
+
+  // Deepest chains first, then slowest apply; one entry per distinct (track, chain).
+  for (size_t i = 0; i < profile.chains.size(); i++) profile.chains[i].apply_ns = step_ns[profile.chains[i].step];
+  std::stable_sort(profile.chains.begin(), profile.chains.end(), [](const MixChain &a, const MixChain &b) {
+    return a.depth != b.depth ? a.depth > b.depth : a.apply_ns > b.apply_ns;
+  });
+  std::cout << "],\"worstChains\":[";
+  std::unordered_set<std::string> seen;
+  int emitted = 0;
+  for (size_t i = 0; i < profile.chains.size() && emitted < 10; i++) {
+    const MixChain &c = profile.chains[i];
+    if (!seen.insert(std::to_string(c.track) + c.chain).second) continue;
+    if (emitted) std::cout << ",";
+    emitted++;
+    std::cout << "{\"time\":" << c.time << ",\"track\":" << c.track << ",\"depth\":" << c.depth
+              << ",\"applyNs\":" << c.apply_ns << ",\"chain\":" << c.chain << "}";
+  }
+  std::cout << "]}\n";
+  return 0;
 }
 
 int main(int argc, char **argv) {
@@ -176,6 +775,19 @@ int main(int argc, char **argv) {
   spine_physics physics = SPINE_PHYSICS_NONE;
   const char *dump_slot_vertices = nullptr;
   bool dump_update_cache = false;
+  bool dump_all_slot_vertices = false;
+  bool update_cache_timing = false;
+  PhysicsSweep sweep;
+  int bench_iterations = 0;
+  int bench_warmup = 1;
+  bool bench_counters = false;
+  int mix_profile_iterations = 0;
+  const char *sweep_out = nullptr;
+  float sweep_hz = 30.0f;
+  spine_physics sweep_physics = SPINE_PHYSICS_NONE;
+  const char *trace_out = nullptr;
+  int64_t heap_limit = -1;
+  const char *heap_out = nullptr;
   const int arg_start = legacy_mode ? 5 : 3;
   for (int i = arg_start; i < argc; i++) {
     if (std::strcmp(argv[i], "--y-down") == 0 && i + 1 < argc) {
@@ -185,11 +797,7 @@ int main(int argc, char **argv) {
     }
     if (legacy_mode && std::strcmp(argv[i], "--physics") == 0 && i + 1 < argc) {
       const char *mode = argv[i + 1];
-      if (std::strcmp(mode, "none") == 0) physics = SPINE_PHYSICS_NONE;
-      else if (std::strcmp(mode, "reset") == 0) physics = SPINE_PHYSICS_RESET;
-      else if (std::strcmp(mode, "update") == 0) physics = SPINE_PHYSICS_UPDATE;
-      else if (std::strcmp(mode, "pose") == 0) physics = SPINE_PHYSICS_POSE;
-      else {
+      if (!parse_physics_mode(mode, physics)) {
         std::cerr << "invalid physics mode: " << mode << "\n";
         return 2;
       }
@@ -201,22 +809,163 @@ int main(int argc, char **argv) {
       i++;
       continue;
     }
+    if (legacy_mode && std::strcmp(argv[i], "--dump-all-slot-vertices") == 0) {
+      dump_all_slot_vertices = true;
+      continue;
+    }
     if (std::strcmp(argv[i], "--dump-update-cache") == 0) {
       dump_update_cache = true;
       continue;
     }
+    if (std::strcmp(argv[i], "--update-cache-timing") == 0) {
+      update_cache_timing = true;
+      continue;
+    }
+    if (std::strcmp(argv[i], "--trace-out") == 0 && i + 1 < argc) {
+      trace_out = argv[i + 1];
+      i++;
+      continue;
+    }
+    if (!legacy_mode && std::strcmp(argv[i], "--heap-guard") == 0 && i + 1 < argc) {
+      heap_limit = std::atoll(argv[i + 1]);
+      if (heap_limit < 0) {
+        std::cerr << "invalid --heap-guard bytes: " << argv[i + 1] << "\n";
+        return 2;
+      }
+      i++;
+      continue;
+    }
+    if (!legacy_mode && std::strcmp(argv[i], "--heap-out") == 0 && i + 1 < argc) {
+      heap_out = argv[i + 1];
+      i++;
+      continue;
+    }
+    if (!legacy_mode && is_sweep_option(argv[i]) && i + 1 < argc) {
+      std::vector<float> *axis = &sweep.wind_x;
+      if (std::strcmp(argv[i], "--sweep-wind-y") == 0) axis = &sweep.wind_y;
+      else if (std::strcmp(argv[i], "--sweep-gravity-x") == 0) axis = &sweep.gravity_x;
+      else if (std::strcmp(argv[i], "--sweep-gravity-y") == 0) axis = &sweep.gravity_y;
+      if (!parse_sweep_axis(argv[i + 1], *axis)) {
+        std::cerr << "invalid sweep axis: " << argv[i] << " " << argv[i + 1] << "\n";
+        return 2;
+      }
+      sweep.enabled = true;
+      i++;
+      continue;
+    }
+    if (!legacy_mode && std::strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+      bench_iterations = std::atoi(argv[i + 1]);
+      if (bench_iterations < 1) {
+        std::cerr << "invalid --bench iterations: " << argv[i + 1] << "\n";
+        return 2;
+      }
+      i++;
+      continue;
+    }
+    if (!legacy_mode && std::strcmp(argv[i], "--mix-profile") == 0 && i + 1 < argc) {
+      mix_profile_iterations = std::atoi(argv[i + 1]);
+      if (mix_profile_iterations < 1) {
+        std::cerr << "invalid --mix-profile iterations: " << argv[i + 1] << "\n";
+        return 2;
+      }
+      i++;
+      continue;
+    }
+    if (!legacy_mode && std::strcmp(argv[i], "--sweep") == 0 && i + 1 < argc) {
+      sweep_out = argv[i + 1];
+      i++;
+      continue;
+    }
+    if (!legacy_mode && std::strcmp(argv[i], "--sweep-hz") == 0 && i + 1 < argc) {
+      sweep_hz = std::strtof(argv[i + 1], nullptr);
+      i++;
+      continue;
+    }
+    // Only read by `--sweep`; in a command stream `--physics` stays positional.
+    if (!legacy_mode && std::strcmp(argv[i], "--physics") == 0 && i + 1 < argc) {
+      if (!parse_physics_mode(argv[i + 1], sweep_physics)) {
+        std::cerr << "invalid physics mode: " << argv[i + 1] << "\n";
+        return 2;
+      }
+      i++;
+      continue;
+    }
+    if (!legacy_mode && std::strcmp(argv[i], "--bench-counters") == 0) {
+      bench_counters = true;
+      continue;
+    }
+    if (!legacy_mode && std::strcmp(argv[i], "--bench-warmup") == 0 && i + 1 < argc) {
+      bench_warmup = std::max(0, std::atoi(argv[i + 1]));
+      i++;
+      continue;
+    }
+  }
+
+  TraceRecorder trace;
+  if (trace_out) {
+    trace.origin = BenchClock::now();
+    trace.main_tid = trace_thread_id();
+    g_trace = &trace;
+  }
+
+  const bool batch_mode = sweep_out || sweep.enabled || bench_iterations > 0 || mix_profile_iterations > 0;
+  if (heap_out && heap_limit < 0) heap_limit = std::numeric_limits<int64_t>::max();
+  if (heap_limit >= 0 && !batch_mode) {
+    std::cerr << "--heap-guard/--heap-out need a batch mode (--sweep, --sweep-*, --bench or --mix-profile)\n";
+    return 2;
+  }
+  if (heap_limit >= 0) heap_hook_install();
+  if (update_cache_timing && batch_mode) {
+    std::cerr << "--update-cache-timing applies to a single legacy or scenario run, not a batch mode\n";
+    return 2;
   }
 
   spine_bone_set_y_down(y_down ? true : false);
 
   spine_atlas_result atlas_result = nullptr;
-  spine_atlas atlas = load_atlas_or_die(atlas_path, atlas_result);
+  spine_atlas atlas = nullptr;
+  {
+    TraceZone zone("load", "atlas");
+    atlas = load_atlas_or_die(atlas_path, atlas_result);
+  }
 
   spine_skeleton_data_result data_result = nullptr;
-  spine_skeleton_data data = load_skeleton_data_or_die(atlas, skeleton_path, data_result);
+  spine_skeleton_data data = nullptr;
+  {
+    TraceZone zone("load", "skeleton");
+    data = load_skeleton_data_or_die(atlas, skeleton_path, data_result);
+  }
 
   spine_bone_set_y_down(y_down ? true : false);
 
+  if (batch_mode) {
+    HeapGuard heap;
+    heap.limit = heap_limit;
+    const char *batch = sweep_out                    ? "sweep"
+                        : sweep.enabled              ? "physics-sweep"
+                        : mix_profile_iterations > 0 ? "mix-profile"
+                                                     : "bench";
+    if (heap_limit >= 0) heap_guard_begin(heap, batch);
+    const int rc = sweep_out                    ? run_animation_skin_sweep(data, sweep_out, sweep_hz, sweep_physics,
+                                                                           write_sweep_pose, nullptr)
+                   : sweep.enabled              ? run_physics_sweep(argc, argv, data, sweep)
+                   : mix_profile_iterations > 0 ? run_mix_profile(argc, argv, data, mix_profile_iterations)
+                                                : run_bench(argc, argv, data, bench_iterations, bench_warmup, bench_counters);
+    g_heap_guard = nullptr;
+    if (heap_out && !write_heap_report(heap, heap_out, "spine_cpp_lite_oracle")) {
+      std::cerr << "failed to write heap report: " << heap_out << "\n";
+      return 2;
+    }
+    spine_skeleton_data_result_dispose(data_result);
+    spine_atlas_dispose(atlas);
+    spine_atlas_result_dispose(atlas_result);
+    if (rc == 0 && trace_out && !write_trace(trace, trace_out, "spine_cpp_lite_oracle")) {
+      std::cerr << "failed to write trace: " << trace_out << "\n";
+      return 2;
+    }
+    return rc;
+  }
+
   spine_skeleton_drawable drawable = spine_skeleton_drawable_create(data);
   if (!drawable) {
     std::cerr << "spine_skeleton_drawable_create failed\n";
@@ -231,10 +980,12 @@ int main(int argc, char **argv) {
   }
 
   float total_time = 0.0f;
-  spine_track_entry last_entry = nullptr;
 
   spine_skeleton_setup_pose(skeleton);
 
+  UpdateCacheTiming timing;
+  if (update_cache_timing && !update_cache_timing_begin(timing)) return 2;
+
   if (legacy_mode) {
     spine_animation_state_set_animation_1(state, 0, animation, true);
     spine_animation_state_update(state, time);
@@ -243,229 +994,25 @@ int main(int argc, char **argv) {
     spine_skeleton_update_world_transform(skeleton, physics);
     total_time = time;
   } else {
-    for (int i = 3; i < argc; i++) {
-      const char *arg = argv[i];
-
-      if (std::strcmp(arg, "--y-down") == 0) {
-        i++;  // already processed above
-        continue;
-      }
-
-      if (std::strcmp(arg, "--set-skin") == 0 && i + 1 < argc) {
-        const char *name = argv[i + 1];
-        if (std::strcmp(name, "none") == 0) spine_skeleton_set_skin_2(skeleton, nullptr);
-        else spine_skeleton_set_skin_1(skeleton, name);
-        spine_skeleton_update_cache(skeleton);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--mix") == 0 && i + 3 < argc) {
-        const char *from_name = argv[i + 1];
-        const char *to_name = argv[i + 2];
-        const float duration = std::strtof(argv[i + 3], nullptr);
-        spine_animation_state_data_set_mix_1(state_data, from_name, to_name, duration);
-        i += 3;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--physics") == 0 && i + 1 < argc) {
-        const char *mode = argv[i + 1];
-        if (std::strcmp(mode, "none") == 0) physics = SPINE_PHYSICS_NONE;
-        else if (std::strcmp(mode, "reset") == 0) physics = SPINE_PHYSICS_RESET;
-        else if (std::strcmp(mode, "update") == 0) physics = SPINE_PHYSICS_UPDATE;
-        else if (std::strcmp(mode, "pose") == 0) physics = SPINE_PHYSICS_POSE;
-        else {
-          std::cerr << "invalid physics mode: " << mode << "\n";
-          return 2;
-        }
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--dump-slot-vertices") == 0 && i + 1 < argc) {
-        dump_slot_vertices = argv[i + 1];
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--dump-update-cache") == 0) {
-        dump_update_cache = true;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--set") == 0 && i + 3 < argc) {
-        const size_t track = (size_t)std::atoi(argv[i + 1]);
-        const char *name = argv[i + 2];
-        const bool loop = std::atoi(argv[i + 3]) ? true : false;
-        last_entry = spine_animation_state_set_animation_1(state, track, name, loop);
-        i += 3;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--add") == 0 && i + 4 < argc) {
-        const size_t track = (size_t)std::atoi(argv[i + 1]);
-        const char *name = argv[i + 2];
-        const bool loop = std::atoi(argv[i + 3]) ? true : false;
-        const float delay = std::strtof(argv[i + 4], nullptr);
-        last_entry = spine_animation_state_add_animation_1(state, track, name, loop, delay);
-        i += 4;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--set-empty") == 0 && i + 2 < argc) {
-        const size_t track = (size_t)std::atoi(argv[i + 1]);
-        const float mix_duration = std::strtof(argv[i + 2], nullptr);
-        last_entry = spine_animation_state_set_empty_animation(state, track, mix_duration);
-        i += 2;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--add-empty") == 0 && i + 3 < argc) {
-        const size_t track = (size_t)std::atoi(argv[i + 1]);
-        const float mix_duration = std::strtof(argv[i + 2], nullptr);
-        const float delay = std::strtof(argv[i + 3], nullptr);
-        last_entry = spine_animation_state_add_empty_animation(state, track, mix_duration, delay);
-        i += 3;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-alpha") == 0 && i + 1 < argc) {
-        if (!last_entry) {
-          std::cerr << "--entry-alpha requires a preceding --set/--add command\n";
-          return 2;
-        }
-        const float alpha = std::strtof(argv[i + 1], nullptr);
-        spine_track_entry_set_alpha(last_entry, alpha);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-event-threshold") == 0 && i + 1 < argc) {
-        if (!last_entry) {
-          std::cerr << "--entry-event-threshold requires a preceding --set/--add command\n";
-          return 2;
-        }
-        const float threshold = std::strtof(argv[i + 1], nullptr);
-        spine_track_entry_set_event_threshold(last_entry, threshold);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-alpha-attachment-threshold") == 0 && i + 1 < argc) {
-        if (!last_entry) {
-          std::cerr << "--entry-alpha-attachment-threshold requires a preceding --set/--add command\n";
-          return 2;
-        }
-        const float threshold = std::strtof(argv[i + 1], nullptr);
-        spine_track_entry_set_alpha_attachment_threshold(last_entry, threshold);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-mix-attachment-threshold") == 0 && i + 1 < argc) {
-        if (!last_entry) {
-          std::cerr << "--entry-mix-attachment-threshold requires a preceding --set/--add command\n";
-          return 2;
-        }
-        const float threshold = std::strtof(argv[i + 1], nullptr);
-        spine_track_entry_set_mix_attachment_threshold(last_entry, threshold);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-mix-draw-order-threshold") == 0 && i + 1 < argc) {
-        if (!last_entry) {
-          std::cerr << "--entry-mix-draw-order-threshold requires a preceding --set/--add command\n";
-          return 2;
-        }
-        const float threshold = std::strtof(argv[i + 1], nullptr);
-        spine_track_entry_set_mix_draw_order_threshold(last_entry, threshold);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-hold-previous") == 0 && i + 1 < argc) {
-        if (!last_entry) {
-          std::cerr << "--entry-hold-previous requires a preceding --set/--add command\n";
-          return 2;
-        }
-        const bool hold = std::atoi(argv[i + 1]) ? true : false;
-        spine_track_entry_set_hold_previous(last_entry, hold);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-mix-blend") == 0 && i + 1 < argc) {
-        if (!last_entry) {
-          std::cerr << "--entry-mix-blend requires a preceding --set/--add command\n";
-          return 2;
-        }
-        const char *blend = argv[i + 1];
-        spine_mix_blend mix_blend = SPINE_MIX_BLEND_REPLACE;
-        if (std::strcmp(blend, "setup") == 0) mix_blend = SPINE_MIX_BLEND_SETUP;
-        else if (std::strcmp(blend, "first") == 0) mix_blend = SPINE_MIX_BLEND_FIRST;
-        else if (std::strcmp(blend, "replace") == 0) mix_blend = SPINE_MIX_BLEND_REPLACE;
-        else if (std::strcmp(blend, "add") == 0) mix_blend = SPINE_MIX_BLEND_ADD;
-        else {
-          std::cerr << "invalid mix blend: " << blend << "\n";
-          return 2;
-        }
-        spine_track_entry_set_mix_blend(last_entry, mix_blend);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-reverse") == 0 && i + 1 < argc) {
-        if (!last_entry) {
-          std::cerr << "--entry-reverse requires a preceding --set/--add command\n";
-          return 2;
-        }
-        const bool reverse = std::atoi(argv[i + 1]) ? true : false;
-        spine_track_entry_set_reverse(last_entry, reverse);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-shortest-rotation") == 0 && i + 1 < argc) {
-        if (!last_entry) {
-          std::cerr << "--entry-shortest-rotation requires a preceding --set/--add command\n";
-          return 2;
-        }
-        const bool shortest = std::atoi(argv[i + 1]) ? true : false;
-        spine_track_entry_set_shortest_rotation(last_entry, shortest);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-reset-rotation-directions") == 0) {
-        if (!last_entry) {
-          std::cerr << "--entry-reset-rotation-directions requires a preceding --set/--add command\n";
-          return 2;
-        }
-        spine_track_entry_reset_rotation_directions(last_entry);
-        continue;
-      }
-
-      if (std::strcmp(arg, "--step") == 0 && i + 1 < argc) {
-        const float dt = std::strtof(argv[i + 1], nullptr);
-        spine_animation_state_update(state, dt);
-        spine_animation_state_apply(state, skeleton);
-        spine_skeleton_update(skeleton, dt);
-        spine_skeleton_update_world_transform(skeleton, physics);
-        total_time += dt;
-        i += 1;
-        continue;
-      }
-
-      std::cerr << "unknown/invalid command: " << arg << "\n";
-      usage();
-      return 2;
-    }
+    ScenarioRun run = scenario_run_for(drawable);
+    run.physics = physics;
+    run.dump_slot_vertices = dump_slot_vertices;
+    run.dump_update_cache = dump_update_cache;
+    TraceZone zone("scenario", "commands");
+    const int rc = run_scenario_commands(argc, argv, run, pose_option_arity, usage);
+    if (rc != 0) return rc;
+    physics = run.physics;
+    total_time = run.total_time;
+    dump_slot_vertices = run.dump_slot_vertices;
+    dump_update_cache = run.dump_update_cache;
+    dump_all_slot_vertices = run.dump_all_slot_vertices;
 
     animation = "<scenario>";
     time = total_time;
   }
+  update_cache_timing_end();
+
+  const BenchClock::time_point serialize_start = g_trace ? BenchClock::now() : BenchClock::time_point();
 
   // Bones.
   spine_array_bone bones = spine_skeleton_get_bones(skeleton);
@@ -683,7 +1230,8 @@ int main(int argc, char **argv) {
   }
 
   std::cout << "]";
-  if ((dump_slot_vertices && dump_slot_vertices[0]) || dump_update_cache) {
+  if ((dump_slot_vertices && dump_slot_vertices[0]) || dump_update_cache || dump_all_slot_vertices ||
+      update_cache_timing) {
     std::cout << ",\"debug\":{";
     bool first_debug = true;
 
@@ -731,49 +1279,40 @@ int main(int argc, char **argv) {
       if (!first_debug) std::cout << ",";
       first_debug = false;
 
-      std::unordered_map<const void *, std::string> update_names;
-      update_names.reserve(nb + nc + 8);
-      for (size_t i = 0; i < nb; i++) {
-        spine_bone bone = bones_buf[i];
-        spine_bone_data bd = spine_bone_get_data(bone);
-        const char *name = bd ? spine_bone_data_get_name(bd) : "<unknown>";
-        spine_bone_pose pose = spine_bone_get_applied_pose(bone);
-        const spine_update u = spine_bone_pose_cast_to_update(pose);
-        update_names[(const void *)u] = std::string("bone ") + name;
-      }
-      for (size_t i = 0; i < nc; i++) {
-        spine_constraint cst = constraints_buf[i];
-        spine_constraint_data cd = spine_constraint_get_data(cst);
-        const char *name = cd ? spine_constraint_data_get_name(cd) : "<unknown>";
-        const spine_rtti rt = spine_constraint_get_rtti(cst);
-        std::string prefix = "constraint ";
-        if (spine_rtti_instance_of(rt, spine_ik_constraint_rtti())) prefix = "ik ";
-        else if (spine_rtti_instance_of(rt, spine_transform_constraint_rtti())) prefix = "transform ";
-        else if (spine_rtti_instance_of(rt, spine_path_constraint_rtti())) prefix = "path ";
-        else if (spine_rtti_instance_of(rt, spine_physics_constraint_rtti())) prefix = "physics ";
-        else if (spine_rtti_instance_of(rt, spine_slider_rtti())) prefix = "slider ";
-        const spine_update u = spine_constraint_cast_to_update(cst);
-        update_names[(const void *)u] = prefix + name;
-      }
-
+      const std::unordered_map<const void *, std::string> update_names = update_cache_labels(skeleton);
       std::cout << "\"updateCache\":[";
       for (size_t i = 0; i < nuc; i++) {
-        const void *u = (const void *)update_cache_buf[i];
-        auto it = update_names.find(u);
-        const std::string label = (it == update_names.end()) ? std::string("<unknown>") : it->second;
+        const std::string label = update_cache_label(update_names, (const void *)update_cache_buf[i]);
         std::cout << "\"" << json_escape(label.c_str()) << "\"";
         if (i + 1 != nuc) std::cout << ",";
       }
       std::cout << "]";
     }
 
+    if (dump_all_slot_vertices) {
+      if (!first_debug) std::cout << ",";
+      first_debug = false;
+      print_all_slot_vertices(skeleton);
+    }
+
+    if (update_cache_timing) {
+      if (!first_debug) std::cout << ",";
+      first_debug = false;
+      print_update_cache_timing(skeleton, timing);
+    }
+
     std::cout << "}";
   }
   std::cout << "}\n";
+  trace_complete("output", "serialize", serialize_start, BenchClock::now());
 
   spine_skeleton_drawable_dispose(drawable);
   spine_skeleton_data_result_dispose(data_result);
   spine_atlas_dispose(atlas);
   spine_atlas_result_dispose(atlas_result);
+  if (trace_out && !write_trace(trace, trace_out, "spine_cpp_lite_oracle")) {
+    std::cerr << "failed to write trace: " << trace_out << "\n";
+    return 2;
+  }
   return 0;
 }
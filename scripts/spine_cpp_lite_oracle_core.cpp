@@ -0,0 +1,924 @@
+#include "spine_cpp_lite_oracle_core.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+// PhysicsConstraint runtime state fields are private in spine-cpp; widened (as in the pose oracle)
+// so `--check-invariants` can scan the simulation state.
+#define private public
+#include <spine/PhysicsConstraint.h>
+#undef private
+
+#include <spine/Extension.h>
+
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+std::string read_file(const char *path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    std::cerr << "failed to open: " << path << "\n";
+    std::exit(2);
+  }
+  std::ostringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+std::string json_escape(const char *s) {
+  if (!s) return "";
+  std::string out;
+  for (const char *p = s; *p; p++) {
+    const unsigned char c = static_cast<unsigned char>(*p);
+    if (c == '\\') out += "\\\\";
+    else if (c == '\"') out += "\\\"";
+    else if (c == '\n') out += "\\n";
+    else if (c == '\r') out += "\\r";
+    else if (c == '\t') out += "\\t";
+    else out += static_cast<char>(c);
+  }
+  return out;
+}
+
+bool ends_with(const char *s, const char *suffix) {
+  const size_t n = std::strlen(suffix);
+  const size_t m = std::strlen(s);
+  if (m < n) return false;
+  return std::strcmp(s + (m - n), suffix) == 0;
+}
+
+spine_atlas load_atlas_or_die(const char *atlas_path, spine_atlas_result &out_result) {
+  std::string atlas_text = read_file(atlas_path);
+  out_result = spine_atlas_load(atlas_text.c_str());
+  if (!out_result) {
+    std::cerr << "spine_atlas_load failed\n";
+    std::exit(2);
+  }
+  const char *err = spine_atlas_result_get_error(out_result);
+  if (err && err[0]) {
+    std::cerr << "atlas error: " << err << "\n";
+    std::exit(2);
+  }
+  spine_atlas atlas = spine_atlas_result_get_atlas(out_result);
+  if (!atlas) {
+    std::cerr << "missing atlas\n";
+    std::exit(2);
+  }
+  return atlas;
+}
+
+spine_skeleton_data load_skeleton_data_or_die(
+    spine_atlas atlas,
+    const char *skeleton_path,
+    spine_skeleton_data_result &out_result) {
+  out_result = nullptr;
+  const std::string path_s(skeleton_path);
+  if (path_s.size() >= 5 && path_s.compare(path_s.size() - 5, 5, ".skel") == 0) {
+    std::string bytes = read_file(skeleton_path);
+    out_result = spine_skeleton_data_load_binary(
+        atlas, reinterpret_cast<const uint8_t *>(bytes.data()), (int32_t)bytes.size(), skeleton_path);
+  } else {
+    std::string json_text = read_file(skeleton_path);
+    out_result = spine_skeleton_data_load_json(atlas, json_text.c_str(), skeleton_path);
+  }
+
+  if (!out_result) {
+    std::cerr << "spine_skeleton_data_load_(json|binary) failed\n";
+    std::exit(2);
+  }
+  const char *err = spine_skeleton_data_result_get_error(out_result);
+  if (err && err[0]) {
+    std::cerr << "skeleton data error: " << err << "\n";
+    std::exit(2);
+  }
+  spine_skeleton_data data = spine_skeleton_data_result_get_data(out_result);
+  if (!data) {
+    std::cerr << "missing skeleton data\n";
+    std::exit(2);
+  }
+  return data;
+}
+
+bool parse_physics_mode(const char *mode, spine_physics &out) {
+  if (std::strcmp(mode, "none") == 0) out = SPINE_PHYSICS_NONE;
+  else if (std::strcmp(mode, "reset") == 0) out = SPINE_PHYSICS_RESET;
+  else if (std::strcmp(mode, "update") == 0) out = SPINE_PHYSICS_UPDATE;
+  else if (std::strcmp(mode, "pose") == 0) out = SPINE_PHYSICS_POSE;
+  else return false;
+  return true;
+}
+
+const char *physics_name(spine_physics physics) {
+  switch (physics) {
+    case SPINE_PHYSICS_NONE: return "none";
+    case SPINE_PHYSICS_RESET: return "reset";
+    case SPINE_PHYSICS_UPDATE: return "update";
+    case SPINE_PHYSICS_POSE: return "pose";
+    default: return "unknown";
+  }
+}
+
+int64_t elapsed_ns(BenchClock::time_point from, BenchClock::time_point to) {
+  return (int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+}
+
+int64_t percentile_ns(std::vector<int64_t> samples, double q) {
+  if (samples.empty()) return 0;
+  std::sort(samples.begin(), samples.end());
+  const size_t idx = (size_t)(q * (double)(samples.size() - 1) + 0.5);
+  return samples[std::min(idx, samples.size() - 1)];
+}
+
+const char *const kBenchPhaseNames[BENCH_PHASE_COUNT] = {"update", "apply", "world", "render"};
+
+const char *const kPerfCounterNames[PERF_COUNTER_COUNT] = {
+    "cycles", "instructions", "l1dMisses", "llcMisses", "branchMisses"};
+
+#if defined(__linux__)
+static int perf_open_event(uint32_t type, uint64_t config, int group_fd) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = group_fd == -1 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  return (int)syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+bool perf_open(PerfCounterGroup &g) {
+  const uint32_t types[PERF_COUNTER_COUNT] = {
+      PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE};
+  const uint64_t configs[PERF_COUNTER_COUNT] = {
+      PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+      PERF_COUNT_HW_CACHE_MISSES,
+      PERF_COUNT_HW_BRANCH_MISSES,
+  };
+  for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+    const int fd = perf_open_event(types[c], configs[c], g.leader);
+    if (fd < 0) continue;
+    if (g.leader == -1) g.leader = fd;
+    g.fds[c] = fd;
+    g.slot[c] = g.members++;
+  }
+  if (g.leader == -1) return false;
+  ioctl(g.leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(g.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return true;
+}
+
+void perf_read(const PerfCounterGroup &g, PerfSample &out) {
+  uint64_t buf[1 + PERF_COUNTER_COUNT] = {};
+  if (read(g.leader, buf, sizeof(buf)) < 0) buf[0] = 0;
+  for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+    out.v[c] = (g.slot[c] >= 0 && (uint64_t)g.slot[c] < buf[0]) ? buf[1 + g.slot[c]] : 0;
+  }
+}
+
+void perf_close(PerfCounterGroup &g) {
+  for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+    if (g.fds[c] >= 0) close(g.fds[c]);
+    g.fds[c] = -1;
+  }
+  g.leader = -1;
+}
+#else
+bool perf_open(PerfCounterGroup &) { return false; }
+void perf_read(const PerfCounterGroup &, PerfSample &out) { std::memset(&out, 0, sizeof(out)); }
+void perf_close(PerfCounterGroup &) {}
+#endif
+
+TraceRecorder *g_trace = nullptr;
+
+uint64_t trace_thread_id() {
+#if defined(__linux__)
+  static thread_local uint64_t tid = (uint64_t)syscall(SYS_gettid);
+#else
+  static thread_local uint64_t tid = (uint64_t)std::hash<std::thread::id>()(std::this_thread::get_id());
+#endif
+  return tid;
+}
+
+void trace_complete(const char *cat, const char *name, BenchClock::time_point from, BenchClock::time_point to,
+                    float time) {
+  if (!g_trace) return;
+  const TraceEvent e = {cat, name, elapsed_ns(g_trace->origin, from), elapsed_ns(from, to), trace_thread_id(), time};
+  std::lock_guard<std::mutex> lock(g_trace->mutex);
+  g_trace->events.push_back(e);
+}
+
+bool write_trace(const TraceRecorder &trace, const char *path, const char *process_name) {
+  std::ofstream out(path, std::ios::binary);
+  if (!out) return false;
+#if defined(__linux__)
+  const long pid = (long)getpid();
+#else
+  const long pid = 1;
+#endif
+  out << std::fixed << std::setprecision(3);
+  out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+      << ",\"tid\":" << trace.main_tid << ",\"args\":{\"name\":\"" << json_escape(process_name) << "\"}}";
+  out << ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << trace.main_tid
+      << ",\"args\":{\"name\":\"main\"}}";
+  for (const TraceEvent &e : trace.events) {
+    out << ",\n{\"name\":\"" << e.name << "\",\"cat\":\"" << e.cat << "\",\"ph\":\"X\",\"ts\":"
+        << (double)e.ts_ns / 1000.0 << ",\"dur\":" << (double)e.dur_ns / 1000.0 << ",\"pid\":" << pid
+        << ",\"tid\":" << e.tid;
+    if (e.time >= 0.0f) out << ",\"args\":{\"time\":" << e.time << "}";
+    out << "}";
+  }
+  out << "]}\n";
+  return (bool)out;
+}
+
+// Live bytes are the allocator's usable size of each block, so frees need no side table.
+static size_t heap_block_size(void *p) {
+  if (!p) return 0;
+#if defined(__APPLE__)
+  return malloc_size(p);
+#else
+  return malloc_usable_size(p);
+#endif
+}
+
+static std::atomic<int64_t> g_heap_live(0);
+static std::atomic<int64_t> g_heap_peak(0);
+static std::atomic<uint64_t> g_heap_allocs(0);
+
+static void heap_account(int64_t delta) {
+  const int64_t live = g_heap_live.fetch_add(delta) + delta;
+  int64_t peak = g_heap_peak.load();
+  while (live > peak && !g_heap_peak.compare_exchange_weak(peak, live)) {
+  }
+}
+
+// Same allocation calls as spine-cpp's DefaultSpineExtension; file reads are forwarded to the
+// extension that was active before.
+class CountingSpineExtension : public spine::SpineExtension {
+ public:
+  explicit CountingSpineExtension(spine::SpineExtension *inner) : _inner(inner) {}
+
+  void *_alloc(size_t size, const char *, int) override {
+    void *p = std::malloc(size);
+    g_heap_allocs++;
+    heap_account((int64_t)heap_block_size(p));
+    return p;
+  }
+
+  void *_calloc(size_t size, const char *, int) override {
+    void *p = std::calloc(1, size);
+    g_heap_allocs++;
+    heap_account((int64_t)heap_block_size(p));
+    return p;
+  }
+
+  void *_realloc(void *ptr, size_t size, const char *, int) override {
+    const int64_t before = (int64_t)heap_block_size(ptr);
+    void *p = std::realloc(ptr, size);
+    if (!p && size != 0) return p;  // failed; `ptr` is untouched
+    if (!ptr) g_heap_allocs++;
+    heap_account((int64_t)heap_block_size(p) - before);
+    return p;
+  }
+
+  void _free(void *mem, const char *, int) override {
+    heap_account(-(int64_t)heap_block_size(mem));
+    std::free(mem);
+  }
+
+  char *_readFile(const spine::String &path, int *length) override { return _inner->_readFile(path, length); }
+
+ private:
+  spine::SpineExtension *_inner;
+};
+
+HeapGuard *g_heap_guard = nullptr;
+
+void heap_hook_install() {
+  static CountingSpineExtension extension(spine::SpineExtension::getInstance());
+  spine::SpineExtension::setInstance(&extension);
+}
+
+int64_t heap_live_bytes() { return g_heap_live.load(); }
+
+uint64_t heap_alloc_count() { return g_heap_allocs.load(); }
+
+void heap_guard_begin(HeapGuard &guard, const char *batch) {
+  guard.batch = batch;
+  guard.baseline = heap_live_bytes();
+  g_heap_peak.store(guard.baseline);
+  g_heap_guard = &guard;
+}
+
+bool heap_guard_after_scenario() {
+  if (!g_heap_guard) return true;
+  HeapGuard &guard = *g_heap_guard;
+  const int64_t live = heap_live_bytes();
+  const int64_t retained = live - guard.baseline;
+  guard.retained.push_back(retained);
+  guard.peak.push_back(g_heap_peak.exchange(live) - guard.baseline);
+  if (retained <= guard.limit) return true;
+  std::cerr << "heap guard: " << guard.batch << " scenario " << guard.retained.size() - 1 << " retained " << retained
+            << " bytes over the post-load baseline (limit " << guard.limit << ")\n";
+  return false;
+}
+
+bool write_heap_report(const HeapGuard &guard, const char *path, const char *tool) {
+  std::ofstream out(path, std::ios::binary);
+  if (!out) return false;
+  int64_t max_retained = 0;
+  int64_t max_peak = 0;
+  for (size_t i = 0; i < guard.retained.size(); i++) {
+    max_retained = std::max(max_retained, guard.retained[i]);
+    max_peak = std::max(max_peak, guard.peak[i]);
+  }
+  const int64_t growth = guard.retained.empty() ? 0 : guard.retained.back() - guard.retained.front();
+  out << "{\"mode\":\"heap-guard\",\"tool\":\"" << json_escape(tool) << "\",\"batch\":\"" << json_escape(guard.batch)
+      << "\",\"baselineBytes\":" << guard.baseline << ",\"limitBytes\":" << guard.limit
+      << ",\"scenarios\":" << guard.retained.size() << ",\"maxRetainedBytes\":" << max_retained
+      << ",\"maxPeakBytes\":" << max_peak << ",\"growthBytes\":" << growth << ",\"allocs\":" << heap_alloc_count()
+      << ",\"ok\":" << (max_retained <= guard.limit ? "true" : "false") << ",\"retainedBytes\":[";
+  for (size_t i = 0; i < guard.retained.size(); i++) out << (i ? "," : "") << guard.retained[i];
+  out << "],\"peakBytes\":[";
+  for (size_t i = 0; i < guard.peak.size(); i++) out << (i ? "," : "") << guard.peak[i];
+  out << "]}\n";
+  return (bool)out;
+}
+
+// Same pipeline as `--step`, plus a render pass (spine-cpp SkeletonRenderer) so the timings line
+// up with the Rust `build_draw_list` phase.
+static void run_timed_step(ScenarioRun &run, float dt) {
+  BenchTimings &bench = *run.bench;
+  PerfSample c[BENCH_PHASE_COUNT + 1];
+  if (bench.perf) perf_read(*bench.perf, c[0]);
+  const BenchClock::time_point t0 = BenchClock::now();
+  spine_animation_state_update(run.state, dt);
+  const BenchClock::time_point t1 = BenchClock::now();
+  if (bench.perf) perf_read(*bench.perf, c[1]);
+  spine_animation_state_apply(run.state, run.skeleton);
+  const BenchClock::time_point t2 = BenchClock::now();
+  if (bench.perf) perf_read(*bench.perf, c[2]);
+  spine_skeleton_update(run.skeleton, dt);
+  spine_skeleton_update_world_transform(run.skeleton, run.physics);
+  const BenchClock::time_point t3 = BenchClock::now();
+  if (bench.perf) perf_read(*bench.perf, c[3]);
+  spine_skeleton_drawable_render(run.drawable);
+  const BenchClock::time_point t4 = BenchClock::now();
+  if (bench.perf) perf_read(*bench.perf, c[4]);
+
+  if (g_trace) {
+    trace_complete("step", "step", t0, t4, run.total_time);
+    trace_complete("step", "update", t0, t1, run.total_time);
+    trace_complete("step", "apply", t1, t2, run.total_time);
+    trace_complete("step", "world", t2, t3, run.total_time);
+    trace_complete("step", "render", t3, t4, run.total_time);
+  }
+
+  bench.current[BENCH_UPDATE] += elapsed_ns(t0, t1);
+  bench.current[BENCH_APPLY] += elapsed_ns(t1, t2);
+  bench.current[BENCH_WORLD] += elapsed_ns(t2, t3);
+  bench.current[BENCH_RENDER] += elapsed_ns(t3, t4);
+
+  if (bench.perf && bench.measuring) {
+    const size_t base = (size_t)bench.steps * BENCH_PHASE_COUNT;
+    if (bench.frame_counters.size() < base + BENCH_PHASE_COUNT) {
+      PerfSample zero;
+      std::memset(&zero, 0, sizeof(zero));
+      bench.frame_counters.resize(base + BENCH_PHASE_COUNT, zero);
+    }
+    for (int p = 0; p < BENCH_PHASE_COUNT; p++) {
+      for (int k = 0; k < PERF_COUNTER_COUNT; k++) {
+        bench.frame_counters[base + p].v[k] += c[p + 1].v[k] - c[p].v[k];
+      }
+    }
+  }
+  bench.steps++;
+}
+
+// Plain `--step` with `--trace-out`: same pipeline, with each phase recorded as a trace zone.
+static void run_traced_step(ScenarioRun &run, float dt) {
+  const BenchClock::time_point t0 = BenchClock::now();
+  spine_animation_state_update(run.state, dt);
+  const BenchClock::time_point t1 = BenchClock::now();
+  spine_animation_state_apply(run.state, run.skeleton);
+  const BenchClock::time_point t2 = BenchClock::now();
+  spine_skeleton_update(run.skeleton, dt);
+  spine_skeleton_update_world_transform(run.skeleton, run.physics);
+  const BenchClock::time_point t3 = BenchClock::now();
+  trace_complete("step", "step", t0, t3, run.total_time);
+  trace_complete("step", "update", t0, t1, run.total_time);
+  trace_complete("step", "apply", t1, t2, run.total_time);
+  trace_complete("step", "world", t2, t3, run.total_time);
+}
+
+int run_animation_skin_sweep(spine_skeleton_data data, const char *out_path, float hz, spine_physics physics,
+                             SweepFrameWriter write_frame, void *context) {
+  if (!(hz > 0.0f)) {
+    std::cerr << "--sweep-hz must be > 0\n";
+    return 2;
+  }
+  std::ofstream out(out_path, std::ios::binary);
+  if (!out) {
+    std::cerr << "failed to open sweep output: " << out_path << "\n";
+    return 2;
+  }
+
+  spine_array_animation animations = spine_skeleton_data_get_animations(data);
+  const size_t na = spine_array_animation_size(animations);
+  spine_animation *animations_buf = spine_array_animation_buffer(animations);
+  std::vector<const char *> skins;
+  {
+    spine_array_skin skin_array = spine_skeleton_data_get_skins(data);
+    const size_t n = spine_array_skin_size(skin_array);
+    spine_skin *buf = spine_array_skin_buffer(skin_array);
+    for (size_t i = 0; i < n; i++) skins.push_back(spine_skin_get_name(buf[i]));
+  }
+  if (skins.empty()) skins.push_back(nullptr);
+
+  struct Combination {
+    const char *animation;
+    const char *skin;
+    float duration;
+    int64_t offset;
+    int frames;
+  };
+  std::vector<Combination> index;
+  const float dt = 1.0f / hz;
+
+  std::streambuf *stdout_buf = std::cout.rdbuf(out.rdbuf());
+  for (size_t a = 0; a < na; a++) {
+    const char *animation = spine_animation_get_name(animations_buf[a]);
+    const float duration = spine_animation_get_duration(animations_buf[a]);
+    const int frames = static_cast<int>(duration * hz + 1e-3f) + 1;
+    for (size_t k = 0; k < skins.size(); k++) {
+      TraceZone zone("sweep", "combination");
+      spine_skeleton_drawable drawable = spine_skeleton_drawable_create(data);
+      if (!drawable) {
+        std::cout.rdbuf(stdout_buf);
+        std::cerr << "spine_skeleton_drawable_create failed\n";
+        return 2;
+      }
+      spine_skeleton skeleton = spine_skeleton_drawable_get_skeleton(drawable);
+      spine_animation_state state = spine_skeleton_drawable_get_animation_state(drawable);
+      if (skins[k]) spine_skeleton_set_skin_1(skeleton, skins[k]);
+      spine_skeleton_setup_pose(skeleton);
+      spine_skeleton_update_cache(skeleton);
+      spine_animation_state_set_animation_1(state, 0, animation, false);
+
+      const Combination c = {animation, skins[k], duration, static_cast<int64_t>(out.tellp()), frames};
+      index.push_back(c);
+      float time = 0.0f;
+      for (int f = 0; f < frames; f++) {
+        const float step = f == 0 ? 0.0f : dt;
+        spine_animation_state_update(state, step);
+        spine_animation_state_apply(state, skeleton);
+        spine_skeleton_update(skeleton, step);
+        spine_skeleton_update_world_transform(skeleton, physics);
+        time += step;
+        write_frame(drawable, animation, skins[k], time, context);
+        std::cout << "\n";
+      }
+      spine_skeleton_drawable_dispose(drawable);
+      if (!heap_guard_after_scenario()) {
+        std::cout.rdbuf(stdout_buf);
+        return 1;
+      }
+    }
+  }
+  std::cout.flush();
+  std::cout.rdbuf(stdout_buf);
+  if (!out) {
+    std::cerr << "failed to write sweep output: " << out_path << "\n";
+    return 2;
+  }
+
+  const std::string index_path = std::string(out_path) + ".index.json";
+  std::ofstream idx(index_path.c_str(), std::ios::binary);
+  idx << std::setprecision(std::numeric_limits<float>::max_digits10);
+  idx << "{\"file\":\"" << json_escape(out_path) << "\",\"hz\":" << hz << ",\"physics\":\"" << physics_name(physics)
+      << "\",\"combinations\":[";
+  for (size_t i = 0; i < index.size(); i++) {
+    const Combination &c = index[i];
+    if (i) idx << ",";
+    idx << "{\"animation\":\"" << json_escape(c.animation) << "\",\"skin\":";
+    if (c.skin) {
+      idx << "\"" << json_escape(c.skin) << "\"";
+    } else {
+      idx << "null";
+    }
+    idx << ",\"duration\":" << c.duration << ",\"offset\":" << c.offset << ",\"frames\":" << c.frames << "}";
+  }
+  idx << "]}\n";
+  if (!idx) {
+    std::cerr << "failed to write sweep index: " << index_path << "\n";
+    return 2;
+  }
+  return 0;
+}
+
+ScenarioRun scenario_run_for(spine_skeleton_drawable drawable) {
+  ScenarioRun run = {
+      spine_skeleton_drawable_get_skeleton(drawable),
+      spine_skeleton_drawable_get_animation_state(drawable),
+      spine_skeleton_drawable_get_animation_state_data(drawable),
+      SPINE_PHYSICS_NONE,
+      nullptr,
+      0.0f,
+      nullptr,
+      false,
+      false,
+      drawable,
+      nullptr,
+      nullptr,
+      nullptr,
+      0,
+      false,
+      1e6f,
+  };
+  return run;
+}
+
+static const char *const kBoneInvariantFields[] = {"a", "b", "c", "d", "worldX", "worldY"};
+static const char *const kSlotInvariantFields[] = {"color.r", "color.g", "color.b", "color.a",
+                                                   "darkColor.r", "darkColor.g", "darkColor.b", "darkColor.a"};
+static const char *const kPhysicsInvariantFields[] = {
+    "ux",         "uy",           "cx",          "cy",           "tx",           "ty",
+    "xOffset",    "xVelocity",    "yOffset",     "yVelocity",    "rotateOffset", "rotateVelocity",
+    "scaleOffset", "scaleVelocity", "remaining"};
+static const size_t kBoneInvariantCount = sizeof(kBoneInvariantFields) / sizeof(kBoneInvariantFields[0]);
+static const size_t kSlotInvariantCount = sizeof(kSlotInvariantFields) / sizeof(kSlotInvariantFields[0]);
+static const size_t kPhysicsInvariantCount = sizeof(kPhysicsInvariantFields) / sizeof(kPhysicsInvariantFields[0]);
+
+// Index of the first value that is NaN, infinite or larger than `limit` in magnitude, or `n`.
+// The common all-good case is a branch-free OR reduction the compiler vectorizes; only a failing
+// scan pays for the second, early-exit pass.
+static size_t first_bad_value(const float *v, size_t n, float limit) {
+  int bad = 0;
+  for (size_t i = 0; i < n; i++) bad |= !(std::fabs(v[i]) <= limit);
+  if (!bad) return n;
+  for (size_t i = 0; i < n; i++) {
+    if (!(std::fabs(v[i]) <= limit)) return i;
+  }
+  return n;
+}
+
+// Packs bone world matrices, slot colors and physics state into one buffer, scans it, and names
+// the first offending element on stderr.
+static bool check_scenario_invariants(const ScenarioRun &run) {
+  static std::vector<float> values;
+  values.clear();
+
+  spine_array_bone bones = spine_skeleton_get_bones(run.skeleton);
+  const size_t nb = spine_array_bone_size(bones);
+  spine_bone *bones_buf = spine_array_bone_buffer(bones);
+  for (size_t i = 0; i < nb; i++) {
+    spine_bone_pose pose = spine_bone_get_applied_pose(bones_buf[i]);
+    const float v[] = {spine_bone_pose_get_a(pose), spine_bone_pose_get_b(pose),      spine_bone_pose_get_c(pose),
+                       spine_bone_pose_get_d(pose), spine_bone_pose_get_world_x(pose), spine_bone_pose_get_world_y(pose)};
+    values.insert(values.end(), v, v + kBoneInvariantCount);
+  }
+
+  spine_array_slot slots = spine_skeleton_get_slots(run.skeleton);
+  const size_t ns = spine_array_slot_size(slots);
+  spine_slot *slots_buf = spine_array_slot_buffer(slots);
+  for (size_t i = 0; i < ns; i++) {
+    spine_slot_pose sp = spine_slot_get_applied_pose(slots_buf[i]);
+    spine_color c = spine_slot_pose_get_color(sp);
+    spine_color dc = spine_slot_pose_get_dark_color(sp);
+    const float v[] = {spine_color_get_r(c),  spine_color_get_g(c),  spine_color_get_b(c),  spine_color_get_a(c),
+                       spine_color_get_r(dc), spine_color_get_g(dc), spine_color_get_b(dc), spine_color_get_a(dc)};
+    values.insert(values.end(), v, v + kSlotInvariantCount);
+  }
+
+  spine_array_physics_constraint phys = spine_skeleton_get_physics_constraints(run.skeleton);
+  const size_t nphys = spine_array_physics_constraint_size(phys);
+  spine_physics_constraint *phys_buf = spine_array_physics_constraint_buffer(phys);
+  for (size_t i = 0; i < nphys; i++) {
+    const auto *cpp = reinterpret_cast<const spine::PhysicsConstraint *>(phys_buf[i]);
+    const float v[] = {cpp->_ux,          cpp->_uy,          cpp->_cx,          cpp->_cy,
+                       cpp->_tx,          cpp->_ty,          cpp->_xOffset,     cpp->_xVelocity,
+                       cpp->_yOffset,     cpp->_yVelocity,   cpp->_rotateOffset, cpp->_rotateVelocity,
+                       cpp->_scaleOffset, cpp->_scaleVelocity, cpp->_remaining};
+    values.insert(values.end(), v, v + kPhysicsInvariantCount);
+  }
+
+  const size_t bad = first_bad_value(values.data(), values.size(), run.invariant_limit);
+  if (bad == values.size()) return true;
+
+  std::string element;
+  size_t k = bad;
+  if (k < nb * kBoneInvariantCount) {
+    spine_bone_data bd = spine_bone_get_data(bones_buf[k / kBoneInvariantCount]);
+    element = std::string("bone '") + (bd ? spine_bone_data_get_name(bd) : "<unknown>") + "' " +
+              kBoneInvariantFields[k % kBoneInvariantCount];
+  } else if ((k -= nb * kBoneInvariantCount) < ns * kSlotInvariantCount) {
+    spine_slot_data sd = spine_slot_get_data(slots_buf[k / kSlotInvariantCount]);
+    element = std::string("slot '") + (sd ? spine_slot_data_get_name(sd) : "<unknown>") + "' " +
+              kSlotInvariantFields[k % kSlotInvariantCount];
+  } else {
+    k -= ns * kSlotInvariantCount;
+    spine_physics_constraint_data cd = spine_physics_constraint_get_data(phys_buf[k / kPhysicsInvariantCount]);
+    element = std::string("physics constraint '") + (cd ? spine_physics_constraint_data_get_name(cd) : "<unknown>") +
+              "' " + kPhysicsInvariantFields[k % kPhysicsInvariantCount];
+  }
+  std::cerr << "invariant violated at step " << run.steps << " (time " << run.total_time << "): " << element << " = "
+            << values[bad] << " (limit " << run.invariant_limit << ")\n";
+  return false;
+}
+
+int run_scenario_commands(int argc, char **argv, ScenarioRun &run, ToolOptionArity tool_option_arity,
+                          void (*usage)()) {
+  for (int i = 3; i < argc; i++) {
+    const char *arg = argv[i];
+
+    if (std::strcmp(arg, "--y-down") == 0 || std::strcmp(arg, "--trace-out") == 0 ||
+        std::strcmp(arg, "--heap-guard") == 0 || std::strcmp(arg, "--heap-out") == 0) {
+      i++;  // already processed by the tool
+      continue;
+    }
+
+    const int tool_arity = tool_option_arity ? tool_option_arity(arg) : -1;
+    if (tool_arity >= 0) {
+      i += tool_arity;  // already processed by the tool
+      continue;
+    }
+
+    if (std::strcmp(arg, "--set-skin") == 0 && i + 1 < argc) {
+      const char *name = argv[i + 1];
+      if (std::strcmp(name, "none") == 0) spine_skeleton_set_skin_2(run.skeleton, nullptr);
+      else spine_skeleton_set_skin_1(run.skeleton, name);
+      spine_skeleton_update_cache(run.skeleton);
+      i += 1;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--mix") == 0 && i + 3 < argc) {
+      const char *from_name = argv[i + 1];
+      const char *to_name = argv[i + 2];
+      const float duration = std::strtof(argv[i + 3], nullptr);
+      spine_animation_state_data_set_mix_1(run.state_data, from_name, to_name, duration);
+      i += 3;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--physics") == 0 && i + 1 < argc) {
+      const char *mode = argv[i + 1];
+      if (!parse_physics_mode(mode, run.physics)) {
+        std::cerr << "invalid physics mode: " << mode << "\n";
+        return 2;
+      }
+      i += 1;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--wind") == 0 && i + 2 < argc) {
+      spine_skeleton_set_wind_x(run.skeleton, std::strtof(argv[i + 1], nullptr));
+      spine_skeleton_set_wind_y(run.skeleton, std::strtof(argv[i + 2], nullptr));
+      i += 2;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--gravity") == 0 && i + 2 < argc) {
+      spine_skeleton_set_gravity_x(run.skeleton, std::strtof(argv[i + 1], nullptr));
+      spine_skeleton_set_gravity_y(run.skeleton, std::strtof(argv[i + 2], nullptr));
+      i += 2;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--dump-slot-vertices") == 0 && i + 1 < argc) {
+      run.dump_slot_vertices = argv[i + 1];
+      i += 1;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--dump-update-cache") == 0) {
+      run.dump_update_cache = true;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--dump-all-slot-vertices") == 0) {
+      run.dump_all_slot_vertices = true;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--check-invariants") == 0) {
+      run.check_invariants = true;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--invariant-limit") == 0 && i + 1 < argc) {
+      const float limit = std::strtof(argv[i + 1], nullptr);
+      if (!(limit > 0.0f)) {
+        std::cerr << "invalid --invariant-limit: " << argv[i + 1] << "\n";
+        return 2;
+      }
+      run.invariant_limit = limit;
+      i += 1;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--set") == 0 && i + 3 < argc) {
+      const size_t track = (size_t)std::atoi(argv[i + 1]);
+      const char *name = argv[i + 2];
+      const bool loop = std::atoi(argv[i + 3]) ? true : false;
+      run.last_entry = spine_animation_state_set_animation_1(run.state, track, name, loop);
+      i += 3;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--add") == 0 && i + 4 < argc) {
+      const size_t track = (size_t)std::atoi(argv[i + 1]);
+      const char *name = argv[i + 2];
+      const bool loop = std::atoi(argv[i + 3]) ? true : false;
+      const float delay = std::strtof(argv[i + 4], nullptr);
+      run.last_entry = spine_animation_state_add_animation_1(run.state, track, name, loop, delay);
+      i += 4;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--set-empty") == 0 && i + 2 < argc) {
+      const size_t track = (size_t)std::atoi(argv[i + 1]);
+      const float mix_duration = std::strtof(argv[i + 2], nullptr);
+      run.last_entry = spine_animation_state_set_empty_animation(run.state, track, mix_duration);
+      i += 2;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--add-empty") == 0 && i + 3 < argc) {
+      const size_t track = (size_t)std::atoi(argv[i + 1]);
+      const float mix_duration = std::strtof(argv[i + 2], nullptr);
+      const float delay = std::strtof(argv[i + 3], nullptr);
+      run.last_entry = spine_animation_state_add_empty_animation(run.state, track, mix_duration, delay);
+      i += 3;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--entry-alpha") == 0 && i + 1 < argc) {
+      if (!run.last_entry) {
+        std::cerr << "--entry-alpha requires a preceding --set/--add command\n";
+        return 2;
+      }
+      const float alpha = std::strtof(argv[i + 1], nullptr);
+      spine_track_entry_set_alpha(run.last_entry, alpha);
+      i += 1;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--entry-event-threshold") == 0 && i + 1 < argc) {
+      if (!run.last_entry) {
+        std::cerr << "--entry-event-threshold requires a preceding --set/--add command\n";
+        return 2;
+      }
+      const float threshold = std::strtof(argv[i + 1], nullptr);
+      spine_track_entry_set_event_threshold(run.last_entry, threshold);
+      i += 1;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--entry-alpha-attachment-threshold") == 0 && i + 1 < argc) {
+      if (!run.last_entry) {
+        std::cerr << "--entry-alpha-attachment-threshold requires a preceding --set/--add command\n";
+        return 2;
+      }
+      const float threshold = std::strtof(argv[i + 1], nullptr);
+      spine_track_entry_set_alpha_attachment_threshold(run.last_entry, threshold);
+      i += 1;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--entry-mix-attachment-threshold") == 0 && i + 1 < argc) {
+      if (!run.last_entry) {
+        std::cerr << "--entry-mix-attachment-threshold requires a preceding --set/--add command\n";
+        return 2;
+      }
+      const float threshold = std::strtof(argv[i + 1], nullptr);
+      spine_track_entry_set_mix_attachment_threshold(run.last_entry, threshold);
+      i += 1;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--entry-mix-draw-order-threshold") == 0 && i + 1 < argc) {
+      if (!run.last_entry) {
+        std::cerr << "--entry-mix-draw-order-threshold requires a preceding --set/--add command\n";
+        return 2;
+      }
+      const float threshold = std::strtof(argv[i + 1], nullptr);
+      spine_track_entry_set_mix_draw_order_threshold(run.last_entry, threshold);
+      i += 1;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--entry-hold-previous") == 0 && i + 1 < argc) {
+      if (!run.last_entry) {
+        std::cerr << "--entry-hold-previous requires a preceding --set/--add command\n";
+        return 2;
+      }
+      const bool hold = std::atoi(argv[i + 1]) ? true : false;
+      spine_track_entry_set_hold_previous(run.last_entry, hold);
+      i += 1;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--entry-mix-blend") == 0 && i + 1 < argc) {
+      if (!run.last_entry) {
+        std::cerr << "--entry-mix-blend requires a preceding --set/--add command\n";
+        return 2;
+      }
+      const char *blend = argv[i + 1];
+      spine_mix_blend mix_blend = SPINE_MIX_BLEND_REPLACE;
+      if (std::strcmp(blend, "setup") == 0) mix_blend = SPINE_MIX_BLEND_SETUP;
+      else if (std::strcmp(blend, "first") == 0) mix_blend = SPINE_MIX_BLEND_FIRST;
+      else if (std::strcmp(blend, "replace") == 0) mix_blend = SPINE_MIX_BLEND_REPLACE;
+      else if (std::strcmp(blend, "add") == 0) mix_blend = SPINE_MIX_BLEND_ADD;
+      else {
+        std::cerr << "invalid mix blend: " << blend << "\n";
+        return 2;
+      }
+      spine_track_entry_set_mix_blend(run.last_entry, mix_blend);
+      i += 1;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--entry-reverse") == 0 && i + 1 < argc) {
+      if (!run.last_entry) {
+        std::cerr << "--entry-reverse requires a preceding --set/--add command\n";
+        return 2;
+      }
+      const bool reverse = std::atoi(argv[i + 1]) ? true : false;
+      spine_track_entry_set_reverse(run.last_entry, reverse);
+      i += 1;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--entry-shortest-rotation") == 0 && i + 1 < argc) {
+      if (!run.last_entry) {
+        std::cerr << "--entry-shortest-rotation requires a preceding --set/--add command\n";
+        return 2;
+      }
+      const bool shortest = std::atoi(argv[i + 1]) ? true : false;
+      spine_track_entry_set_shortest_rotation(run.last_entry, shortest);
+      i += 1;
+      continue;
+    }
+
+    if (std::strcmp(arg, "--entry-reset-rotation-directions") == 0) {
+      if (!run.last_entry) {
+        std::cerr << "--entry-reset-rotation-directions requires a preceding --set/--add command\n";
+        return 2;
+      }
+      spine_track_entry_reset_rotation_directions(run.last_entry);
+      continue;
+    }
+
+    if (std::strcmp(arg, "--step") == 0 && i + 1 < argc) {
+      const float dt = std::strtof(argv[i + 1], nullptr);
+      if (run.step_hook) {
+        run.step_hook(run, dt);
+      } else if (run.bench) {
+        run_timed_step(run, dt);
+      } else if (g_trace) {
+        run_traced_step(run, dt);
+      } else {
+        spine_animation_state_update(run.state, dt);
+        spine_animation_state_apply(run.state, run.skeleton);
+        spine_skeleton_update(run.skeleton, dt);
+        spine_skeleton_update_world_transform(run.skeleton, run.physics);
+      }
+      run.total_time += dt;
+      run.steps++;
+      i += 1;
+      if (run.check_invariants && !check_scenario_invariants(run)) return 1;
+      continue;
+    }
+
+    std::cerr << "unknown/invalid command: " << arg << "\n";
+    usage();
+    return 2;
+  }
+
+  return 0;
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+// Shared pieces of the spine-cpp oracle tools (pose oracle, render oracle, constraint dump):
+// file/JSON helpers, atlas + skeleton loading, the scenario command interpreter, and the bench /
+// trace instrumentation around `--step`. Built once into an object next to the prebuilt spine-cpp
+// archive by `scripts/spine_cpp_lite_build.zsh`.
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "spine-c.h"
+
+std::string read_file(const char *path);
+std::string json_escape(const char *s);
+bool ends_with(const char *s, const char *suffix);
+
+spine_atlas load_atlas_or_die(const char *atlas_path, spine_atlas_result &out_result);
+spine_skeleton_data load_skeleton_data_or_die(
+    spine_atlas atlas,
+    const char *skeleton_path,
+    spine_skeleton_data_result &out_result);
+
+bool parse_physics_mode(const char *mode, spine_physics &out);
+const char *physics_name(spine_physics physics);
+
+typedef std::chrono::steady_clock BenchClock;
+
+int64_t elapsed_ns(BenchClock::time_point from, BenchClock::time_point to);
+
+// Nearest-rank percentile (`q` in [0, 1]) of unsorted samples.
+int64_t percentile_ns(std::vector<int64_t> samples, double q);
+
+enum BenchPhase { BENCH_UPDATE, BENCH_APPLY, BENCH_WORLD, BENCH_RENDER, BENCH_PHASE_COUNT };
+
+extern const char *const kBenchPhaseNames[BENCH_PHASE_COUNT];
+
+enum PerfCounter {
+  PERF_CYCLES,
+  PERF_INSTRUCTIONS,
+  PERF_L1D_MISSES,
+  PERF_LLC_MISSES,
+  PERF_BRANCH_MISSES,
+  PERF_COUNTER_COUNT
+};
+
+extern const char *const kPerfCounterNames[PERF_COUNTER_COUNT];
+
+struct PerfSample {
+  uint64_t v[PERF_COUNTER_COUNT];
+};
+
+// One perf_event_open group (user-space only) read with a single `read()` per sample. Events the
+// kernel/PMU refuses (common in VMs) are left out of the group and reported as unavailable.
+struct PerfCounterGroup {
+  int leader = -1;
+  int fds[PERF_COUNTER_COUNT] = {-1, -1, -1, -1, -1};
+  int slot[PERF_COUNTER_COUNT] = {-1, -1, -1, -1, -1};
+  int members = 0;
+};
+
+bool perf_open(PerfCounterGroup &g);
+void perf_read(const PerfCounterGroup &g, PerfSample &out);
+void perf_close(PerfCounterGroup &g);
+
+// Per-phase wall-clock samples, one per benchmark iteration (summed over that iteration's steps).
+// With `--bench-counters`, `frame_counters[step * BENCH_PHASE_COUNT + phase]` accumulates counter
+// deltas over the measured (non-warmup) iterations.
+struct BenchTimings {
+  int steps = 0;
+  int64_t current[BENCH_PHASE_COUNT] = {};
+  std::vector<int64_t> samples[BENCH_PHASE_COUNT];
+  bool measuring = false;
+  PerfCounterGroup *perf = nullptr;
+  std::vector<PerfSample> frame_counters;
+};
+
+// `--trace-out` recorder: Chrome Trace Event "X" (complete) events, viewable in chrome://tracing
+// or ui.perfetto.dev. Step phases are recorded from the timestamps the step already takes, so
+// tracing adds no clock reads inside the timed regions of `run_timed_step`.
+struct TraceEvent {
+  const char *cat;
+  const char *name;
+  int64_t ts_ns;
+  int64_t dur_ns;
+  uint64_t tid;
+  float time;  // scenario time at zone start, < 0 if not step-scoped
+};
+
+struct TraceRecorder {
+  BenchClock::time_point origin;
+  uint64_t main_tid = 0;
+  std::mutex mutex;
+  std::vector<TraceEvent> events;
+};
+
+// Active recorder, or null when `--trace-out` was not given.
+extern TraceRecorder *g_trace;
+
+uint64_t trace_thread_id();
+void trace_complete(const char *cat, const char *name, BenchClock::time_point from, BenchClock::time_point to,
+                    float time = -1.0f);
+bool write_trace(const TraceRecorder &trace, const char *path, const char *process_name);
+
+// Scoped zone for the coarse phases (loading, scenario runs, serialization).
+struct TraceZone {
+  const char *cat;
+  const char *name;
+  BenchClock::time_point start;
+  TraceZone(const char *cat_, const char *name_)
+      : cat(cat_), name(name_), start(g_trace ? BenchClock::now() : BenchClock::time_point()) {}
+  ~TraceZone() {
+    if (g_trace) trace_complete(cat, name, start, BenchClock::now());
+  }
+};
+
+// `--heap-guard` accounting for the batch modes (sweeps, `--bench`, `--mix-profile`), which reuse one
+// loaded skeleton data for many scenarios. `heap_hook_install` routes spine-cpp's allocations through
+// a counting `SpineExtension` (call it before the atlas is loaded); oracle-side containers are not
+// counted. After each scenario's drawable is disposed, `heap_guard_after_scenario` records how far
+// live spine bytes sit above the post-load baseline and fails once that exceeds `limit`.
+struct HeapGuard {
+  const char *batch = "";  // batch mode name, for the report
+  int64_t limit = 0;       // retained bytes accepted after a scenario
+  int64_t baseline = 0;    // live bytes when `heap_guard_begin` ran
+  std::vector<int64_t> retained;
+  std::vector<int64_t> peak;  // highest live bytes above baseline while each scenario ran
+};
+
+// Active guard, or null when `--heap-guard` was not given.
+extern HeapGuard *g_heap_guard;
+
+void heap_hook_install();
+int64_t heap_live_bytes();
+uint64_t heap_alloc_count();
+
+// Takes the baseline for `guard` (current live bytes) and makes it the active guard.
+void heap_guard_begin(HeapGuard &guard, const char *batch);
+
+// Records scenario `g_heap_guard->retained.size()`. Returns false after reporting on stderr when its
+// retained bytes exceed the limit; true otherwise, or when no guard is active.
+bool heap_guard_after_scenario();
+
+// `{"mode":"heap-guard",...}` with per-scenario retained/peak bytes. False if `path` can't be written.
+bool write_heap_report(const HeapGuard &guard, const char *path, const char *tool);
+
+struct ScenarioRun;
+
+// Replaces the built-in `--step` pipeline (update, apply, world transform) for tools that need to
+// observe or time the phases themselves. Must advance the state and skeleton by `dt`.
+typedef void (*ScenarioStepHook)(ScenarioRun &run, float dt);
+
+struct ScenarioRun {
+  spine_skeleton skeleton;
+  spine_animation_state state;
+  spine_animation_state_data state_data;
+  spine_physics physics;
+  spine_track_entry last_entry;
+  float total_time;
+  const char *dump_slot_vertices;
+  bool dump_update_cache;
+  bool dump_all_slot_vertices;
+  spine_skeleton_drawable drawable;
+  BenchTimings *bench;
+  ScenarioStepHook step_hook;
+  void *step_context;
+  int steps;               // `--step` commands executed so far
+  bool check_invariants;   // `--check-invariants`: scan the pose after every step
+  float invariant_limit;   // largest magnitude accepted by the scan (`--invariant-limit`)
+};
+
+// A run over `drawable`'s skeleton and animation state with no physics, dumps, bench, step hook or
+// invariant checks (limit 1e6 once enabled).
+ScenarioRun scenario_run_for(spine_skeleton_drawable drawable);
+
+// `--sweep` frame writer: prints one JSON object (no trailing newline) describing the posed
+// `drawable` to std::cout, which `run_animation_skin_sweep` redirects into the sweep file.
+typedef void (*SweepFrameWriter)(spine_skeleton_drawable drawable, const char *animation, const char *skin, float time,
+                                 void *context);
+
+// Evaluates every animation x every skin (just the default skin when there are none) x a time grid
+// at `hz` over [0, duration]. Each combination starts from a fresh drawable in setup pose and is
+// stepped through the grid with the animation set non-looping on track 0. Frames go to `out_path`
+// as NDJSON; `<out_path>.index.json` lists each combination's byte offset and frame count. Each
+// combination is one `--heap-guard` scenario. Returns 0 or the process exit code.
+int run_animation_skin_sweep(spine_skeleton_data data, const char *out_path, float hz, spine_physics physics,
+                             SweepFrameWriter write_frame, void *context);
+
+// Tool-specific global option hook for `run_scenario_commands`: returns how many values follow
+// `arg` if it is an option the tool already consumed in its own pre-scan, or -1 otherwise.
+typedef int (*ToolOptionArity)(const char *arg);
+
+// Runs the scenario command stream (`argv[3..]`) against `run`. `--y-down` and `--trace-out` are
+// skipped here; everything else unknown to both the interpreter and `tool_option_arity` prints
+// `usage` and fails. Returns 0 on success, 1 when `--check-invariants` trips (after reporting the
+// step and element on stderr), or 2 on a malformed command.
+int run_scenario_commands(int argc, char **argv, ScenarioRun &run, ToolOptionArity tool_option_arity,
+                          void (*usage)());
@@ -1,26 +1,15 @@
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
-#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
-#include <sstream>
 #include <string>
 #include <vector>
 
 #include "spine-c.h"
-
-static std::string read_file(const char *path) {
-  std::ifstream file(path, std::ios::binary);
-  if (!file) {
-    std::cerr << "failed to open: " << path << "\n";
-    std::exit(2);
-  }
-  std::ostringstream ss;
-  ss << file.rdbuf();
-  return ss.str();
-}
+#include "spine_cpp_lite_oracle_core.h"
 
 static void usage() {
   std::cerr
@@ -34,6 +23,8 @@ static void usage() {
          "Commands (scenario mode):\n"
          "  --set-skin <name|none>\n"
          "  --physics <none|reset|update|pose>\n"
+         "  --wind <x> <y>\n"
+         "  --gravity <x> <y>\n"
          "  --mix <from> <to> <duration>\n"
          "  --set <track> <animation> <loop 0|1>\n"
          "  --add <track> <animation> <loop 0|1> <delay>\n"
@@ -49,22 +40,42 @@ static void usage() {
          "  --entry-reverse <0|1>\n"
          "  --entry-shortest-rotation <0|1>\n"
          "  --entry-reset-rotation-directions\n"
-         "  --step <dt>\n";
-}
-
-static std::string json_escape(const char *s) {
-  if (!s) return "";
-  std::string out;
-  for (const char *p = s; *p; p++) {
-    const unsigned char c = static_cast<unsigned char>(*p);
-    if (c == '\\') out += "\\\\";
-    else if (c == '\"') out += "\\\"";
-    else if (c == '\n') out += "\\n";
-    else if (c == '\r') out += "\\r";
-    else if (c == '\t') out += "\\t";
-    else out += static_cast<char>(c);
-  }
-  return out;
+         "  --check-invariants            (after every --step: abort with exit 1 on NaN/Inf or |value| > limit\n"
+         "                                 in bone world matrices, slot colors or physics state)\n"
+         "  --invariant-limit <abs>       (default 1e6)\n"
+         "  --step <dt>\n"
+         "\n"
+         "Atlas page usage (legacy mode; replaces the draw dump):\n"
+         "  --page-usage <fps>            sample --anim from 0 to --time (default: its duration) at <fps>,\n"
+         "                                rendering every frame, and report the atlas pages and UV\n"
+         "                                rectangles touched per frame plus per-page working set,\n"
+         "                                used-area fraction and first-use time\n"
+         "\n"
+         "Draw-order churn (scenario mode; replaces the draw dump):\n"
+         "  --draw-order-churn            render after every --step and report per-frame draw calls, page\n"
+         "                                and blend switches, draw-order changes and the slots that moved,\n"
+         "                                plus the worst frames\n"
+         "\n"
+         "Frame sequences (scenario mode; NDJSON, one single-frame-shaped line per rendered frame):\n"
+         "  --render-every <n>            render after every n-th --step\n"
+         "  --render-at <t0,t1,...>       render after the first --step whose end time reaches each t; a t\n"
+         "                                past the last step is an error\n"
+         "\n"
+         "Animation x skin sweep (scenario mode, no commands; NDJSON + <out>.index.json):\n"
+         "  --sweep <out.ndjson>          every animation x every skin x a time grid over [0, duration], each\n"
+         "                                combination from setup pose, one single-frame-shaped line per frame\n"
+         "  --sweep-hz <hz>               (default 30; `--physics <mode>` applies to every frame)\n"
+         "\n"
+         "Tracing (any mode):\n"
+         "  --trace-out <file.json>       (Chrome Trace Event zones: load atlas/skeleton, per-step\n"
+         "                                 update/apply/world, render, serialization)\n"
+         "\n"
+         "Heap guard (--sweep):\n"
+         "  --heap-guard <bytes>          count spine-cpp allocations; after each combination's drawable is\n"
+         "                                disposed, fail with exit 1 if live bytes exceed the post-load\n"
+         "                                baseline by more than <bytes>\n"
+         "  --heap-out <file.json>        per-combination retained/peak bytes over the baseline (alone:\n"
+         "                                report only, never fails)\n";
 }
 
 static const char *blend_mode_name(spine_blend_mode mode) {
@@ -77,16 +88,6 @@ static const char *blend_mode_name(spine_blend_mode mode) {
   }
 }
 
-static const char *physics_name(spine_physics physics) {
-  switch (physics) {
-    case SPINE_PHYSICS_NONE: return "none";
-    case SPINE_PHYSICS_RESET: return "reset";
-    case SPINE_PHYSICS_UPDATE: return "update";
-    case SPINE_PHYSICS_POSE: return "pose";
-    default: return "unknown";
-  }
-}
-
 static uint32_t premultiply_packed_aarrggbb(uint32_t c) {
   const uint8_t a8 = static_cast<uint8_t>(c >> 24);
   const float a = static_cast<float>(a8) / 255.0f;
@@ -126,6 +127,546 @@ static uint32_t adjust_dark_color_for_shader(uint32_t dark, uint32_t light, bool
          static_cast<uint32_t>(b8);
 }
 
+// The `"draws":[...]` array for a render command list (colors premultiplied on PMA atlases, dark
+// colors adjusted for the spine-webgl shader convention).
+static void print_draws(spine_render_command cmd, bool premultipliedAlpha) {
+  std::cout << "\"draws\":[";
+  bool first_cmd = true;
+  while (cmd) {
+    const int32_t page = (int32_t)(intptr_t)spine_render_command_get_texture(cmd);
+    const spine_blend_mode blend = spine_render_command_get_blend_mode(cmd);
+    const int32_t num_vertices = spine_render_command_get_num_vertices(cmd);
+    const int32_t num_indices = spine_render_command_get_num_indices(cmd);
+
+    float *positions = spine_render_command_get_positions(cmd);
+    float *uvs = spine_render_command_get_uvs(cmd);
+    uint32_t *colors = spine_render_command_get_colors(cmd);
+    uint32_t *dark_colors = spine_render_command_get_dark_colors(cmd);
+    uint16_t *indices = spine_render_command_get_indices(cmd);
+
+    if (!first_cmd) std::cout << ",";
+    first_cmd = false;
+
+    std::cout << "{";
+    std::cout << "\"page\":" << page << ",";
+    std::cout << "\"blend\":\"" << blend_mode_name(blend) << "\",";
+    std::cout << "\"num_vertices\":" << num_vertices << ",";
+    std::cout << "\"num_indices\":" << num_indices << ",";
+
+    std::cout << "\"positions\":[";
+    for (int32_t i = 0; i < num_vertices * 2; i++) {
+      if (i) std::cout << ",";
+      std::cout << positions[i];
+    }
+    std::cout << "],";
+
+    std::cout << "\"uvs\":[";
+    for (int32_t i = 0; i < num_vertices * 2; i++) {
+      if (i) std::cout << ",";
+      std::cout << uvs[i];
+    }
+    std::cout << "],";
+
+    std::cout << "\"colors\":[";
+    for (int32_t i = 0; i < num_vertices; i++) {
+      if (i) std::cout << ",";
+      uint32_t c = (uint32_t)colors[i];
+      if (premultipliedAlpha) c = premultiply_packed_aarrggbb(c);
+      std::cout << c;
+    }
+    std::cout << "],";
+
+    std::cout << "\"dark_colors\":[";
+    for (int32_t i = 0; i < num_vertices; i++) {
+      if (i) std::cout << ",";
+      uint32_t light = (uint32_t)colors[i];
+      if (premultipliedAlpha) light = premultiply_packed_aarrggbb(light);
+      uint32_t dark = (uint32_t)dark_colors[i];
+      dark = adjust_dark_color_for_shader(dark, (uint32_t)colors[i], premultipliedAlpha);
+      std::cout << dark;
+    }
+    std::cout << "],";
+
+    std::cout << "\"indices\":[";
+    for (int32_t i = 0; i < num_indices; i++) {
+      if (i) std::cout << ",";
+      std::cout << indices[i];
+    }
+    std::cout << "]";
+
+    std::cout << "}";
+
+    cmd = spine_render_command_get_next(cmd);
+  }
+  std::cout << "]";
+}
+
+static bool atlas_is_pma(spine_atlas atlas) {
+  spine_array_atlas_page pages = spine_atlas_get_pages(atlas);
+  const size_t n = spine_array_atlas_page_size(pages);
+  spine_atlas_page *buf = spine_array_atlas_page_buffer(pages);
+  for (size_t i = 0; i < n; i++) {
+    if (spine_atlas_page_get_pma(buf[i])) return true;
+  }
+  return false;
+}
+
+// Per-page accumulator for `--page-usage`. Coverage is tracked on a fixed grid over the page's UV
+// square by marking the cells under each triangle's UV bounding box, so `usedArea` is a slight
+// overestimate for thin or rotated triangles but never misses touched texels.
+static const int kCoverageGrid = 256;
+
+struct PageUsage {
+  std::vector<uint8_t> cells;
+  float first_use = -1.0f;
+  int frames_used = 0;
+  int64_t triangles = 0;
+  float uv[4] = {1.0f, 1.0f, 0.0f, 0.0f};  // min u, min v, max u, max v over the whole run
+};
+
+// This frame's footprint on one page: draws, triangles and UV bounding rectangle.
+struct FramePageUse {
+  int32_t page;
+  int32_t draws;
+  int32_t triangles;
+  float uv[4];
+};
+
+static int grid_cell(float t) {
+  const int c = static_cast<int>(t * kCoverageGrid);
+  return c < 0 ? 0 : (c >= kCoverageGrid ? kCoverageGrid - 1 : c);
+}
+
+static void mark_triangle(PageUsage &usage, const float *uvs, uint16_t a, uint16_t b, uint16_t c) {
+  const float u0 = std::min(uvs[a * 2], std::min(uvs[b * 2], uvs[c * 2]));
+  const float u1 = std::max(uvs[a * 2], std::max(uvs[b * 2], uvs[c * 2]));
+  const float v0 = std::min(uvs[a * 2 + 1], std::min(uvs[b * 2 + 1], uvs[c * 2 + 1]));
+  const float v1 = std::max(uvs[a * 2 + 1], std::max(uvs[b * 2 + 1], uvs[c * 2 + 1]));
+  for (int y = grid_cell(v0); y <= grid_cell(v1); y++) {
+    uint8_t *row = &usage.cells[static_cast<size_t>(y) * kCoverageGrid];
+    for (int x = grid_cell(u0); x <= grid_cell(u1); x++) row[x] = 1;
+  }
+}
+
+static void print_uv_rect(const float *uv) {
+  std::cout << "[" << uv[0] << "," << uv[1] << "," << uv[2] << "," << uv[3] << "]";
+}
+
+// `--page-usage`: samples `anim` at `fps` from 0 to `duration`, rendering each frame, and writes the
+// per-frame page/UV footprint and per-page totals as one JSON object.
+static int run_page_usage(spine_atlas atlas, spine_skeleton_data data, spine_skeleton_drawable drawable,
+                          const char *skin, const char *anim, int loop, float duration, float fps,
+                          spine_physics physics) {
+  spine_skeleton skeleton = spine_skeleton_drawable_get_skeleton(drawable);
+  spine_animation_state state = spine_skeleton_drawable_get_animation_state(drawable);
+
+  spine_animation animation = spine_skeleton_data_find_animation(data, anim);
+  if (!animation) {
+    std::cerr << "animation not found: " << anim << "\n";
+    return 2;
+  }
+  if (duration <= 0.0f) duration = spine_animation_get_duration(animation);
+  if (!(fps > 0.0f)) {
+    std::cerr << "--page-usage needs fps > 0\n";
+    return 2;
+  }
+  const float dt = 1.0f / fps;
+  const int frames = static_cast<int>(duration * fps + 0.5f) + 1;
+
+  spine_array_atlas_page atlas_pages = spine_atlas_get_pages(atlas);
+  const size_t page_count = spine_array_atlas_page_size(atlas_pages);
+  spine_atlas_page *page_buf = spine_array_atlas_page_buffer(atlas_pages);
+  std::vector<PageUsage> pages(page_count);
+  for (size_t i = 0; i < page_count; i++) {
+    pages[i].cells.assign(static_cast<size_t>(kCoverageGrid) * kCoverageGrid, 0);
+  }
+
+  if (skin) {
+    if (std::strcmp(skin, "none") == 0) {
+      spine_skeleton_set_skin_2(skeleton, nullptr);
+    } else {
+      spine_skeleton_set_skin_1(skeleton, skin);
+    }
+    spine_skeleton_setup_pose_slots(skeleton);
+    spine_skeleton_update_cache(skeleton);
+  }
+  spine_animation_state_set_animation_1(state, 0, anim, loop ? true : false);
+
+  std::cout << "{\"mode\":\"pageUsage\",";
+  std::cout << "\"skin\":" << (skin ? ("\"" + json_escape(skin) + "\"") : "null") << ",";
+  std::cout << "\"anim\":\"" << json_escape(anim) << "\",";
+  std::cout << "\"duration\":" << duration << ",\"fps\":" << fps << ",\"frames\":[";
+
+  std::vector<FramePageUse> frame_use;
+  size_t max_pages_per_frame = 0;
+  for (int f = 0; f < frames; f++) {
+    const float step = f == 0 ? 0.0f : dt;
+    const float t = f * dt;
+    {
+      TraceZone zone("step", "pose");
+      spine_animation_state_update(state, step);
+      spine_animation_state_apply(state, skeleton);
+      spine_skeleton_update(skeleton, step);
+      spine_skeleton_update_world_transform(skeleton, physics);
+    }
+    spine_render_command cmd = nullptr;
+    {
+      TraceZone zone("render", "render");
+      cmd = spine_skeleton_drawable_render(drawable);
+    }
+
+    frame_use.clear();
+    for (; cmd; cmd = spine_render_command_get_next(cmd)) {
+      const int32_t page = (int32_t)(intptr_t)spine_render_command_get_texture(cmd);
+      if (page < 0 || static_cast<size_t>(page) >= page_count) continue;
+      const int32_t num_vertices = spine_render_command_get_num_vertices(cmd);
+      const int32_t num_indices = spine_render_command_get_num_indices(cmd);
+      const float *uvs = spine_render_command_get_uvs(cmd);
+      const uint16_t *indices = spine_render_command_get_indices(cmd);
+
+      FramePageUse *use = nullptr;
+      for (size_t k = 0; k < frame_use.size(); k++) {
+        if (frame_use[k].page == page) use = &frame_use[k];
+      }
+      if (!use) {
+        FramePageUse fresh = {page, 0, 0, {1.0f, 1.0f, 0.0f, 0.0f}};
+        frame_use.push_back(fresh);
+        use = &frame_use.back();
+      }
+      use->draws += 1;
+      use->triangles += num_indices / 3;
+      for (int32_t v = 0; v < num_vertices; v++) {
+        use->uv[0] = std::min(use->uv[0], uvs[v * 2]);
+        use->uv[1] = std::min(use->uv[1], uvs[v * 2 + 1]);
+        use->uv[2] = std::max(use->uv[2], uvs[v * 2]);
+        use->uv[3] = std::max(use->uv[3], uvs[v * 2 + 1]);
+      }
+      PageUsage &usage = pages[page];
+      for (int32_t k = 0; k + 2 < num_indices; k += 3) {
+        mark_triangle(usage, uvs, indices[k], indices[k + 1], indices[k + 2]);
+      }
+      usage.triangles += num_indices / 3;
+    }
+
+    max_pages_per_frame = std::max(max_pages_per_frame, frame_use.size());
+    if (f) std::cout << ",";
+    std::cout << "{\"time\":" << t << ",\"pages\":[";
+    for (size_t k = 0; k < frame_use.size(); k++) {
+      const FramePageUse &use = frame_use[k];
+      PageUsage &usage = pages[use.page];
+      if (usage.first_use < 0.0f) usage.first_use = t;
+      usage.frames_used += 1;
+      usage.uv[0] = std::min(usage.uv[0], use.uv[0]);
+      usage.uv[1] = std::min(usage.uv[1], use.uv[1]);
+      usage.uv[2] = std::max(usage.uv[2], use.uv[2]);
+      usage.uv[3] = std::max(usage.uv[3], use.uv[3]);
+      if (k) std::cout << ",";
+      std::cout << "{\"page\":" << use.page << ",\"draws\":" << use.draws << ",\"triangles\":" << use.triangles
+                << ",\"uv\":";
+      print_uv_rect(use.uv);
+      std::cout << "}";
+    }
+    std::cout << "]}";
+  }
+
+  std::cout << "],\"pages\":[";
+  int64_t working_set_texels = 0;
+  int64_t resident_texels = 0;
+  for (size_t i = 0; i < page_count; i++) {
+    const PageUsage &usage = pages[i];
+    size_t covered = 0;
+    for (size_t k = 0; k < usage.cells.size(); k++) covered += usage.cells[k];
+    const double used = static_cast<double>(covered) / usage.cells.size();
+    const int32_t width = spine_atlas_page_get_width(page_buf[i]);
+    const int32_t height = spine_atlas_page_get_height(page_buf[i]);
+    const int64_t texels = static_cast<int64_t>(width) * height;
+    resident_texels += texels;
+    if (usage.frames_used) working_set_texels += texels;
+
+    if (i) std::cout << ",";
+    std::cout << "{\"page\":" << i << ",\"name\":\"" << json_escape(spine_atlas_page_get_name(page_buf[i]))
+              << "\",\"width\":" << width << ",\"height\":" << height << ",\"used\":"
+              << (usage.frames_used ? "true" : "false") << ",\"firstUse\":";
+    if (usage.frames_used) {
+      std::cout << usage.first_use;
+    } else {
+      std::cout << "null";
+    }
+    std::cout << ",\"framesUsed\":" << usage.frames_used << ",\"triangles\":" << usage.triangles
+              << ",\"usedAreaFraction\":" << used << ",\"uv\":";
+    if (usage.frames_used) {
+      print_uv_rect(usage.uv);
+    } else {
+      std::cout << "null";
+    }
+    std::cout << "}";
+  }
+  std::cout << "],\"workingSet\":{\"pages\":[";
+  bool first = true;
+  for (size_t i = 0; i < page_count; i++) {
+    if (!pages[i].frames_used) continue;
+    if (!first) std::cout << ",";
+    first = false;
+    std::cout << i;
+  }
+  std::cout << "],\"maxPagesPerFrame\":" << max_pages_per_frame << ",\"texels\":" << working_set_texels
+            << ",\"atlasTexels\":" << resident_texels << "}}\n";
+  return 0;
+}
+
+// Global options consumed by the pre-scan in `main` (skipped by `run_scenario_commands`).
+static int render_option_arity(const char *arg) {
+  if (std::strcmp(arg, "--draw-order-churn") == 0) return 0;
+  if (std::strcmp(arg, "--render-every") == 0 || std::strcmp(arg, "--render-at") == 0) return 1;
+  if (std::strcmp(arg, "--sweep") == 0 || std::strcmp(arg, "--sweep-hz") == 0) return 1;
+  return -1;
+}
+
+// `--render-every` / `--render-at`: frames rendered inside the scenario run, each streamed as one
+// NDJSON line so a whole crossfade needs a single process and asset load.
+struct RenderSequence {
+  int every = 0;
+  std::vector<float> at;  // ascending
+  size_t next_at = 0;
+  int frames = 0;
+  int y_down = 0;
+  bool pma = false;
+};
+
+static bool parse_times(const char *spec, std::vector<float> &out) {
+  out.clear();
+  const char *p = spec;
+  while (*p) {
+    char *end = nullptr;
+    const float t = std::strtof(p, &end);
+    if (end == p) return false;
+    out.push_back(t);
+    p = end;
+    if (*p == ',') p++;
+    else if (*p) return false;
+  }
+  std::sort(out.begin(), out.end());
+  return !out.empty();
+}
+
+static void sequence_step(ScenarioRun &run, float dt) {
+  RenderSequence &seq = *static_cast<RenderSequence *>(run.step_context);
+  {
+    TraceZone zone("step", "pose");
+    spine_animation_state_update(run.state, dt);
+    spine_animation_state_apply(run.state, run.skeleton);
+    spine_skeleton_update(run.skeleton, dt);
+    spine_skeleton_update_world_transform(run.skeleton, run.physics);
+  }
+
+  const float time = run.total_time + dt;
+  const int step = run.steps + 1;
+  bool due = seq.every > 0 && step % seq.every == 0;
+  while (seq.next_at < seq.at.size() && seq.at[seq.next_at] <= time + 1e-6f) {
+    due = true;
+    seq.next_at++;
+  }
+  if (!due) return;
+
+  spine_render_command cmd = nullptr;
+  {
+    TraceZone zone("render", "render");
+    cmd = spine_skeleton_drawable_render(run.drawable);
+  }
+  TraceZone zone("output", "frame");
+  std::cout << "{\"mode\":\"scenario-frame\",\"frame\":" << seq.frames++ << ",\"step\":" << step
+            << ",\"y_down\":" << seq.y_down << ",\"pma\":" << (seq.pma ? 1 : 0) << ",\"physics\":\""
+            << physics_name(run.physics) << "\",\"skin\":null,\"anim\":\"<scenario>\",\"time\":" << time << ",";
+  print_draws(cmd, seq.pma);
+  std::cout << "}\n";
+}
+
+struct SweepRender {
+  int y_down;
+  bool pma;
+  spine_physics physics;
+};
+
+static void write_sweep_frame(spine_skeleton_drawable drawable, const char *animation, const char *skin, float time,
+                              void *context) {
+  const SweepRender &sweep = *static_cast<const SweepRender *>(context);
+  spine_render_command cmd = nullptr;
+  {
+    TraceZone zone("render", "render");
+    cmd = spine_skeleton_drawable_render(drawable);
+  }
+  std::cout << "{\"mode\":\"sweep-frame\",\"y_down\":" << sweep.y_down << ",\"pma\":" << (sweep.pma ? 1 : 0)
+            << ",\"physics\":\"" << physics_name(sweep.physics) << "\",\"skin\":"
+            << (skin ? ("\"" + json_escape(skin) + "\"") : "null") << ",\"anim\":\"" << json_escape(animation)
+            << "\",\"time\":" << time << ",";
+  print_draws(cmd, sweep.pma);
+  std::cout << "}";
+}
+
+// `--draw-order-churn`: one sample per `--step`, taken from the render commands and draw order
+// right after that step.
+struct ChurnFrame {
+  float time;
+  int32_t draws;
+  int32_t page_switches;
+  int32_t blend_switches;
+  int32_t vertices;
+  bool order_changed;
+  std::vector<int32_t> moved;  // slot indices outside the LCS of the previous and current order
+};
+
+struct DrawOrderChurn {
+  std::vector<int32_t> order;  // seeded with the setup-pose order, so the first step can count as a change
+  std::vector<ChurnFrame> frames;
+};
+
+static std::vector<int32_t> draw_order_slots(spine_skeleton skeleton) {
+  spine_array_slot draw_order = spine_skeleton_get_draw_order(skeleton);
+  const size_t nd = spine_array_slot_size(draw_order);
+  spine_slot *draw_buf = spine_array_slot_buffer(draw_order);
+  std::vector<int32_t> order(nd);
+  for (size_t i = 0; i < nd; i++) {
+    spine_slot_data sd = spine_slot_get_data(draw_buf[i]);
+    order[i] = sd ? spine_slot_data_get_index(sd) : -1;
+  }
+  return order;
+}
+
+// Slots of `cur` that are not part of a longest common subsequence with `prev`: the smallest set
+// of slots whose moves explain the new order.
+static std::vector<int32_t> moved_slots(const std::vector<int32_t> &prev, const std::vector<int32_t> &cur) {
+  const size_t n = prev.size();
+  const size_t m = cur.size();
+  std::vector<int32_t> lcs((n + 1) * (m + 1), 0);
+  for (size_t i = n; i-- > 0;) {
+    for (size_t j = m; j-- > 0;) {
+      lcs[i * (m + 1) + j] = prev[i] == cur[j] ? lcs[(i + 1) * (m + 1) + j + 1] + 1
+                                               : std::max(lcs[(i + 1) * (m + 1) + j], lcs[i * (m + 1) + j + 1]);
+    }
+  }
+  std::vector<bool> kept(m, false);
+  for (size_t i = 0, j = 0; i < n && j < m;) {
+    if (prev[i] == cur[j]) {
+      kept[j] = true;
+      i++;
+      j++;
+    } else if (lcs[(i + 1) * (m + 1) + j] >= lcs[i * (m + 1) + j + 1]) {
+      i++;
+    } else {
+      j++;
+    }
+  }
+  std::vector<int32_t> out;
+  for (size_t j = 0; j < m; j++) {
+    if (!kept[j]) out.push_back(cur[j]);
+  }
+  return out;
+}
+
+static void churn_step(ScenarioRun &run, float dt) {
+  DrawOrderChurn &churn = *static_cast<DrawOrderChurn *>(run.step_context);
+  {
+    TraceZone zone("step", "pose");
+    spine_animation_state_update(run.state, dt);
+    spine_animation_state_apply(run.state, run.skeleton);
+    spine_skeleton_update(run.skeleton, dt);
+    spine_skeleton_update_world_transform(run.skeleton, run.physics);
+  }
+
+  ChurnFrame frame = {run.total_time + dt, 0, 0, 0, 0, false, std::vector<int32_t>()};
+  spine_render_command cmd = nullptr;
+  {
+    TraceZone zone("render", "render");
+    cmd = spine_skeleton_drawable_render(run.drawable);
+  }
+  int32_t prev_page = -1;
+  int prev_blend = -1;
+  for (; cmd; cmd = spine_render_command_get_next(cmd)) {
+    const int32_t page = (int32_t)(intptr_t)spine_render_command_get_texture(cmd);
+    const int blend = (int)spine_render_command_get_blend_mode(cmd);
+    if (frame.draws > 0 && page != prev_page) frame.page_switches++;
+    if (frame.draws > 0 && blend != prev_blend) frame.blend_switches++;
+    prev_page = page;
+    prev_blend = blend;
+    frame.draws++;
+    const int32_t num_vertices = spine_render_command_get_num_vertices(cmd);
+    frame.vertices += num_vertices;
+  }
+
+  std::vector<int32_t> order = draw_order_slots(run.skeleton);
+  if (order != churn.order) {
+    frame.order_changed = true;
+    frame.moved = moved_slots(churn.order, order);
+  }
+  churn.order.swap(order);
+  churn.frames.push_back(frame);
+}
+
+static void print_slot_names(spine_skeleton_data data, const std::vector<int32_t> &slots) {
+  spine_array_slot_data slot_data = spine_skeleton_data_get_slots(data);
+  const size_t ns = spine_array_slot_data_size(slot_data);
+  spine_slot_data *buf = spine_array_slot_data_buffer(slot_data);
+  std::cout << "[";
+  for (size_t i = 0; i < slots.size(); i++) {
+    if (i) std::cout << ",";
+    const bool valid = slots[i] >= 0 && static_cast<size_t>(slots[i]) < ns;
+    std::cout << "\"" << json_escape(valid ? spine_slot_data_get_name(buf[slots[i]]) : "<unknown>") << "\"";
+  }
+  std::cout << "]";
+}
+
+// Per-frame batching numbers, a changed-vs-unchanged summary, and the frames with the most draw
+// calls (ties: largest jump from the previous frame) together with the slots that moved.
+static void print_draw_order_churn(spine_skeleton_data data, const DrawOrderChurn &churn) {
+  std::cout << "{\"mode\":\"draw-order-churn\",\"frames\":[";
+  int64_t draws[2] = {0, 0};
+  int64_t switches[2] = {0, 0};
+  int64_t count[2] = {0, 0};
+  for (size_t f = 0; f < churn.frames.size(); f++) {
+    const ChurnFrame &frame = churn.frames[f];
+    const int k = frame.order_changed ? 1 : 0;
+    draws[k] += frame.draws;
+    switches[k] += frame.page_switches;
+    count[k] += 1;
+    if (f) std::cout << ",";
+    std::cout << "{\"time\":" << frame.time << ",\"draws\":" << frame.draws
+              << ",\"pageSwitches\":" << frame.page_switches << ",\"blendSwitches\":" << frame.blend_switches
+              << ",\"vertices\":" << frame.vertices << ",\"drawOrderChanged\":" << (frame.order_changed ? 1 : 0)
+              << ",\"movedSlots\":";
+    print_slot_names(data, frame.moved);
+    std::cout << "}";
+  }
+  std::cout << "],\"summary\":{";
+  const char *labels[2] = {"unchanged", "changed"};
+  for (int k = 0; k < 2; k++) {
+    if (k) std::cout << ",";
+    std::cout << "\"" << labels[k] << "\":{\"frames\":" << count[k]
+              << ",\"meanDraws\":" << (count[k] ? (double)draws[k] / (double)count[k] : 0.0)
+              << ",\"meanPageSwitches\":" << (count[k] ? (double)switches[k] / (double)count[k] : 0.0) << "}";
+  }
+
+  std::vector<size_t> worst(churn.frames.size());
+  for (size_t f = 0; f < worst.size(); f++) worst[f] = f;
+  const std::vector<ChurnFrame> &frames = churn.frames;
+  std::stable_sort(worst.begin(), worst.end(), [&frames](size_t a, size_t b) {
+    const int32_t ja = a ? frames[a].draws - frames[a - 1].draws : 0;
+    const int32_t jb = b ? frames[b].draws - frames[b - 1].draws : 0;
+    return frames[a].draws != frames[b].draws ? frames[a].draws > frames[b].draws : ja > jb;
+  });
+  std::cout << "},\"worstFrames\":[";
+  for (size_t i = 0; i < worst.size() && i < 10; i++) {
+    const ChurnFrame &frame = frames[worst[i]];
+    const int32_t prev_draws = worst[i] ? frames[worst[i] - 1].draws : frame.draws;
+    if (i) std::cout << ",";
+    std::cout << "{\"frame\":" << worst[i] << ",\"time\":" << frame.time << ",\"draws\":" << frame.draws
+              << ",\"drawsDelta\":" << frame.draws - prev_draws << ",\"pageSwitches\":" << frame.page_switches
+              << ",\"drawOrderChanged\":" << (frame.order_changed ? 1 : 0) << ",\"movedSlots\":";
+    print_slot_names(data, frame.moved);
+    std::cout << "}";
+  }
+  std::cout << "]}\n";
+}
+
 int main(int argc, char **argv) {
   if (argc < 4) {
     usage();
@@ -152,14 +693,66 @@ int main(int argc, char **argv) {
   int loop = 1;
   int y_down = 0;
   spine_physics physics = SPINE_PHYSICS_NONE;
+  const char *trace_out = nullptr;
+  float page_usage_fps = 0.0f;
+  bool draw_order_churn = false;
+  RenderSequence sequence;
+  const char *sweep_out = nullptr;
+  float sweep_hz = 30.0f;
+  spine_physics sweep_physics = SPINE_PHYSICS_NONE;
+  int64_t heap_limit = -1;
+  const char *heap_out = nullptr;
 
   // Parse global options first. Scenario commands are parsed later.
   for (int i = 3; i < argc; i++) {
     const char *arg = argv[i];
     if (std::strcmp(arg, "--y-down") == 0 && i + 1 < argc) {
       y_down = std::atoi(argv[++i]) ? 1 : 0;
+    } else if (std::strcmp(arg, "--trace-out") == 0 && i + 1 < argc) {
+      trace_out = argv[++i];
+    } else if (!legacy_mode && std::strcmp(arg, "--draw-order-churn") == 0) {
+      draw_order_churn = true;
+    } else if (!legacy_mode && std::strcmp(arg, "--render-every") == 0 && i + 1 < argc) {
+      sequence.every = std::atoi(argv[++i]);
+      if (sequence.every < 1) {
+        std::cerr << "invalid --render-every: " << argv[i] << "\n";
+        return 2;
+      }
+    } else if (!legacy_mode && std::strcmp(arg, "--render-at") == 0 && i + 1 < argc) {
+      if (!parse_times(argv[++i], sequence.at)) {
+        std::cerr << "invalid --render-at: " << argv[i] << "\n";
+        return 2;
+      }
+    } else if (!legacy_mode && std::strcmp(arg, "--sweep") == 0 && i + 1 < argc) {
+      sweep_out = argv[++i];
+    } else if (!legacy_mode && std::strcmp(arg, "--sweep-hz") == 0 && i + 1 < argc) {
+      sweep_hz = std::strtof(argv[++i], nullptr);
+    } else if (!legacy_mode && std::strcmp(arg, "--heap-guard") == 0 && i + 1 < argc) {
+      heap_limit = std::atoll(argv[++i]);
+      if (heap_limit < 0) {
+        std::cerr << "invalid --heap-guard bytes: " << argv[i] << "\n";
+        return 2;
+      }
+    } else if (!legacy_mode && std::strcmp(arg, "--heap-out") == 0 && i + 1 < argc) {
+      heap_out = argv[++i];
+    } else if (!legacy_mode && std::strcmp(arg, "--physics") == 0 && i + 1 < argc) {
+      // Only read by `--sweep`; in a command stream `--physics` stays positional.
+      if (!parse_physics_mode(argv[++i], sweep_physics)) {
+        std::cerr << "invalid physics mode: " << argv[i] << "\n";
+        return 2;
+      }
     }
   }
+  const bool render_sequence = sequence.every > 0 || !sequence.at.empty();
+  if (render_sequence && draw_order_churn) {
+    std::cerr << "--draw-order-churn cannot be combined with --render-every/--render-at\n";
+    return 2;
+  }
+  if (heap_out && heap_limit < 0) heap_limit = std::numeric_limits<int64_t>::max();
+  if (heap_limit >= 0 && !sweep_out) {
+    std::cerr << "--heap-guard/--heap-out need --sweep\n";
+    return 2;
+  }
 
   if (legacy_mode) {
     for (int i = 3; i < argc; i++) {
@@ -170,17 +763,19 @@ int main(int argc, char **argv) {
         anim = argv[++i];
       } else if (std::strcmp(arg, "--time") == 0 && i + 1 < argc) {
         time = std::strtof(argv[++i], nullptr);
+      } else if (std::strcmp(arg, "--page-usage") == 0 && i + 1 < argc) {
+        page_usage_fps = std::strtof(argv[++i], nullptr);
+        if (!(page_usage_fps > 0.0f)) {
+          std::cerr << "--page-usage needs fps > 0\n";
+          return 2;
+        }
       } else if (std::strcmp(arg, "--loop") == 0 && i + 1 < argc) {
         loop = std::atoi(argv[++i]) ? 1 : 0;
-      } else if (std::strcmp(arg, "--y-down") == 0 && i + 1 < argc) {
+      } else if ((std::strcmp(arg, "--y-down") == 0 || std::strcmp(arg, "--trace-out") == 0) && i + 1 < argc) {
         i += 1;  // already parsed above
       } else if (std::strcmp(arg, "--physics") == 0 && i + 1 < argc) {
         const char *mode = argv[++i];
-        if (std::strcmp(mode, "none") == 0) physics = SPINE_PHYSICS_NONE;
-        else if (std::strcmp(mode, "reset") == 0) physics = SPINE_PHYSICS_RESET;
-        else if (std::strcmp(mode, "update") == 0) physics = SPINE_PHYSICS_UPDATE;
-        else if (std::strcmp(mode, "pose") == 0) physics = SPINE_PHYSICS_POSE;
-        else {
+        if (!parse_physics_mode(mode, physics)) {
           std::cerr << "invalid physics mode: " << mode << "\n";
           return 2;
         }
@@ -198,54 +793,54 @@ int main(int argc, char **argv) {
     }
   }
 
+  TraceRecorder trace;
+  if (trace_out) {
+    trace.origin = BenchClock::now();
+    trace.main_tid = trace_thread_id();
+    g_trace = &trace;
+  }
+
+  if (heap_limit >= 0) heap_hook_install();
+
   spine_bone_set_y_down(y_down ? true : false);
 
-  std::string atlas_text = read_file(atlas_path);
-  spine_atlas_result atlas_result = spine_atlas_load(atlas_text.c_str());
-  if (!atlas_result) {
-    std::cerr << "spine_atlas_load failed\n";
-    return 2;
-  }
-  const char *atlas_err = spine_atlas_result_get_error(atlas_result);
-  if (atlas_err && atlas_err[0]) {
-    std::cerr << "atlas error: " << atlas_err << "\n";
-    return 2;
-  }
-  spine_atlas atlas = spine_atlas_result_get_atlas(atlas_result);
-  if (!atlas) {
-    std::cerr << "missing atlas\n";
-    return 2;
+  spine_atlas_result atlas_result = nullptr;
+  spine_atlas atlas = nullptr;
+  {
+    TraceZone zone("load", "atlas");
+    atlas = load_atlas_or_die(atlas_path, atlas_result);
   }
 
   spine_skeleton_data_result data_result = nullptr;
-  const std::string skeleton_path_s(skeleton_path);
-  if (skeleton_path_s.size() >= 5 &&
-      skeleton_path_s.compare(skeleton_path_s.size() - 5, 5, ".skel") == 0) {
-    std::string bytes = read_file(skeleton_path);
-    data_result = spine_skeleton_data_load_binary(
-        atlas, reinterpret_cast<const uint8_t *>(bytes.data()), (int32_t)bytes.size(), skeleton_path);
-  } else {
-    std::string json_text = read_file(skeleton_path);
-    data_result =
-        spine_skeleton_data_load_json(atlas, json_text.c_str(), skeleton_path);
-  }
-  if (!data_result) {
-    std::cerr << "spine_skeleton_data_load_(json|binary) failed\n";
-    return 2;
-  }
-  const char *skeleton_err = spine_skeleton_data_result_get_error(data_result);
-  if (skeleton_err && skeleton_err[0]) {
-    std::cerr << "skeleton data error: " << skeleton_err << "\n";
-    return 2;
-  }
-  spine_skeleton_data data = spine_skeleton_data_result_get_data(data_result);
-  if (!data) {
-    std::cerr << "missing skeleton data\n";
-    return 2;
+  spine_skeleton_data data = nullptr;
+  {
+    TraceZone zone("load", "skeleton");
+    data = load_skeleton_data_or_die(atlas, skeleton_path, data_result);
   }
 
   spine_bone_set_y_down(y_down ? true : false);
 
+  if (sweep_out) {
+    SweepRender sweep = {y_down, atlas_is_pma(atlas), sweep_physics};
+    HeapGuard heap;
+    heap.limit = heap_limit;
+    if (heap_limit >= 0) heap_guard_begin(heap, "sweep");
+    const int rc = run_animation_skin_sweep(data, sweep_out, sweep_hz, sweep_physics, write_sweep_frame, &sweep);
+    g_heap_guard = nullptr;
+    if (heap_out && !write_heap_report(heap, heap_out, "spine_cpp_lite_render_oracle")) {
+      std::cerr << "failed to write heap report: " << heap_out << "\n";
+      return 2;
+    }
+    spine_skeleton_data_result_dispose(data_result);
+    spine_atlas_dispose(atlas);
+    spine_atlas_result_dispose(atlas_result);
+    if (rc == 0 && trace_out && !write_trace(trace, trace_out, "spine_cpp_lite_render_oracle")) {
+      std::cerr << "failed to write trace: " << trace_out << "\n";
+      return 2;
+    }
+    return rc;
+  }
+
   spine_skeleton_drawable drawable = spine_skeleton_drawable_create(data);
   if (!drawable) {
     std::cerr << "spine_skeleton_drawable_create failed\n";
@@ -261,10 +856,22 @@ int main(int argc, char **argv) {
   }
 
   float total_time = 0.0f;
-  spine_track_entry last_entry = nullptr;
 
   spine_skeleton_setup_pose(skeleton);
 
+  if (legacy_mode && page_usage_fps > 0.0f) {
+    const int rc = run_page_usage(atlas, data, drawable, skin, anim, loop, time, page_usage_fps, physics);
+    spine_skeleton_drawable_dispose(drawable);
+    spine_skeleton_data_result_dispose(data_result);
+    spine_atlas_dispose(atlas);
+    spine_atlas_result_dispose(atlas_result);
+    if (rc == 0 && trace_out && !write_trace(trace, trace_out, "spine_cpp_lite_render_oracle")) {
+      std::cerr << "failed to write trace: " << trace_out << "\n";
+      return 2;
+    }
+    return rc;
+  }
+
   if (legacy_mode) {
     if (skin) {
       if (std::strcmp(skin, "none") == 0) {
@@ -283,233 +890,58 @@ int main(int argc, char **argv) {
     spine_skeleton_update_world_transform(skeleton, physics);
     total_time = time;
   } else {
-    for (int i = 3; i < argc; i++) {
-      const char *arg = argv[i];
-
-      if (std::strcmp(arg, "--y-down") == 0) {
-        i++;  // already processed above
-        continue;
-      }
-
-      if (std::strcmp(arg, "--set-skin") == 0 && i + 1 < argc) {
-        const char *name = argv[i + 1];
-        if (std::strcmp(name, "none") == 0) spine_skeleton_set_skin_2(skeleton, nullptr);
-        else spine_skeleton_set_skin_1(skeleton, name);
-        spine_skeleton_update_cache(skeleton);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--mix") == 0 && i + 3 < argc) {
-        const char *from_name = argv[i + 1];
-        const char *to_name = argv[i + 2];
-        const float duration = std::strtof(argv[i + 3], nullptr);
-        spine_animation_state_data_set_mix_1(state_data, from_name, to_name, duration);
-        i += 3;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--physics") == 0 && i + 1 < argc) {
-        const char *mode = argv[i + 1];
-        if (std::strcmp(mode, "none") == 0) physics = SPINE_PHYSICS_NONE;
-        else if (std::strcmp(mode, "reset") == 0) physics = SPINE_PHYSICS_RESET;
-        else if (std::strcmp(mode, "update") == 0) physics = SPINE_PHYSICS_UPDATE;
-        else if (std::strcmp(mode, "pose") == 0) physics = SPINE_PHYSICS_POSE;
-        else {
-          std::cerr << "invalid physics mode: " << mode << "\n";
-          return 2;
-        }
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--set") == 0 && i + 3 < argc) {
-        const size_t track = (size_t)std::atoi(argv[i + 1]);
-        const char *name = argv[i + 2];
-        const bool looped = std::atoi(argv[i + 3]) ? true : false;
-        last_entry = spine_animation_state_set_animation_1(state, track, name, looped);
-        i += 3;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--add") == 0 && i + 4 < argc) {
-        const size_t track = (size_t)std::atoi(argv[i + 1]);
-        const char *name = argv[i + 2];
-        const bool looped = std::atoi(argv[i + 3]) ? true : false;
-        const float delay = std::strtof(argv[i + 4], nullptr);
-        last_entry = spine_animation_state_add_animation_1(state, track, name, looped, delay);
-        i += 4;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--set-empty") == 0 && i + 2 < argc) {
-        const size_t track = (size_t)std::atoi(argv[i + 1]);
-        const float mix = std::strtof(argv[i + 2], nullptr);
-        last_entry = spine_animation_state_set_empty_animation(state, track, mix);
-        i += 2;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--add-empty") == 0 && i + 3 < argc) {
-        const size_t track = (size_t)std::atoi(argv[i + 1]);
-        const float mix = std::strtof(argv[i + 2], nullptr);
-        const float delay = std::strtof(argv[i + 3], nullptr);
-        last_entry = spine_animation_state_add_empty_animation(state, track, mix, delay);
-        i += 3;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-alpha") == 0 && i + 1 < argc) {
-        if (!last_entry) {
-          std::cerr << "--entry-alpha requires a preceding --set/--add command\n";
-          return 2;
-        }
-        const float alpha = std::strtof(argv[i + 1], nullptr);
-        spine_track_entry_set_alpha(last_entry, alpha);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-event-threshold") == 0 && i + 1 < argc) {
-        if (!last_entry) {
-          std::cerr << "--entry-event-threshold requires a preceding --set/--add command\n";
-          return 2;
-        }
-        const float threshold = std::strtof(argv[i + 1], nullptr);
-        spine_track_entry_set_event_threshold(last_entry, threshold);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-alpha-attachment-threshold") == 0 && i + 1 < argc) {
-        if (!last_entry) {
-          std::cerr << "--entry-alpha-attachment-threshold requires a preceding --set/--add command\n";
-          return 2;
-        }
-        const float threshold = std::strtof(argv[i + 1], nullptr);
-        spine_track_entry_set_alpha_attachment_threshold(last_entry, threshold);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-mix-attachment-threshold") == 0 && i + 1 < argc) {
-        if (!last_entry) {
-          std::cerr << "--entry-mix-attachment-threshold requires a preceding --set/--add command\n";
-          return 2;
-        }
-        const float threshold = std::strtof(argv[i + 1], nullptr);
-        spine_track_entry_set_mix_attachment_threshold(last_entry, threshold);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-mix-draw-order-threshold") == 0 && i + 1 < argc) {
-        if (!last_entry) {
-          std::cerr << "--entry-mix-draw-order-threshold requires a preceding --set/--add command\n";
-          return 2;
-        }
-        const float threshold = std::strtof(argv[i + 1], nullptr);
-        spine_track_entry_set_mix_draw_order_threshold(last_entry, threshold);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-hold-previous") == 0 && i + 1 < argc) {
-        if (!last_entry) {
-          std::cerr << "--entry-hold-previous requires a preceding --set/--add command\n";
-          return 2;
-        }
-        const bool hold = std::atoi(argv[i + 1]) ? true : false;
-        spine_track_entry_set_hold_previous(last_entry, hold);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-mix-blend") == 0 && i + 1 < argc) {
-        if (!last_entry) {
-          std::cerr << "--entry-mix-blend requires a preceding --set/--add command\n";
-          return 2;
-        }
-        const char *blend = argv[i + 1];
-        spine_mix_blend mix_blend = SPINE_MIX_BLEND_REPLACE;
-        if (std::strcmp(blend, "setup") == 0) mix_blend = SPINE_MIX_BLEND_SETUP;
-        else if (std::strcmp(blend, "first") == 0) mix_blend = SPINE_MIX_BLEND_FIRST;
-        else if (std::strcmp(blend, "replace") == 0) mix_blend = SPINE_MIX_BLEND_REPLACE;
-        else if (std::strcmp(blend, "add") == 0) mix_blend = SPINE_MIX_BLEND_ADD;
-        else {
-          std::cerr << "invalid mix blend: " << blend << "\n";
-          return 2;
-        }
-        spine_track_entry_set_mix_blend(last_entry, mix_blend);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-reverse") == 0 && i + 1 < argc) {
-        if (!last_entry) {
-          std::cerr << "--entry-reverse requires a preceding --set/--add command\n";
-          return 2;
-        }
-        const bool reverse = std::atoi(argv[i + 1]) ? true : false;
-        spine_track_entry_set_reverse(last_entry, reverse);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-shortest-rotation") == 0 && i + 1 < argc) {
-        if (!last_entry) {
-          std::cerr << "--entry-shortest-rotation requires a preceding --set/--add command\n";
-          return 2;
-        }
-        const bool shortest = std::atoi(argv[i + 1]) ? true : false;
-        spine_track_entry_set_shortest_rotation(last_entry, shortest);
-        i += 1;
-        continue;
-      }
-
-      if (std::strcmp(arg, "--entry-reset-rotation-directions") == 0) {
-        if (!last_entry) {
-          std::cerr << "--entry-reset-rotation-directions requires a preceding --set/--add command\n";
-          return 2;
-        }
-        spine_track_entry_reset_rotation_directions(last_entry);
-        continue;
+    ScenarioRun run = scenario_run_for(drawable);
+    run.physics = physics;
+    DrawOrderChurn churn;
+    if (draw_order_churn) {
+      churn.order = draw_order_slots(skeleton);
+      run.step_hook = churn_step;
+      run.step_context = &churn;
+    } else if (render_sequence) {
+      sequence.y_down = y_down;
+      sequence.pma = atlas_is_pma(atlas);
+      run.step_hook = sequence_step;
+      run.step_context = &sequence;
+    }
+    TraceZone zone("scenario", "commands");
+    const int rc = run_scenario_commands(argc, argv, run, render_option_arity, usage);
+    if (rc != 0) return rc;
+    if (render_sequence && sequence.next_at < sequence.at.size()) {
+      std::cerr << "--render-at times past the scenario end (" << run.total_time << "):";
+      for (size_t k = sequence.next_at; k < sequence.at.size(); k++) std::cerr << " " << sequence.at[k];
+      std::cerr << "\n";
+      return 2;
+    }
+    if (draw_order_churn || render_sequence) {
+      if (draw_order_churn) {
+        TraceZone serialize_zone("output", "serialize");
+        print_draw_order_churn(data, churn);
       }
-
-      if (std::strcmp(arg, "--step") == 0 && i + 1 < argc) {
-        const float dt = std::strtof(argv[i + 1], nullptr);
-        spine_animation_state_update(state, dt);
-        spine_animation_state_apply(state, skeleton);
-        spine_skeleton_update(skeleton, dt);
-        spine_skeleton_update_world_transform(skeleton, physics);
-        total_time += dt;
-        i += 1;
-        continue;
+      spine_skeleton_drawable_dispose(drawable);
+      spine_skeleton_data_result_dispose(data_result);
+      spine_atlas_dispose(atlas);
+      spine_atlas_result_dispose(atlas_result);
+      if (trace_out && !write_trace(trace, trace_out, "spine_cpp_lite_render_oracle")) {
+        std::cerr << "failed to write trace: " << trace_out << "\n";
+        return 2;
       }
-
-      std::cerr << "unknown/invalid command: " << arg << "\n";
-      usage();
-      return 2;
+      return 0;
     }
+    physics = run.physics;
+    total_time = run.total_time;
 
     anim = "<scenario>";
     time = total_time;
   }
 
-  spine_render_command cmd = spine_skeleton_drawable_render(drawable);
-
-  bool premultipliedAlpha = false;
+  spine_render_command cmd = nullptr;
   {
-    spine_array_atlas_page pages = spine_atlas_get_pages(atlas);
-    const size_t n = spine_array_atlas_page_size(pages);
-    spine_atlas_page *buf = spine_array_atlas_page_buffer(pages);
-    for (size_t i = 0; i < n; i++) {
-      if (spine_atlas_page_get_pma(buf[i])) {
-        premultipliedAlpha = true;
-        break;
-      }
-    }
+    TraceZone zone("render", "render");
+    cmd = spine_skeleton_drawable_render(drawable);
   }
+  const BenchClock::time_point serialize_start = g_trace ? BenchClock::now() : BenchClock::time_point();
+
+  const bool premultipliedAlpha = atlas_is_pma(atlas);
 
   std::cout << "{";
   std::cout << "\"mode\":\"" << (legacy_mode ? "legacy" : "scenario") << "\",";
@@ -523,83 +955,19 @@ int main(int argc, char **argv) {
   }
   std::cout << "\"anim\":\"" << json_escape(anim) << "\",";
   std::cout << "\"time\":" << time << ",";
-  std::cout << "\"draws\":[";
-
-  bool first_cmd = true;
-  while (cmd) {
-    const int32_t page = (int32_t)(intptr_t)spine_render_command_get_texture(cmd);
-    const spine_blend_mode blend = spine_render_command_get_blend_mode(cmd);
-    const int32_t num_vertices = spine_render_command_get_num_vertices(cmd);
-    const int32_t num_indices = spine_render_command_get_num_indices(cmd);
-
-    float *positions = spine_render_command_get_positions(cmd);
-    float *uvs = spine_render_command_get_uvs(cmd);
-    uint32_t *colors = spine_render_command_get_colors(cmd);
-    uint32_t *dark_colors = spine_render_command_get_dark_colors(cmd);
-    uint16_t *indices = spine_render_command_get_indices(cmd);
-
-    if (!first_cmd) std::cout << ",";
-    first_cmd = false;
-
-    std::cout << "{";
-    std::cout << "\"page\":" << page << ",";
-    std::cout << "\"blend\":\"" << blend_mode_name(blend) << "\",";
-    std::cout << "\"num_vertices\":" << num_vertices << ",";
-    std::cout << "\"num_indices\":" << num_indices << ",";
-
-    std::cout << "\"positions\":[";
-    for (int32_t i = 0; i < num_vertices * 2; i++) {
-      if (i) std::cout << ",";
-      std::cout << positions[i];
-    }
-    std::cout << "],";
-
-    std::cout << "\"uvs\":[";
-    for (int32_t i = 0; i < num_vertices * 2; i++) {
-      if (i) std::cout << ",";
-      std::cout << uvs[i];
-    }
-    std::cout << "],";
-
-    std::cout << "\"colors\":[";
-    for (int32_t i = 0; i < num_vertices; i++) {
-      if (i) std::cout << ",";
-      uint32_t c = (uint32_t)colors[i];
-      if (premultipliedAlpha) c = premultiply_packed_aarrggbb(c);
-      std::cout << c;
-    }
-    std::cout << "],";
-
-    std::cout << "\"dark_colors\":[";
-    for (int32_t i = 0; i < num_vertices; i++) {
-      if (i) std::cout << ",";
-      uint32_t light = (uint32_t)colors[i];
-      if (premultipliedAlpha) light = premultiply_packed_aarrggbb(light);
-      uint32_t dark = (uint32_t)dark_colors[i];
-      dark = adjust_dark_color_for_shader(dark, (uint32_t)colors[i], premultipliedAlpha);
-      std::cout << dark;
-    }
-    std::cout << "],";
-
-    std::cout << "\"indices\":[";
-    for (int32_t i = 0; i < num_indices; i++) {
-      if (i) std::cout << ",";
-      std::cout << indices[i];
-    }
-    std::cout << "]";
-
-    std::cout << "}";
-
-    cmd = spine_render_command_get_next(cmd);
-  }
-
-  std::cout << "]}";
+  print_draws(cmd, premultipliedAlpha);
+  std::cout << "}";
   std::cout << "\n";
+  trace_complete("output", "serialize", serialize_start, BenchClock::now());
 
   spine_skeleton_drawable_dispose(drawable);
   spine_skeleton_data_result_dispose(data_result);
   spine_atlas_dispose(atlas);
   spine_atlas_result_dispose(atlas_result);
 
+  if (trace_out && !write_trace(trace, trace_out, "spine_cpp_lite_render_oracle")) {
+    std::cerr << "failed to write trace: " << trace_out << "\n";
+    return 2;
+  }
   return 0;
 }
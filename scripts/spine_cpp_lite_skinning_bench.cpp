@@ -0,0 +1,486 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SKINNING_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define SKINNING_NEON 1
+#endif
+
+#include "spine-c.h"
+#include "spine_cpp_lite_oracle_core.h"
+
+// Reference weighted-mesh skinning kernels on a structure-of-arrays layout, checked per vertex
+// against spine-cpp's `VertexAttachment::computeWorldVertices` (via
+// `spine_vertex_attachment_compute_world_vertices_1`) and timed over every weighted vertex
+// attachment in the posed skeleton. Input for porting a SIMD path to `spine2d/src/geometry.rs`.
+
+static void usage() {
+  std::cerr
+      << "Usage:\n"
+         "  spine_cpp_lite_skinning_bench <atlas.atlas> <skeleton.(json|skel)> [--y-down 0|1]\n"
+         "                                [--iterations <n>] [--tolerance-ulps <n>] [--tolerance-abs <x>]\n"
+         "                                <commands...>\n"
+         "\n"
+         "Poses the skeleton with the usual scenario commands (`--set`, `--step`, ...; see\n"
+         "spine_cpp_lite_oracle), then benchmarks skinning of every weighted vertex attachment:\n"
+         "  computeWorldVertices   spine-cpp scalar path (one call per attachment)\n"
+         "  soaScalar              SoA layout, plain C++\n"
+         "  sse / avx2 / neon      SoA layout, 4/8-lane SIMD (when supported by the target/CPU)\n"
+         "\n"
+         "  --iterations <n>       timed frames per kernel (default 200, after 10% warmup)\n"
+         "  --tolerance-ulps <n>   per-component parity tolerance vs computeWorldVertices (default 4)\n"
+         "  --tolerance-abs <x>    absolute difference that always passes, for results near zero where\n"
+         "                         a few ULPs are meaningless (default 1e-4)\n";
+}
+
+static int skinning_option_arity(const char *arg) {
+  if (std::strcmp(arg, "--iterations") == 0 || std::strcmp(arg, "--tolerance-ulps") == 0) return 1;
+  if (std::strcmp(arg, "--tolerance-abs") == 0) return 1;
+  return -1;
+}
+
+// Bone world matrices for the whole skeleton, one array per component.
+struct BoneSoA {
+  std::vector<float> a, b, c, d, x, y;
+};
+
+static void pack_bones(spine_skeleton skeleton, BoneSoA &out) {
+  spine_array_bone bones = spine_skeleton_get_bones(skeleton);
+  const size_t nb = spine_array_bone_size(bones);
+  spine_bone *buf = spine_array_bone_buffer(bones);
+  out.a.resize(nb);
+  out.b.resize(nb);
+  out.c.resize(nb);
+  out.d.resize(nb);
+  out.x.resize(nb);
+  out.y.resize(nb);
+  for (size_t i = 0; i < nb; i++) {
+    spine_bone_pose pose = spine_bone_get_applied_pose(buf[i]);
+    out.a[i] = spine_bone_pose_get_a(pose);
+    out.b[i] = spine_bone_pose_get_b(pose);
+    out.c[i] = spine_bone_pose_get_c(pose);
+    out.d[i] = spine_bone_pose_get_d(pose);
+    out.x[i] = spine_bone_pose_get_world_x(pose);
+    out.y[i] = spine_bone_pose_get_world_y(pose);
+  }
+}
+
+// One weighted vertex attachment. Influence `j` of vertex `v` lives at `j * padded + v`; vertices
+// with fewer than `max_influences` influences (and the lanes past `vertices`) are padded with
+// bone 0 / weight 0, which adds an exact zero after the real influences and so keeps the
+// per-vertex summation order of the scalar path.
+struct SkinningLayout {
+  spine_slot slot;
+  spine_vertex_attachment attachment;
+  std::string slot_name;
+  std::string attachment_name;
+  int world_length;  // floats written by computeWorldVertices
+  int vertices;
+  int padded;
+  int max_influences;
+  int influences;
+  std::vector<int32_t> bone;
+  std::vector<int32_t> deform;  // influence index into the slot's deform pairs
+  std::vector<float> vx, vy, w;
+  std::vector<float> ox, oy;
+};
+
+static const int kLanePad = 8;
+
+static bool build_layout(spine_slot slot, spine_vertex_attachment va, SkinningLayout &m) {
+  spine_array_int bones_arr = spine_vertex_attachment_get_bones(va);
+  const size_t nbones = spine_array_int_size(bones_arr);
+  if (nbones == 0) return false;  // unweighted: single bone affine, not a skinning workload
+  const int32_t *bones = spine_array_int_buffer(bones_arr);
+  spine_array_float verts_arr = spine_vertex_attachment_get_vertices(va);
+  const float *verts = spine_array_float_buffer(verts_arr);
+
+  m.slot = slot;
+  m.attachment = va;
+  m.world_length = (int)spine_vertex_attachment_get_world_vertices_length(va);
+  m.vertices = m.world_length / 2;
+  m.padded = (m.vertices + kLanePad - 1) / kLanePad * kLanePad;
+  m.max_influences = 0;
+  m.influences = 0;
+  for (size_t v = 0; v < nbones;) {
+    const int n = bones[v];
+    m.max_influences = n > m.max_influences ? n : m.max_influences;
+    m.influences += n;
+    v += (size_t)n + 1;
+  }
+
+  const size_t total = (size_t)m.max_influences * (size_t)m.padded;
+  m.bone.assign(total, 0);
+  m.deform.assign(total, 0);
+  m.vx.assign(total, 0.0f);
+  m.vy.assign(total, 0.0f);
+  m.w.assign(total, 0.0f);
+  m.ox.assign((size_t)m.padded, 0.0f);
+  m.oy.assign((size_t)m.padded, 0.0f);
+
+  size_t v = 0;
+  int b = 0;
+  for (int vi = 0; vi < m.vertices && v < nbones; vi++) {
+    const int n = bones[v++];
+    for (int j = 0; j < n; j++, b++) {
+      const size_t k = (size_t)j * (size_t)m.padded + (size_t)vi;
+      m.bone[k] = bones[v++];
+      m.deform[k] = b;
+      m.vx[k] = verts[b * 3];
+      m.vy[k] = verts[b * 3 + 1];
+      m.w[k] = verts[b * 3 + 2];
+    }
+  }
+  return true;
+}
+
+static const float *slot_deform(spine_slot slot) {
+  spine_array_float deform = spine_slot_pose_get_deform(spine_slot_get_applied_pose(slot));
+  return spine_array_float_size(deform) ? spine_array_float_buffer(deform) : nullptr;
+}
+
+static void skin_soa_scalar(SkinningLayout &m, const BoneSoA &bs, const float *deform) {
+  for (int v = 0; v < m.vertices; v++) {
+    float wx = 0.0f, wy = 0.0f;
+    for (int j = 0; j < m.max_influences; j++) {
+      const size_t k = (size_t)j * (size_t)m.padded + (size_t)v;
+      const int32_t bi = m.bone[k];
+      float x = m.vx[k], y = m.vy[k];
+      if (deform) {
+        x = x + deform[m.deform[k] * 2];
+        y = y + deform[m.deform[k] * 2 + 1];
+      }
+      wx += (x * bs.a[bi] + y * bs.b[bi] + bs.x[bi]) * m.w[k];
+      wy += (x * bs.c[bi] + y * bs.d[bi] + bs.y[bi]) * m.w[k];
+    }
+    m.ox[v] = wx;
+    m.oy[v] = wy;
+  }
+}
+
+#if defined(SKINNING_X86)
+static inline __m128 gather4(const float *base, const int32_t *idx) {
+  return _mm_set_ps(base[idx[3]], base[idx[2]], base[idx[1]], base[idx[0]]);
+}
+
+static void skin_sse(SkinningLayout &m, const BoneSoA &bs, const float *deform) {
+  for (int v = 0; v < m.padded; v += 4) {
+    __m128 wx = _mm_setzero_ps(), wy = _mm_setzero_ps();
+    for (int j = 0; j < m.max_influences; j++) {
+      const size_t k = (size_t)j * (size_t)m.padded + (size_t)v;
+      const int32_t *bi = &m.bone[k];
+      __m128 x = _mm_loadu_ps(&m.vx[k]);
+      __m128 y = _mm_loadu_ps(&m.vy[k]);
+      if (deform) {
+        const int32_t *di = &m.deform[k];
+        x = _mm_add_ps(x, _mm_set_ps(deform[di[3] * 2], deform[di[2] * 2], deform[di[1] * 2], deform[di[0] * 2]));
+        y = _mm_add_ps(y, _mm_set_ps(deform[di[3] * 2 + 1], deform[di[2] * 2 + 1], deform[di[1] * 2 + 1],
+                                     deform[di[0] * 2 + 1]));
+      }
+      const __m128 w = _mm_loadu_ps(&m.w[k]);
+      const __m128 tx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, gather4(bs.a.data(), bi)), _mm_mul_ps(y, gather4(bs.b.data(), bi))),
+                                   gather4(bs.x.data(), bi));
+      const __m128 ty = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, gather4(bs.c.data(), bi)), _mm_mul_ps(y, gather4(bs.d.data(), bi))),
+                                   gather4(bs.y.data(), bi));
+      wx = _mm_add_ps(wx, _mm_mul_ps(tx, w));
+      wy = _mm_add_ps(wy, _mm_mul_ps(ty, w));
+    }
+    _mm_storeu_ps(&m.ox[v], wx);
+    _mm_storeu_ps(&m.oy[v], wy);
+  }
+}
+
+// No `fma` in the target list on purpose: the kernel keeps separate mul+add like spine-cpp's
+// scalar path in the default profiles. Under `o3-native` the compiler may contract that path to
+// FMA, which the parity tolerances absorb.
+__attribute__((target("avx2"))) static void skin_avx2(SkinningLayout &m, const BoneSoA &bs, const float *deform) {
+  for (int v = 0; v < m.padded; v += 8) {
+    __m256 wx = _mm256_setzero_ps(), wy = _mm256_setzero_ps();
+    for (int j = 0; j < m.max_influences; j++) {
+      const size_t k = (size_t)j * (size_t)m.padded + (size_t)v;
+      const __m256i bi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&m.bone[k]));
+      __m256 x = _mm256_loadu_ps(&m.vx[k]);
+      __m256 y = _mm256_loadu_ps(&m.vy[k]);
+      if (deform) {
+        const __m256i di = _mm256_slli_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(&m.deform[k])), 1);
+        x = _mm256_add_ps(x, _mm256_i32gather_ps(deform, di, 4));
+        y = _mm256_add_ps(y, _mm256_i32gather_ps(deform + 1, di, 4));
+      }
+      const __m256 w = _mm256_loadu_ps(&m.w[k]);
+      const __m256 tx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_i32gather_ps(bs.a.data(), bi, 4)),
+                                                    _mm256_mul_ps(y, _mm256_i32gather_ps(bs.b.data(), bi, 4))),
+                                      _mm256_i32gather_ps(bs.x.data(), bi, 4));
+      const __m256 ty = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_i32gather_ps(bs.c.data(), bi, 4)),
+                                                    _mm256_mul_ps(y, _mm256_i32gather_ps(bs.d.data(), bi, 4))),
+                                      _mm256_i32gather_ps(bs.y.data(), bi, 4));
+      wx = _mm256_add_ps(wx, _mm256_mul_ps(tx, w));
+      wy = _mm256_add_ps(wy, _mm256_mul_ps(ty, w));
+    }
+    _mm256_storeu_ps(&m.ox[v], wx);
+    _mm256_storeu_ps(&m.oy[v], wy);
+  }
+}
+#endif
+
+#if defined(SKINNING_NEON)
+static inline float32x4_t gather4(const float *base, const int32_t *idx) {
+  const float lanes[4] = {base[idx[0]], base[idx[1]], base[idx[2]], base[idx[3]]};
+  return vld1q_f32(lanes);
+}
+
+static void skin_neon(SkinningLayout &m, const BoneSoA &bs, const float *deform) {
+  for (int v = 0; v < m.padded; v += 4) {
+    float32x4_t wx = vdupq_n_f32(0.0f), wy = vdupq_n_f32(0.0f);
+    for (int j = 0; j < m.max_influences; j++) {
+      const size_t k = (size_t)j * (size_t)m.padded + (size_t)v;
+      const int32_t *bi = &m.bone[k];
+      float32x4_t x = vld1q_f32(&m.vx[k]);
+      float32x4_t y = vld1q_f32(&m.vy[k]);
+      if (deform) {
+        const int32_t *di = &m.deform[k];
+        const float dx[4] = {deform[di[0] * 2], deform[di[1] * 2], deform[di[2] * 2], deform[di[3] * 2]};
+        const float dy[4] = {deform[di[0] * 2 + 1], deform[di[1] * 2 + 1], deform[di[2] * 2 + 1], deform[di[3] * 2 + 1]};
+        x = vaddq_f32(x, vld1q_f32(dx));
+        y = vaddq_f32(y, vld1q_f32(dy));
+      }
+      const float32x4_t w = vld1q_f32(&m.w[k]);
+      const float32x4_t tx =
+          vaddq_f32(vaddq_f32(vmulq_f32(x, gather4(bs.a.data(), bi)), vmulq_f32(y, gather4(bs.b.data(), bi))),
+                    gather4(bs.x.data(), bi));
+      const float32x4_t ty =
+          vaddq_f32(vaddq_f32(vmulq_f32(x, gather4(bs.c.data(), bi)), vmulq_f32(y, gather4(bs.d.data(), bi))),
+                    gather4(bs.y.data(), bi));
+      wx = vaddq_f32(wx, vmulq_f32(tx, w));
+      wy = vaddq_f32(wy, vmulq_f32(ty, w));
+    }
+    vst1q_f32(&m.ox[v], wx);
+    vst1q_f32(&m.oy[v], wy);
+  }
+}
+#endif
+
+typedef void (*SkinKernel)(SkinningLayout &, const BoneSoA &, const float *);
+
+struct KernelInfo {
+  const char *name;
+  SkinKernel fn;
+  bool supported;
+};
+
+static int64_t ulp_distance(float a, float b) {
+  if (a == b) return 0;
+  if (std::isnan(a) || std::isnan(b)) return std::numeric_limits<int32_t>::max();
+  int32_t ia, ib;
+  std::memcpy(&ia, &a, sizeof(ia));
+  std::memcpy(&ib, &b, sizeof(ib));
+  // Map sign-magnitude to a monotonic integer line.
+  const int64_t la = ia < 0 ? (int64_t)INT32_MIN - ia : ia;
+  const int64_t lb = ib < 0 ? (int64_t)INT32_MIN - ib : ib;
+  return la > lb ? la - lb : lb - la;
+}
+
+struct Parity {
+  int64_t max_ulps = 0;
+  double max_abs = 0.0;
+  int64_t mismatches = 0;  // components beyond both tolerances
+};
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    usage();
+    return 2;
+  }
+
+  std::cout << std::setprecision(std::numeric_limits<float>::max_digits10);
+
+  const char *atlas_path = argv[1];
+  const char *skeleton_path = argv[2];
+
+  int y_down = 0;
+  int iterations = 200;
+  int64_t tolerance_ulps = 4;
+  double tolerance_abs = 1e-4;
+  for (int i = 3; i < argc; i++) {
+    if (std::strcmp(argv[i], "--y-down") == 0 && i + 1 < argc) {
+      y_down = std::atoi(argv[++i]) ? 1 : 0;
+    } else if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+      iterations = std::atoi(argv[++i]);
+      if (iterations < 1) {
+        std::cerr << "invalid --iterations: " << argv[i] << "\n";
+        return 2;
+      }
+    } else if (std::strcmp(argv[i], "--tolerance-ulps") == 0 && i + 1 < argc) {
+      tolerance_ulps = std::atoll(argv[++i]);
+      if (tolerance_ulps < 0) {
+        std::cerr << "invalid --tolerance-ulps: " << argv[i] << "\n";
+        return 2;
+      }
+    } else if (std::strcmp(argv[i], "--tolerance-abs") == 0 && i + 1 < argc) {
+      tolerance_abs = std::atof(argv[++i]);
+      if (!(tolerance_abs >= 0.0)) {
+        std::cerr << "invalid --tolerance-abs: " << argv[i] << "\n";
+        return 2;
+      }
+    }
+  }
+
+  spine_bone_set_y_down(y_down ? true : false);
+
+  spine_atlas_result atlas_result = nullptr;
+  spine_atlas atlas = load_atlas_or_die(atlas_path, atlas_result);
+  spine_skeleton_data_result data_result = nullptr;
+  spine_skeleton_data data = load_skeleton_data_or_die(atlas, skeleton_path, data_result);
+
+  spine_skeleton_drawable drawable = spine_skeleton_drawable_create(data);
+  if (!drawable) {
+    std::cerr << "spine_skeleton_drawable_create failed\n";
+    return 2;
+  }
+  ScenarioRun run = scenario_run_for(drawable);
+  spine_skeleton_setup_pose(run.skeleton);
+  const int rc = run_scenario_commands(argc, argv, run, skinning_option_arity, usage);
+  if (rc != 0) return rc;
+  spine_skeleton skeleton = run.skeleton;
+
+  std::vector<SkinningLayout> layouts;
+  int unweighted = 0;
+  {
+    spine_array_slot slots = spine_skeleton_get_slots(skeleton);
+    const size_t ns = spine_array_slot_size(slots);
+    spine_slot *slots_buf = spine_array_slot_buffer(slots);
+    for (size_t i = 0; i < ns; i++) {
+      spine_slot slot = slots_buf[i];
+      spine_attachment att = spine_slot_pose_get_attachment(spine_slot_get_applied_pose(slot));
+      if (!att) continue;
+      const spine_rtti rt = spine_attachment_get_rtti(att);
+      const bool is_vertex = spine_rtti_instance_of(rt, spine_mesh_attachment_rtti()) ||
+                             spine_rtti_instance_of(rt, spine_path_attachment_rtti()) ||
+                             spine_rtti_instance_of(rt, spine_bounding_box_attachment_rtti()) ||
+                             spine_rtti_instance_of(rt, spine_clipping_attachment_rtti());
+      if (!is_vertex) continue;
+      SkinningLayout m;
+      if (!build_layout(slot, spine_attachment_cast_to_vertex_attachment(att), m)) {
+        unweighted++;
+        continue;
+      }
+      spine_slot_data sd = spine_slot_get_data(slot);
+      m.slot_name = sd ? spine_slot_data_get_name(sd) : "<unknown>";
+      m.attachment_name = spine_attachment_get_name(att) ? spine_attachment_get_name(att) : "";
+      layouts.push_back(m);
+    }
+  }
+
+  int64_t total_vertices = 0;
+  int64_t total_influences = 0;
+  std::vector<std::vector<float>> reference(layouts.size());
+  for (size_t i = 0; i < layouts.size(); i++) {
+    total_vertices += layouts[i].vertices;
+    total_influences += layouts[i].influences;
+    reference[i].assign((size_t)layouts[i].world_length, 0.0f);
+  }
+
+  // `computeWorldVertices` is both the reference output and the baseline timing.
+  const int warmup = iterations / 10 + 1;
+  std::vector<int64_t> samples;
+  samples.reserve((size_t)iterations);
+  for (int it = -warmup; it < iterations; it++) {
+    const BenchClock::time_point t0 = BenchClock::now();
+    for (size_t i = 0; i < layouts.size(); i++) {
+      SkinningLayout &m = layouts[i];
+      spine_vertex_attachment_compute_world_vertices_1(
+          m.attachment, skeleton, m.slot, 0, (size_t)m.world_length, reference[i].data(), 0, 2);
+    }
+    const BenchClock::time_point t1 = BenchClock::now();
+    if (it >= 0) samples.push_back(elapsed_ns(t0, t1));
+  }
+  const int64_t reference_ns = percentile_ns(samples, 0.5);
+
+  std::vector<KernelInfo> kernels;
+  kernels.push_back({"soaScalar", skin_soa_scalar, true});
+#if defined(SKINNING_X86)
+  kernels.push_back({"sse", skin_sse, true});
+  kernels.push_back({"avx2", skin_avx2, __builtin_cpu_supports("avx2") != 0});
+#elif defined(SKINNING_NEON)
+  kernels.push_back({"neon", skin_neon, true});
+#endif
+
+  std::cout << "{\"mode\":\"skinning-bench\",\"iterations\":" << iterations << ",\"toleranceUlps\":" << tolerance_ulps
+            << ",\"toleranceAbs\":" << tolerance_abs << ",\"attachments\":[";
+  for (size_t i = 0; i < layouts.size(); i++) {
+    const SkinningLayout &m = layouts[i];
+    if (i) std::cout << ",";
+    std::cout << "{\"slot\":\"" << json_escape(m.slot_name.c_str()) << "\",\"attachment\":\""
+              << json_escape(m.attachment_name.c_str()) << "\",\"vertices\":" << m.vertices
+              << ",\"influences\":" << m.influences << ",\"maxInfluences\":" << m.max_influences
+              << ",\"deformed\":" << (slot_deform(m.slot) ? 1 : 0) << "}";
+  }
+  std::cout << "],\"unweightedSkipped\":" << unweighted << ",\"vertices\":" << total_vertices
+            << ",\"influences\":" << total_influences << ",\"kernels\":{";
+
+  const double reference_s = (double)reference_ns * 1e-9;
+  std::cout << "\"computeWorldVertices\":{\"p50Ns\":" << reference_ns
+            << ",\"verticesPerSec\":" << (reference_s > 0.0 ? (double)total_vertices / reference_s : 0.0)
+            << ",\"speedup\":1}";
+
+  bool parity_ok = true;
+  BoneSoA bones;
+  for (size_t ki = 0; ki < kernels.size(); ki++) {
+    const KernelInfo &k = kernels[ki];
+    std::cout << ",\"" << k.name << "\":";
+    if (!k.supported) {
+      std::cout << "null";
+      continue;
+    }
+
+    // Bone packing is part of every frame: a real port would repack after each world update.
+    samples.clear();
+    for (int it = -warmup; it < iterations; it++) {
+      const BenchClock::time_point t0 = BenchClock::now();
+      pack_bones(skeleton, bones);
+      for (size_t i = 0; i < layouts.size(); i++) k.fn(layouts[i], bones, slot_deform(layouts[i].slot));
+      const BenchClock::time_point t1 = BenchClock::now();
+      if (it >= 0) samples.push_back(elapsed_ns(t0, t1));
+    }
+    const int64_t p50 = percentile_ns(samples, 0.5);
+
+    Parity parity;
+    for (size_t i = 0; i < layouts.size(); i++) {
+      const SkinningLayout &m = layouts[i];
+      for (int v = 0; v < m.vertices; v++) {
+        const float got[2] = {m.ox[v], m.oy[v]};
+        for (int c = 0; c < 2; c++) {
+          const float want = reference[i][(size_t)v * 2 + (size_t)c];
+          const int64_t ulps = ulp_distance(got[c], want);
+          const double abs_diff = std::fabs((double)got[c] - (double)want);
+          if (ulps > parity.max_ulps) parity.max_ulps = ulps;
+          if (abs_diff > parity.max_abs) parity.max_abs = abs_diff;
+          if (ulps > tolerance_ulps && abs_diff > tolerance_abs) parity.mismatches++;
+        }
+      }
+    }
+    if (parity.mismatches) parity_ok = false;
+
+    const double s = (double)p50 * 1e-9;
+    std::cout << "{\"p50Ns\":" << p50 << ",\"verticesPerSec\":" << (s > 0.0 ? (double)total_vertices / s : 0.0)
+              << ",\"speedup\":" << (p50 > 0 ? (double)reference_ns / (double)p50 : 0.0)
+              << ",\"maxUlps\":" << parity.max_ulps << ",\"maxAbsDiff\":" << parity.max_abs
+              << ",\"mismatches\":" << parity.mismatches << "}";
+  }
+  std::cout << "},\"parity\":" << (parity_ok ? "true" : "false") << "}\n";
+
+  spine_skeleton_drawable_dispose(drawable);
+  spine_skeleton_data_result_dispose(data_result);
+  spine_atlas_dispose(atlas);
+  spine_atlas_result_dispose(atlas_result);
+  return parity_ok ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+use serde_json::json;
+use spine2d::{Atlas, AtlasIndex, AtlasPage, AtlasRegion};
+use std::time::Instant;
+
+fn print_usage_and_exit() -> ! {
+    eprintln!(
+        "Usage: atlas_index <in.atlas> [--out <out.atlasidx>] [--cpp-index <file>] [--iterations <n>]\n\
+         \n\
+         Bakes <in.atlas> into a binary atlas index (--out), checks an index written by\n\
+         spine_cpp_lite_atlas_index against Atlas::parse field by field (--cpp-index), and times\n\
+         text parsing against index loading (default 200 iterations)."
+    );
+    std::process::exit(2);
+}
+
+fn median_us<T>(iterations: usize, mut f: impl FnMut() -> T) -> f64 {
+    let mut samples: Vec<f64> = (0..iterations)
+        .map(|_| {
+            let start = Instant::now();
+            std::hint::black_box(f());
+            start.elapsed().as_secs_f64() * 1.0e6
+        })
+        .collect();
+    samples.sort_by(f64::total_cmp);
+    samples.get(samples.len() / 2).copied().unwrap_or(0.0)
+}
+
+/// Page fields that differ. `scale` is skipped: spine-cpp's `AtlasPage` does not keep it.
+fn page_diffs(a: &AtlasPage, b: &AtlasPage) -> Vec<&'static str> {
+    let mut out = Vec::new();
+    if a.name != b.name {
+        out.push("name");
+    }
+    if (a.width, a.height) != (b.width, b.height) {
+        out.push("size");
+    }
+    if a.pma != b.pma {
+        out.push("pma");
+    }
+    if (&a.min_filter, &a.mag_filter) != (&b.min_filter, &b.mag_filter) {
+        out.push("filter");
+    }
+    if (a.wrap_u, a.wrap_v) != (b.wrap_u, b.wrap_v) {
+        out.push("wrap");
+    }
+    out
+}
+
+fn region_diffs(a: &AtlasRegion, b: &AtlasRegion) -> Vec<&'static str> {
+    let mut out = Vec::new();
+    if a.page != b.page {
+        out.push("page");
+    }
+    if a.degrees != b.degrees {
+        out.push("degrees");
+    }
+    if (a.x, a.y, a.width, a.height) != (b.x, b.y, b.width, b.height) {
+        out.push("bounds");
+    }
+    if (a.offset_x, a.offset_y) != (b.offset_x, b.offset_y) {
+        out.push("offset");
+    }
+    if (a.original_width, a.original_height) != (b.original_width, b.original_height) {
+        out.push("original");
+    }
+    out
+}
+
+fn parity(atlas: &Atlas, index: &AtlasIndex<'_>) -> serde_json::Value {
+    let mut mismatches = Vec::new();
+    if index.page_count() != atlas.pages.len() {
+        mismatches.push(
+            json!({"what": "pageCount", "rust": atlas.pages.len(), "cpp": index.page_count()}),
+        );
+    }
+    for (i, page) in atlas.pages.iter().enumerate() {
+        match index.page(i) {
+            Some(other) => {
+                let diffs = page_diffs(page, &other);
+                if !diffs.is_empty() {
+                    mismatches.push(json!({"page": i, "fields": diffs}));
+                }
+            }
+            None => mismatches.push(json!({"page": i, "fields": ["missing"]})),
+        }
+    }
+    let mut names: Vec<&String> = atlas.regions.keys().collect();
+    names.sort();
+    for name in names {
+        match index.find(name) {
+            Some(other) => {
+                let diffs = region_diffs(&atlas.regions[name], &other);
+                if !diffs.is_empty() {
+                    mismatches.push(json!({"region": name, "fields": diffs}));
+                }
+            }
+            None => mismatches.push(json!({"region": name, "fields": ["missingInCpp"]})),
+        }
+    }
+    let mut duplicates = 0usize;
+    for i in 0..index.region_count() {
+        let name = index.region_name(i).unwrap_or("");
+        if !atlas.regions.contains_key(name) {
+            mismatches.push(json!({"region": name, "fields": ["missingInRust"]}));
+        } else if index.find_index(name) != Some(i) {
+            duplicates += 1;
+        }
+    }
+    json!({
+        "ok": mismatches.is_empty(),
+        "cppRegions": index.region_count(),
+        "cppDuplicateNames": duplicates,
+        "mismatches": mismatches,
+    })
+}
+
+fn main() {
+    let args = std::env::args().skip(1).collect::<Vec<_>>();
+    let mut positional = Vec::<String>::new();
+    let mut out: Option<String> = None;
+    let mut cpp_index: Option<String> = None;
+    let mut iterations = 200usize;
+
+    let mut i = 0usize;
+    while i < args.len() {
+        match args[i].as_str() {
+            "--out" if i + 1 < args.len() => {
+                out = Some(args[i + 1].clone());
+                i += 2;
+            }
+            "--cpp-index" if i + 1 < args.len() => {
+                cpp_index = Some(args[i + 1].clone());
+                i += 2;
+            }
+            "--iterations" if i + 1 < args.len() => {
+                iterations = args[i + 1]
+                    .parse()
+                    .unwrap_or_else(|_| print_usage_and_exit());
+                i += 2;
+            }
+            other if !other.starts_with("--") => {
+                positional.push(other.to_string());
+                i += 1;
+            }
+            _ => print_usage_and_exit(),
+        }
+    }
+    if positional.len() != 1 || iterations == 0 {
+        print_usage_and_exit();
+    }
+
+    let text = std::fs::read_to_string(&positional[0]).expect("read atlas");
+    let atlas = Atlas::parse(&text).expect("parse atlas");
+    let bytes = atlas.to_index_bytes();
+    if let Some(out) = &out {
+        std::fs::write(out, &bytes).expect("write atlas index");
+    }
+
+    let mut names: Vec<&str> = atlas.regions.keys().map(String::as_str).collect();
+    names.sort_unstable();
+    let lookups = |f: &dyn Fn(&str) -> bool| names.iter().filter(|n| f(n)).count();
+    let mut summary = json!({
+        "atlas": positional[0],
+        "pages": atlas.pages.len(),
+        "regions": atlas.regions.len(),
+        "textBytes": text.len(),
+        "indexBytes": bytes.len(),
+        "iterations": iterations,
+        "parseMedianUs": median_us(iterations, || Atlas::parse(&text)),
+        "fromIndexMedianUs": median_us(iterations, || Atlas::from_index_bytes(&bytes)),
+        "parseLookupMedianUs": median_us(iterations, || {
+            let atlas = Atlas::parse(&text).expect("parse atlas");
+            lookups(&|n| atlas.region(n).is_some())
+        }),
+        "indexLookupMedianUs": median_us(iterations, || {
+            let index = AtlasIndex::new(&bytes).expect("atlas index");
+            lookups(&|n| index.find_index(n).is_some())
+        }),
+    });
+
+    let mut failed = false;
+    if let Some(path) = &cpp_index {
+        let cpp_bytes = std::fs::read(path).expect("read spine-cpp atlas index");
+        let report = match AtlasIndex::new(&cpp_bytes) {
+            Ok(index) => parity(&atlas, &index),
+            Err(e) => json!({"ok": false, "error": e.to_string()}),
+        };
+        failed = report["ok"] != json!(true);
+        summary["parity"] = report;
+    }
+
+    println!(
+        "{}",
+        serde_json::to_string(&summary).expect("serialize summary")
+    );
+    if failed {
+        std::process::exit(1);
+    }
+}
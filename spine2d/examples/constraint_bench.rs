@@ -0,0 +1,167 @@
+use serde_json::json;
+use spine2d::{Skeleton, SkeletonData};
+use std::path::Path;
+use std::time::Instant;
+
+fn print_usage_and_exit() -> ! {
+    eprintln!(
+        "Usage: constraint_bench <manifest.json> [--iterations <n>] [--tolerance <rel>]\n\
+         \n\
+         Times Skeleton::update_world_transform on every synthetic skeleton listed in a manifest\n\
+         written by spine_cpp_lite_constraint_bench --emit-dir (default 200 iterations), and prints\n\
+         the variants with the spine-cpp timings from the manifest next to `rustWorldP50Ns`.\n\
+         Variants with `checks` (IK) move bone `t` to each recorded target, compare the world\n\
+         transforms of `p`/`c` against spine-cpp's (`maxPoseDiff`, |a - b| / max(1, |b|)), and\n\
+         exit 1 if any exceeds --tolerance (default 1e-3)."
+    );
+    std::process::exit(2);
+}
+
+fn median_ns(iterations: usize, mut f: impl FnMut()) -> f64 {
+    let mut samples: Vec<f64> = (0..iterations)
+        .map(|_| {
+            let start = Instant::now();
+            f();
+            start.elapsed().as_secs_f64() * 1.0e9
+        })
+        .collect();
+    samples.sort_by(f64::total_cmp);
+    samples.get(samples.len() / 2).copied().unwrap_or(0.0)
+}
+
+fn bone_index(skeleton: &Skeleton, name: &str) -> Option<usize> {
+    skeleton.data.bones.iter().position(|b| b.name == name)
+}
+
+/// Sets the local position of bone `target` to check `k`'s target (wrapping around).
+fn set_target(skeleton: &mut Skeleton, target: usize, checks: &[serde_json::Value], k: usize) {
+    let xy = &checks[k % checks.len()]["target"];
+    skeleton.bones[target].x = xy[0].as_f64().unwrap_or(0.0) as f32;
+    skeleton.bones[target].y = xy[1].as_f64().unwrap_or(0.0) as f32;
+}
+
+/// Largest relative difference between spine2d's world transforms of `p` (and `c`) and the
+/// spine-cpp poses recorded at each target.
+fn max_pose_diff(skeleton: &mut Skeleton, target: usize, checks: &[serde_json::Value]) -> f32 {
+    let constrained: Vec<usize> = ["p", "c"]
+        .iter()
+        .filter_map(|n| bone_index(skeleton, n))
+        .collect();
+    let mut max = 0.0f32;
+    for k in 0..checks.len() {
+        set_target(skeleton, target, checks, k);
+        skeleton.update_world_transform();
+        let expected = checks[k]["bones"].as_array().cloned().unwrap_or_default();
+        if expected.len() != constrained.len() {
+            return f32::INFINITY;
+        }
+        for (&bone, expected) in constrained.iter().zip(&expected) {
+            let b = &skeleton.bones[bone];
+            let actual = [b.a, b.b, b.c, b.d, b.world_x, b.world_y];
+            for (i, a) in actual.iter().enumerate() {
+                let e = expected[i].as_f64().unwrap_or(f64::NAN) as f32;
+                let diff = (a - e).abs() / e.abs().max(1.0);
+                max = if diff.is_nan() {
+                    f32::INFINITY
+                } else {
+                    max.max(diff)
+                };
+            }
+        }
+    }
+    max
+}
+
+fn main() {
+    let args = std::env::args().skip(1).collect::<Vec<_>>();
+    let mut positional = Vec::<String>::new();
+    let mut iterations = 200usize;
+    let mut tolerance = 1.0e-3f32;
+
+    let mut i = 0usize;
+    while i < args.len() {
+        match args[i].as_str() {
+            "--iterations" if i + 1 < args.len() => {
+                iterations = args[i + 1]
+                    .parse()
+                    .unwrap_or_else(|_| print_usage_and_exit());
+                i += 2;
+            }
+            "--tolerance" if i + 1 < args.len() => {
+                tolerance = args[i + 1]
+                    .parse()
+                    .unwrap_or_else(|_| print_usage_and_exit());
+                i += 2;
+            }
+            other if !other.starts_with("--") => {
+                positional.push(other.to_string());
+                i += 1;
+            }
+            _ => print_usage_and_exit(),
+        }
+    }
+    if positional.len() != 1 || iterations == 0 {
+        print_usage_and_exit();
+    }
+
+    let manifest_path = Path::new(&positional[0]);
+    let manifest: serde_json::Value =
+        serde_json::from_str(&std::fs::read_to_string(manifest_path).expect("read manifest"))
+            .expect("parse manifest");
+    let dir = manifest_path.parent().unwrap_or(Path::new("."));
+
+    let mut variants = Vec::new();
+    let mut failed = false;
+    for variant in manifest["variants"].as_array().into_iter().flatten() {
+        let file = variant["file"].as_str().expect("variant file");
+        let text = std::fs::read_to_string(dir.join(file)).expect("read variant");
+        let data = SkeletonData::from_json_str(&text).expect("parse variant");
+        let mut skeleton = Skeleton::new(data);
+        skeleton.set_to_setup_pose();
+        skeleton.update_world_transform();
+
+        let checks = variant["checks"].as_array().cloned().unwrap_or_default();
+        let target = bone_index(&skeleton, "t").filter(|_| !checks.is_empty());
+        let mut frame = 0usize;
+        let mut step = |skeleton: &mut Skeleton| {
+            if let Some(target) = target {
+                set_target(skeleton, target, &checks, frame);
+            }
+            frame += 1;
+            skeleton.update_world_transform();
+        };
+        for _ in 0..iterations / 10 + 1 {
+            step(&mut skeleton);
+        }
+        let world = median_ns(iterations, || {
+            step(&mut skeleton);
+            std::hint::black_box(&skeleton.bones);
+        });
+
+        let mut out = variant.clone();
+        out["rustWorldP50Ns"] = json!(world);
+        if let Some(target) = target {
+            let diff = max_pose_diff(&mut skeleton, target, &checks);
+            failed |= diff > tolerance;
+            out["maxPoseDiff"] = json!(diff);
+            out.as_object_mut()
+                .expect("variant object")
+                .remove("checks");
+        }
+        variants.push(out);
+    }
+
+    println!(
+        "{}",
+        serde_json::to_string(&json!({
+            "mode": manifest["mode"],
+            "iterations": iterations,
+            "tolerance": tolerance,
+            "variants": variants,
+        }))
+        .expect("serialize summary")
+    );
+    if failed {
+        std::process::exit(1);
+    }
+}
@@ -0,0 +1,939 @@
+//! Canonical binary dump of a loaded `SkeletonData`, record-for-record compatible with the C++
+//! `spine_cpp_lite_dump_constraints --model-out` so `scripts/compare_model_dump.py` can diff the
+//! spine2d JSON/.skel loaders against spine-cpp field by field.
+//!
+//! Format: `"SPMD"`, u32 version, then records of
+//! `u16 key length, key, u8 tag ('f' f32[] / 'i' i32[] / 's' strings), u32 count, payload`
+//! (little-endian; strings are u32 length + bytes). Timelines are laid out the way spine-cpp stores
+//! them: `frames` is the flat `Timeline::_frames` array and `curves` holds, per frame but the last,
+//! 0 (linear), 1 (stepped) or 2 followed by spine-cpp's 9 sampled bezier points per channel.
+
+use spine2d::{
+    AttachmentData, Curve, Inherit, MeshVertices, SequenceDef, SequenceMode, SkeletonData,
+    TransformProperty,
+};
+use std::path::PathBuf;
+
+const MODEL_DUMP_VERSION: u32 = 1;
+
+fn load_skeleton_data(path: &PathBuf) -> std::sync::Arc<SkeletonData> {
+    let ext = path.extension().and_then(|s| s.to_str()).unwrap_or("");
+    if ext.eq_ignore_ascii_case("skel") {
+        #[cfg(feature = "binary")]
+        {
+            let bytes = std::fs::read(path).expect("read skel");
+            return SkeletonData::from_skel_bytes(&bytes).expect("parse skel");
+        }
+        #[cfg(not(feature = "binary"))]
+        {
+            panic!("Input is .skel but spine2d was built without feature `binary`.");
+        }
+    }
+
+    let json = std::fs::read_to_string(path).expect("read json");
+    SkeletonData::from_json_str(&json).expect("parse json")
+}
+
+enum Field {
+    F(Vec<f32>),
+    I(Vec<i32>),
+    S(Vec<String>),
+}
+
+#[derive(Default)]
+struct Dump {
+    out: Vec<u8>,
+}
+
+impl Dump {
+    fn put(&mut self, key: &str, field: Field) {
+        let (tag, count) = match &field {
+            Field::F(v) => (b'f', v.len()),
+            Field::I(v) => (b'i', v.len()),
+            Field::S(v) => (b's', v.len()),
+        };
+        self.out.extend((key.len() as u16).to_le_bytes());
+        self.out.extend(key.as_bytes());
+        self.out.push(tag);
+        self.out.extend((count as u32).to_le_bytes());
+        match field {
+            Field::F(v) => v.iter().for_each(|f| self.out.extend(f.to_le_bytes())),
+            Field::I(v) => v.iter().for_each(|i| self.out.extend(i.to_le_bytes())),
+            Field::S(v) => {
+                for s in v {
+                    self.out.extend((s.len() as u32).to_le_bytes());
+                    self.out.extend(s.as_bytes());
+                }
+            }
+        }
+    }
+
+    fn floats(&mut self, key: &str, v: Vec<f32>) {
+        self.put(key, Field::F(v));
+    }
+
+    fn ints(&mut self, key: &str, v: Vec<i32>) {
+        self.put(key, Field::I(v));
+    }
+
+    fn strings(&mut self, key: &str, v: &[&str]) {
+        self.put(key, Field::S(v.iter().map(|s| s.to_string()).collect()));
+    }
+}
+
+fn flag(b: bool) -> i32 {
+    b as i32
+}
+
+fn index_or_none(i: Option<usize>) -> i32 {
+    i.map_or(-1, |i| i as i32)
+}
+
+fn property_kind(p: TransformProperty) -> i32 {
+    match p {
+        TransformProperty::Rotate => 0,
+        TransformProperty::X => 1,
+        TransformProperty::Y => 2,
+        TransformProperty::ScaleX => 3,
+        TransformProperty::ScaleY => 4,
+        TransformProperty::ShearY => 5,
+    }
+}
+
+fn inherit_index(i: Inherit) -> i32 {
+    match i {
+        Inherit::Normal => 0,
+        Inherit::OnlyTranslation => 1,
+        Inherit::NoRotationOrReflection => 2,
+        Inherit::NoScale => 3,
+        Inherit::NoScaleOrReflection => 4,
+    }
+}
+
+fn sequence_mode_index(m: SequenceMode) -> i32 {
+    match m {
+        SequenceMode::Hold => 0,
+        SequenceMode::Once => 1,
+        SequenceMode::Loop => 2,
+        SequenceMode::PingPong => 3,
+        SequenceMode::OnceReverse => 4,
+        SequenceMode::LoopReverse => 5,
+        SequenceMode::PingPongReverse => 6,
+    }
+}
+
+fn sequence_fields(s: &SequenceDef) -> Vec<i32> {
+    vec![s.count as i32, s.start, s.digits as i32, s.setup_index]
+}
+
+/// spine-cpp `VertexAttachment` storage: `bones` is `[count, bone...]` per weighted vertex and
+/// `vertices` is `x, y` (unweighted) or `x, y, weight` per bone.
+fn vertex_fields(dump: &mut Dump, prefix: &str, vertices: &MeshVertices) {
+    let (bones, values, count) = match vertices {
+        MeshVertices::Unweighted(v) => (Vec::new(), v.iter().flatten().copied().collect(), v.len()),
+        MeshVertices::Weighted(v) => {
+            let mut bones = Vec::new();
+            let mut values = Vec::new();
+            for weights in v {
+                bones.push(weights.len() as i32);
+                for w in weights {
+                    bones.push(w.bone as i32);
+                    values.extend([w.x, w.y, w.weight]);
+                }
+            }
+            (bones, values, v.len())
+        }
+    };
+    dump.ints(&format!("{prefix}bones"), bones);
+    dump.floats(&format!("{prefix}vertices"), values);
+    dump.ints(
+        &format!("{prefix}worldVerticesLength"),
+        vec![count as i32 * 2],
+    );
+}
+
+/// spine-cpp `CurveTimeline::setBezier`: 9 forward-differenced samples of one channel's segment.
+fn bezier_samples(out: &mut Vec<f32>, p1: [f32; 2], c1: [f32; 2], c2: [f32; 2], p2: [f32; 2]) {
+    let [time1, value1] = p1;
+    let [cx1, cy1] = c1;
+    let [cx2, cy2] = c2;
+    let [time2, value2] = p2;
+    let tmpx = (time1 - cx1 * 2.0 + cx2) * 0.03;
+    let tmpy = (value1 - cy1 * 2.0 + cy2) * 0.03;
+    let dddx = ((cx1 - cx2) * 3.0 - time1 + time2) * 0.006;
+    let dddy = ((cy1 - cy2) * 3.0 - value1 + value2) * 0.006;
+    let mut ddx = tmpx * 2.0 + dddx;
+    let mut ddy = tmpy * 2.0 + dddy;
+    let mut dx = (cx1 - time1) * 0.3 + tmpx + dddx * 0.166_666_67;
+    let mut dy = (cy1 - value1) * 0.3 + tmpy + dddy * 0.166_666_67;
+    let mut x = time1 + dx;
+    let mut y = value1 + dy;
+    for _ in 0..9 {
+        out.extend([x, y]);
+        dx += ddx;
+        dy += ddy;
+        ddx += dddx;
+        ddy += dddy;
+        x += dx;
+        y += dy;
+    }
+}
+
+/// Canonical curves for frames `0..n-1`; `segment(frame, channel)` gives the channel's values at
+/// `frame` and `frame + 1`. Linear channels of a bezier frame are sampled as straight beziers.
+fn canonical_curves(
+    times: &[f32],
+    curves: &[&[Curve]],
+    segment: impl Fn(usize, usize) -> (f32, f32),
+) -> Vec<f32> {
+    let mut out = Vec::new();
+    for frame in 0..times.len().saturating_sub(1) {
+        let channels = curves[frame];
+        if matches!(channels[0], Curve::Stepped) {
+            out.push(1.0);
+            continue;
+        }
+        if channels.iter().all(|c| matches!(c, Curve::Linear)) {
+            out.push(0.0);
+            continue;
+        }
+        out.push(2.0);
+        let (time1, time2) = (times[frame], times[frame + 1]);
+        for (channel, curve) in channels.iter().enumerate() {
+            let (value1, value2) = segment(frame, channel);
+            let (c1, c2) = match *curve {
+                Curve::Bezier { cx1, cy1, cx2, cy2 } => ([cx1, cy1], [cx2, cy2]),
+                _ => {
+                    let (dt, dv) = ((time2 - time1) / 3.0, (value2 - value1) / 3.0);
+                    ([time1 + dt, value1 + dv], [time2 - dt, value2 - dv])
+                }
+            };
+            bezier_samples(&mut out, [time1, value1], c1, c2, [time2, value2]);
+        }
+    }
+    out
+}
+
+/// One timeline's records, keyed `<spine-cpp class>/<target>` for canonical ordering.
+struct TimelineDump {
+    key: String,
+    fields: Vec<(String, Field)>,
+}
+
+impl TimelineDump {
+    fn new(class: &str, target: String) -> Self {
+        Self {
+            key: format!("{class}/{target}"),
+            fields: Vec::new(),
+        }
+    }
+
+    /// `frames` as `[time, values...]` rows plus canonical curves over the first `curves[i].len()`
+    /// values of each row.
+    fn curve_rows(mut self, rows: &[(f32, Vec<f32>, &[Curve])]) -> Self {
+        let mut frames = Vec::new();
+        for (time, values, _) in rows {
+            frames.push(*time);
+            frames.extend(values);
+        }
+        let times: Vec<f32> = rows.iter().map(|r| r.0).collect();
+        let curves: Vec<&[Curve]> = rows.iter().map(|r| r.2).collect();
+        let curves = canonical_curves(&times, &curves, |f, c| (rows[f].1[c], rows[f + 1].1[c]));
+        self.fields.push(("frames".into(), Field::F(frames)));
+        self.fields.push(("curves".into(), Field::F(curves)));
+        self
+    }
+
+    fn field(mut self, key: impl Into<String>, field: Field) -> Self {
+        self.fields.push((key.into(), field));
+        self
+    }
+}
+
+fn float_rows<'a>(
+    frames: impl Iterator<Item = (f32, f32, &'a Curve)>,
+) -> Vec<(f32, Vec<f32>, &'a [Curve])> {
+    frames
+        .map(|(time, value, curve)| (time, vec![value], std::slice::from_ref(curve)))
+        .collect()
+}
+
+struct Model<'a> {
+    data: &'a SkeletonData,
+    /// Per-kind constraint index → position in spine-cpp's combined `SkeletonData::constraints`.
+    ik: Vec<usize>,
+    transform: Vec<usize>,
+    path: Vec<usize>,
+    physics: Vec<usize>,
+    slider: Vec<usize>,
+}
+
+impl<'a> Model<'a> {
+    fn new(data: &'a SkeletonData) -> Self {
+        // Stable sort by `order` over ik, transform, path, physics, slider: the combined order both
+        // spine-cpp loaders produce.
+        let mut ordered: Vec<(i32, u8, usize)> = Vec::new();
+        ordered.extend((data.ik_constraints.iter().enumerate()).map(|(i, c)| (c.order, 0, i)));
+        ordered
+            .extend((data.transform_constraints.iter().enumerate()).map(|(i, c)| (c.order, 1, i)));
+        ordered.extend((data.path_constraints.iter().enumerate()).map(|(i, c)| (c.order, 2, i)));
+        ordered.extend((data.physics_constraints.iter().enumerate()).map(|(i, c)| (c.order, 3, i)));
+        ordered.extend((data.slider_constraints.iter().enumerate()).map(|(i, c)| (c.order, 4, i)));
+        ordered.sort_by_key(|(order, _, _)| *order);
+        let mut model = Self {
+            data,
+            ik: vec![0; data.ik_constraints.len()],
+            transform: vec![0; data.transform_constraints.len()],
+            path: vec![0; data.path_constraints.len()],
+            physics: vec![0; data.physics_constraints.len()],
+            slider: vec![0; data.slider_constraints.len()],
+        };
+        for (combined, &(_, kind, i)) in ordered.iter().enumerate() {
+            let table = match kind {
+                0 => &mut model.ik,
+                1 => &mut model.transform,
+                2 => &mut model.path,
+                3 => &mut model.physics,
+                _ => &mut model.slider,
+            };
+            table[i] = combined;
+        }
+        model
+    }
+
+    fn constraint_count(&self) -> usize {
+        self.ik.len()
+            + self.transform.len()
+            + self.path.len()
+            + self.physics.len()
+            + self.slider.len()
+    }
+
+    fn attachment_name(&self, skin: &str, slot: usize, key: &str) -> String {
+        self.data
+            .skin(skin)
+            .and_then(|s| s.attachment(slot, key))
+            .map_or(key, |a| a.name())
+            .to_string()
+    }
+
+    fn write(&self) -> Vec<u8> {
+        let data = self.data;
+        let mut dump = Dump::default();
+        dump.out.extend(b"SPMD");
+        dump.out.extend(MODEL_DUMP_VERSION.to_le_bytes());
+        dump.floats("skeleton/referenceScale", vec![data.reference_scale]);
+
+        for (i, b) in data.bones.iter().enumerate() {
+            let prefix = format!("bone/{i}/");
+            dump.strings(&format!("{prefix}name"), &[&b.name]);
+            dump.ints(&format!("{prefix}parent"), vec![index_or_none(b.parent)]);
+            dump.floats(
+                &format!("{prefix}setup"),
+                vec![
+                    b.x, b.y, b.rotation, b.scale_x, b.scale_y, b.shear_x, b.shear_y, b.length,
+                ],
+            );
+            dump.ints(
+                &format!("{prefix}flags"),
+                vec![inherit_index(b.inherit), flag(b.skin_required)],
+            );
+        }
+
+        for (i, s) in data.slots.iter().enumerate() {
+            let prefix = format!("slot/{i}/");
+            dump.strings(&format!("{prefix}name"), &[&s.name]);
+            dump.ints(
+                &format!("{prefix}flags"),
+                vec![s.bone as i32, s.blend as i32, flag(s.has_dark)],
+            );
+            dump.floats(&format!("{prefix}color"), s.color.to_vec());
+            if s.has_dark {
+                dump.floats(&format!("{prefix}dark"), s.dark_color.to_vec());
+            }
+            let attachment: Vec<&str> = s.attachment.iter().map(String::as_str).collect();
+            dump.strings(&format!("{prefix}attachment"), &attachment);
+        }
+
+        self.write_constraints(&mut dump);
+        self.write_skins(&mut dump);
+
+        let mut events: Vec<_> = data.events.values().collect();
+        events.sort_by(|a, b| a.name.cmp(&b.name));
+        for e in events {
+            let prefix = format!("event/{}/", e.name);
+            dump.ints(&format!("{prefix}int"), vec![e.int_value]);
+            dump.floats(
+                &format!("{prefix}values"),
+                vec![e.float_value, e.volume, e.balance],
+            );
+            dump.strings(&format!("{prefix}strings"), &[&e.string, &e.audio_path]);
+        }
+
+        let mut animations: Vec<_> = data.animations.iter().collect();
+        animations.sort_by(|a, b| a.name.cmp(&b.name));
+        for animation in animations {
+            let prefix = format!("animation/{}/", animation.name);
+            dump.floats(&format!("{prefix}duration"), vec![animation.duration]);
+            let mut timelines = self.timelines(animation);
+            timelines.sort_by(|a, b| a.key.cmp(&b.key));
+            for t in timelines {
+                for (key, field) in t.fields {
+                    dump.put(&format!("{prefix}{}/{key}", t.key), field);
+                }
+            }
+        }
+        dump.out
+    }
+
+    fn write_constraints(&self, dump: &mut Dump) {
+        let data = self.data;
+        let mut records: Vec<Option<Vec<(&str, Field)>>> =
+            (0..self.constraint_count()).map(|_| None).collect();
+        let bones = |b: &[usize]| Field::I(b.iter().map(|&b| b as i32).collect());
+        let strings = |v: &[&str]| Field::S(v.iter().map(|s| s.to_string()).collect());
+
+        for (i, c) in data.ik_constraints.iter().enumerate() {
+            records[self.ik[i]] = Some(vec![
+                ("name", strings(&[&c.name])),
+                ("kind", strings(&["ik"])),
+                ("bones", bones(&c.bones)),
+                (
+                    "flags",
+                    Field::I(vec![
+                        c.target as i32,
+                        c.bend_direction,
+                        flag(c.compress),
+                        flag(c.stretch),
+                        flag(c.uniform),
+                        flag(c.skin_required),
+                    ]),
+                ),
+                ("setup", Field::F(vec![c.mix, c.softness])),
+            ]);
+        }
+        for (i, c) in data.transform_constraints.iter().enumerate() {
+            let mut properties = Vec::new();
+            for from in &c.properties {
+                properties.extend([
+                    property_kind(from.property) as f32,
+                    from.offset,
+                    from.to.len() as f32,
+                ]);
+                for to in &from.to {
+                    properties.extend([
+                        property_kind(to.property) as f32,
+                        to.offset,
+                        to.max,
+                        to.scale,
+                    ]);
+                }
+            }
+            records[self.transform[i]] = Some(vec![
+                ("name", strings(&[&c.name])),
+                ("kind", strings(&["transform"])),
+                ("bones", bones(&c.bones)),
+                (
+                    "flags",
+                    Field::I(vec![
+                        c.source as i32,
+                        flag(c.local_source),
+                        flag(c.local_target),
+                        flag(c.additive),
+                        flag(c.clamp),
+                        flag(c.skin_required),
+                    ]),
+                ),
+                (
+                    "setup",
+                    Field::F(vec![
+                        c.mix_rotate,
+                        c.mix_x,
+                        c.mix_y,
+                        c.mix_scale_x,
+                        c.mix_scale_y,
+                        c.mix_shear_y,
+                    ]),
+                ),
+                ("offsets", Field::F(c.offsets.to_vec())),
+                ("properties", Field::F(properties)),
+            ]);
+        }
+        for (i, c) in data.path_constraints.iter().enumerate() {
+            records[self.path[i]] = Some(vec![
+                ("name", strings(&[&c.name])),
+                ("kind", strings(&["path"])),
+                ("bones", bones(&c.bones)),
+                (
+                    "flags",
+                    Field::I(vec![
+                        c.target as i32,
+                        c.position_mode as i32,
+                        c.spacing_mode as i32,
+                        c.rotate_mode as i32,
+                        flag(c.skin_required),
+                    ]),
+                ),
+                (
+                    "setup",
+                    Field::F(vec![
+                        c.offset_rotation,
+                        c.position,
+                        c.spacing,
+                        c.mix_rotate,
+                        c.mix_x,
+                        c.mix_y,
+                    ]),
+                ),
+            ]);
+        }
+        for (i, c) in data.physics_constraints.iter().enumerate() {
+            records[self.physics[i]] = Some(vec![
+                ("name", strings(&[&c.name])),
+                ("kind", strings(&["physics"])),
+                (
+                    "flags",
+                    Field::I(vec![
+                        c.bone as i32,
+                        flag(c.skin_required),
+                        flag(c.inertia_global),
+                        flag(c.strength_global),
+                        flag(c.damping_global),
+                        flag(c.mass_global),
+                        flag(c.wind_global),
+                        flag(c.gravity_global),
+                        flag(c.mix_global),
+                    ]),
+                ),
+                (
+                    "setup",
+                    Field::F(vec![
+                        c.x,
+                        c.y,
+                        c.rotate,
+                        c.scale_x,
+                        c.shear_x,
+                        c.limit,
+                        c.step,
+                        c.inertia,
+                        c.strength,
+                        c.damping,
+                        c.mass_inverse,
+                        c.wind,
+                        c.gravity,
+                        c.mix,
+                    ]),
+                ),
+            ]);
+        }
+        for (i, c) in data.slider_constraints.iter().enumerate() {
+            let animation: Vec<&str> = c
+                .animation
+                .and_then(|a| data.animations.get(a))
+                .map(|a| a.name.as_str())
+                .into_iter()
+                .collect();
+            records[self.slider[i]] = Some(vec![
+                ("name", strings(&[&c.name])),
+                ("kind", strings(&["slider"])),
+                ("animation", strings(&animation)),
+                (
+                    "flags",
+                    Field::I(vec![
+                        index_or_none(c.bone),
+                        c.property.map_or(-1, property_kind),
+                        flag(c.looped),
+                        flag(c.additive),
+                        flag(c.local),
+                        flag(c.skin_required),
+                    ]),
+                ),
+                (
+                    "setup",
+                    Field::F(vec![
+                        c.setup_time,
+                        c.setup_mix,
+                        c.property_from,
+                        c.to,
+                        c.scale,
+                    ]),
+                ),
+            ]);
+        }
+
+        for (i, record) in records.into_iter().enumerate() {
+            for (key, field) in record.into_iter().flatten() {
+                dump.put(&format!("constraint/{i}/{key}"), field);
+            }
+        }
+    }
+
+    fn write_skins(&self, dump: &mut Dump) {
+        let data = self.data;
+        let mut skins: Vec<_> = data.skins.values().collect();
+        skins.sort_by(|a, b| a.name.cmp(&b.name));
+        for skin in skins {
+            let prefix = format!("skin/{}/", skin.name);
+            let mut bones: Vec<i32> = skin.bones.iter().map(|&b| b as i32).collect();
+            bones.sort_unstable();
+            dump.ints(&format!("{prefix}bones"), bones);
+            let mut constraints: Vec<i32> = (skin.ik_constraints.iter().map(|&i| self.ik[i]))
+                .chain(
+                    skin.transform_constraints
+                        .iter()
+                        .map(|&i| self.transform[i]),
+                )
+                .chain(skin.path_constraints.iter().map(|&i| self.path[i]))
+                .chain(skin.physics_constraints.iter().map(|&i| self.physics[i]))
+                .chain(skin.slider_constraints.iter().map(|&i| self.slider[i]))
+                .map(|i| i as i32)
+                .collect();
+            constraints.sort_unstable();
+            dump.ints(&format!("{prefix}constraints"), constraints);
+
+            for (slot, attachments) in skin.attachments.iter().enumerate() {
+                let mut keys: Vec<&String> = attachments.keys().collect();
+                keys.sort();
+                for key in keys {
+                    let prefix = format!("{prefix}{slot}/{key}/");
+                    self.write_attachment(dump, &prefix, slot, &attachments[key]);
+                }
+            }
+        }
+    }
+
+    fn write_attachment(&self, dump: &mut Dump, prefix: &str, slot: usize, a: &AttachmentData) {
+        let key = |k: &str| format!("{prefix}{k}");
+        match a {
+            AttachmentData::Region(r) => {
+                dump.strings(&key("type"), &["region"]);
+                dump.strings(&key("name"), &[&r.name]);
+                dump.strings(&key("path"), &[&r.path]);
+                dump.floats(&key("color"), r.color.to_vec());
+                dump.floats(
+                    &key("setup"),
+                    vec![
+                        r.x, r.y, r.rotation, r.scale_x, r.scale_y, r.width, r.height,
+                    ],
+                );
+                if let Some(seq) = &r.sequence {
+                    dump.ints(&key("sequence"), sequence_fields(seq));
+                }
+            }
+            AttachmentData::Mesh(m) => {
+                dump.strings(&key("type"), &["mesh"]);
+                dump.strings(&key("name"), &[&m.name]);
+                dump.strings(&key("path"), &[&m.path]);
+                dump.floats(&key("color"), m.color.to_vec());
+                vertex_fields(dump, prefix, &m.vertices);
+                dump.floats(&key("uvs"), m.uvs.iter().flatten().copied().collect());
+                dump.ints(
+                    &key("triangles"),
+                    m.triangles.iter().map(|&t| t as i32).collect(),
+                );
+                let timeline = self.attachment_name(&m.timeline_skin, slot, &m.timeline_attachment);
+                dump.strings(&key("timelineAttachment"), &[&timeline]);
+                if let Some(seq) = &m.sequence {
+                    dump.ints(&key("sequence"), sequence_fields(seq));
+                }
+            }
+            AttachmentData::Path(p) => {
+                dump.strings(&key("type"), &["path"]);
+                dump.strings(&key("name"), &[&p.name]);
+                vertex_fields(dump, prefix, &p.vertices);
+                dump.floats(&key("lengths"), p.lengths.clone());
+                dump.ints(&key("flags"), vec![flag(p.closed), flag(p.constant_speed)]);
+            }
+            AttachmentData::BoundingBox(b) => {
+                dump.strings(&key("type"), &["boundingbox"]);
+                dump.strings(&key("name"), &[&b.name]);
+                vertex_fields(dump, prefix, &b.vertices);
+            }
+            AttachmentData::Clipping(c) => {
+                dump.strings(&key("type"), &["clipping"]);
+                dump.strings(&key("name"), &[&c.name]);
+                vertex_fields(dump, prefix, &c.vertices);
+                dump.ints(&key("endSlot"), vec![index_or_none(c.end_slot)]);
+            }
+            AttachmentData::Point(p) => {
+                dump.strings(&key("type"), &["point"]);
+                dump.strings(&key("name"), &[&p.name]);
+                dump.floats(&key("setup"), vec![p.x, p.y, p.rotation]);
+            }
+        }
+    }
+
+    fn timelines(&self, animation: &'a spine2d::Animation) -> Vec<TimelineDump> {
+        use spine2d::{
+            BoneTimeline as B, PathConstraintTimeline as P, PhysicsConstraintTimeline as Ph,
+        };
+
+        let mut out = Vec::new();
+        let bone = |i: usize| format!("bone{i}");
+        let slot = |i: usize| format!("slot{i}");
+        let constraint = |i: i64| format!("constraint{i}");
+        let vec2_rows = |frames: &'a [spine2d::Vec2Frame]| -> Vec<(f32, Vec<f32>, &'a [Curve])> {
+            frames
+                .iter()
+                .map(|f| (f.time, vec![f.x, f.y], &f.curve[..]))
+                .collect()
+        };
+        let float_frames = |frames: &'a [spine2d::FloatFrame]| {
+            float_rows(frames.iter().map(|f| (f.time, f.value, &f.curve)))
+        };
+
+        for t in &animation.bone_timelines {
+            let (class, index, rows) = match t {
+                B::Rotate(t) => (
+                    "RotateTimeline",
+                    t.bone_index,
+                    float_rows(t.frames.iter().map(|f| (f.time, f.angle, &f.curve))),
+                ),
+                B::Translate(t) => ("TranslateTimeline", t.bone_index, vec2_rows(&t.frames)),
+                B::TranslateX(t) => ("TranslateXTimeline", t.bone_index, float_frames(&t.frames)),
+                B::TranslateY(t) => ("TranslateYTimeline", t.bone_index, float_frames(&t.frames)),
+                B::Scale(t) => ("ScaleTimeline", t.bone_index, vec2_rows(&t.frames)),
+                B::ScaleX(t) => ("ScaleXTimeline", t.bone_index, float_frames(&t.frames)),
+                B::ScaleY(t) => ("ScaleYTimeline", t.bone_index, float_frames(&t.frames)),
+                B::Shear(t) => ("ShearTimeline", t.bone_index, vec2_rows(&t.frames)),
+                B::ShearX(t) => ("ShearXTimeline", t.bone_index, float_frames(&t.frames)),
+                B::ShearY(t) => ("ShearYTimeline", t.bone_index, float_frames(&t.frames)),
+                B::Inherit(t) => {
+                    let frames = t
+                        .frames
+                        .iter()
+                        .flat_map(|f| [f.time, inherit_index(f.inherit) as f32])
+                        .collect();
+                    out.push(
+                        TimelineDump::new("InheritTimeline", bone(t.bone_index))
+                            .field("frames", Field::F(frames)),
+                    );
+                    continue;
+                }
+            };
+            out.push(TimelineDump::new(class, bone(index)).curve_rows(&rows));
+        }
+
+        for t in &animation.slot_color_timelines {
+            let rows: Vec<_> = (t.frames.iter())
+                .map(|f| (f.time, f.color.to_vec(), &f.curve[..]))
+                .collect();
+            out.push(TimelineDump::new("RGBATimeline", slot(t.slot_index)).curve_rows(&rows));
+        }
+        for t in &animation.slot_rgb_timelines {
+            let rows: Vec<_> = (t.frames.iter())
+                .map(|f| (f.time, f.color.to_vec(), &f.curve[..]))
+                .collect();
+            out.push(TimelineDump::new("RGBTimeline", slot(t.slot_index)).curve_rows(&rows));
+        }
+        for t in &animation.slot_alpha_timelines {
+            let rows = float_rows(t.frames.iter().map(|f| (f.time, f.alpha, &f.curve)));
+            out.push(TimelineDump::new("AlphaTimeline", slot(t.slot_index)).curve_rows(&rows));
+        }
+        for t in &animation.slot_rgba2_timelines {
+            let rows: Vec<_> = (t.frames.iter())
+                .map(|f| (f.time, [&f.light[..], &f.dark[..]].concat(), &f.curve[..]))
+                .collect();
+            out.push(TimelineDump::new("RGBA2Timeline", slot(t.slot_index)).curve_rows(&rows));
+        }
+        for t in &animation.slot_rgb2_timelines {
+            let rows: Vec<_> = (t.frames.iter())
+                .map(|f| (f.time, [&f.light[..], &f.dark[..]].concat(), &f.curve[..]))
+                .collect();
+            out.push(TimelineDump::new("RGB2Timeline", slot(t.slot_index)).curve_rows(&rows));
+        }
+        for t in &animation.slot_attachment_timelines {
+            let names = (t.frames.iter())
+                .map(|f| f.name.clone().unwrap_or_default())
+                .collect();
+            out.push(
+                TimelineDump::new("AttachmentTimeline", slot(t.slot_index))
+                    .field(
+                        "frames",
+                        Field::F(t.frames.iter().map(|f| f.time).collect()),
+                    )
+                    .field("names", Field::S(names)),
+            );
+        }
+        for t in &animation.deform_timelines {
+            let target = format!(
+                "slot{}/{}",
+                t.slot_index,
+                self.attachment_name(&t.skin, t.slot_index, &t.attachment)
+            );
+            let times: Vec<f32> = t.frames.iter().map(|f| f.time).collect();
+            let curves: Vec<&[Curve]> = t
+                .frames
+                .iter()
+                .map(|f| std::slice::from_ref(&f.curve))
+                .collect();
+            let mut dump = TimelineDump::new("DeformTimeline", target)
+                .field("frames", Field::F(times.clone()))
+                .field(
+                    "curves",
+                    Field::F(canonical_curves(&times, &curves, |_, _| (0.0, 1.0))),
+                );
+            for (i, f) in t.frames.iter().enumerate() {
+                dump = dump.field(format!("vertices/{i}"), Field::F(f.vertices.clone()));
+            }
+            out.push(dump);
+        }
+        for t in &animation.sequence_timelines {
+            let target = format!(
+                "slot{}/{}",
+                t.slot_index,
+                self.attachment_name(&t.skin, t.slot_index, &t.attachment)
+            );
+            let frames = (t.frames.iter())
+                .flat_map(|f| {
+                    let mode = sequence_mode_index(f.mode) | (f.index << 4);
+                    [f.time, mode as f32, f.delay]
+                })
+                .collect();
+            out.push(
+                TimelineDump::new("SequenceTimeline", target).field("frames", Field::F(frames)),
+            );
+        }
+
+        for t in &animation.ik_constraint_timelines {
+            let rows: Vec<_> = (t.frames.iter())
+                .map(|f| {
+                    let values = vec![
+                        f.mix,
+                        f.softness,
+                        f.bend_direction as f32,
+                        flag(f.compress) as f32,
+                        flag(f.stretch) as f32,
+                    ];
+                    (f.time, values, &f.curve[..])
+                })
+                .collect();
+            let target = constraint(self.ik[t.constraint_index] as i64);
+            out.push(TimelineDump::new("IkConstraintTimeline", target).curve_rows(&rows));
+        }
+        for t in &animation.transform_constraint_timelines {
+            let rows: Vec<_> = (t.frames.iter())
+                .map(|f| {
+                    let values = vec![
+                        f.mix_rotate,
+                        f.mix_x,
+                        f.mix_y,
+                        f.mix_scale_x,
+                        f.mix_scale_y,
+                        f.mix_shear_y,
+                    ];
+                    (f.time, values, &f.curve[..])
+                })
+                .collect();
+            let target = constraint(self.transform[t.constraint_index] as i64);
+            out.push(TimelineDump::new("TransformConstraintTimeline", target).curve_rows(&rows));
+        }
+        for t in &animation.path_constraint_timelines {
+            let (class, index, rows) = match t {
+                P::Position(t) => (
+                    "PathConstraintPositionTimeline",
+                    t.constraint_index,
+                    float_frames(&t.frames),
+                ),
+                P::Spacing(t) => (
+                    "PathConstraintSpacingTimeline",
+                    t.constraint_index,
+                    float_frames(&t.frames),
+                ),
+                P::Mix(t) => (
+                    "PathConstraintMixTimeline",
+                    t.constraint_index,
+                    (t.frames.iter())
+                        .map(|f| (f.time, vec![f.mix_rotate, f.mix_x, f.mix_y], &f.curve[..]))
+                        .collect(),
+                ),
+            };
+            let target = constraint(self.path[index] as i64);
+            out.push(TimelineDump::new(class, target).curve_rows(&rows));
+        }
+        let physics_target = |index: i32| {
+            let combined = usize::try_from(index).map_or(-1, |i| self.physics[i] as i64);
+            constraint(combined)
+        };
+        for t in &animation.physics_constraint_timelines {
+            let (class, t) = match t {
+                Ph::Inertia(t) => ("PhysicsConstraintInertiaTimeline", t),
+                Ph::Strength(t) => ("PhysicsConstraintStrengthTimeline", t),
+                Ph::Damping(t) => ("PhysicsConstraintDampingTimeline", t),
+                Ph::Mass(t) => ("PhysicsConstraintMassTimeline", t),
+                Ph::Wind(t) => ("PhysicsConstraintWindTimeline", t),
+                Ph::Gravity(t) => ("PhysicsConstraintGravityTimeline", t),
+                Ph::Mix(t) => ("PhysicsConstraintMixTimeline", t),
+            };
+            let target = physics_target(t.constraint_index);
+            out.push(TimelineDump::new(class, target).curve_rows(&float_frames(&t.frames)));
+        }
+        for t in &animation.physics_reset_timelines {
+            out.push(
+                TimelineDump::new(
+                    "PhysicsConstraintResetTimeline",
+                    physics_target(t.constraint_index),
+                )
+                .field("frames", Field::F(t.frames.clone())),
+            );
+        }
+        for (class, timelines) in [
+            ("SliderTimeline", &animation.slider_time_timelines),
+            ("SliderMixTimeline", &animation.slider_mix_timelines),
+        ] {
+            for t in timelines {
+                let target = constraint(self.slider[t.constraint_index] as i64);
+                out.push(TimelineDump::new(class, target).curve_rows(&float_frames(&t.frames)));
+            }
+        }
+
+        if let Some(t) = &animation.draw_order_timeline {
+            let mut dump = TimelineDump::new("DrawOrderTimeline", "all".into()).field(
+                "frames",
+                Field::F(t.frames.iter().map(|f| f.time).collect()),
+            );
+            for (i, f) in t.frames.iter().enumerate() {
+                let order = (f.draw_order_to_setup_index.iter().flatten())
+                    .map(|&s| s as i32)
+                    .collect();
+                dump = dump.field(format!("drawOrder/{i}"), Field::I(order));
+            }
+            out.push(dump);
+        }
+        if let Some(t) = &animation.event_timeline {
+            let mut dump = TimelineDump::new("EventTimeline", "all".into()).field(
+                "frames",
+                Field::F(t.events.iter().map(|e| e.time).collect()),
+            );
+            for (i, e) in t.events.iter().enumerate() {
+                dump = dump
+                    .field(
+                        format!("events/{i}/strings"),
+                        Field::S(vec![e.name.clone(), e.string.clone()]),
+                    )
+                    .field(format!("events/{i}/int"), Field::I(vec![e.int_value]))
+                    .field(
+                        format!("events/{i}/values"),
+                        Field::F(vec![e.float_value, e.volume, e.balance]),
+                    );
+            }
+            out.push(dump);
+        }
+        out
+    }
+}
+
+fn main() {
+    let args = std::env::args().skip(1).collect::<Vec<_>>();
+    if args.len() != 2 {
+        eprintln!(
+            "Usage: model_dump <skeleton.(json|skel)> <out.bin>\n\
+             \n\
+             Writes the canonical model dump read by scripts/compare_model_dump.py."
+        );
+        std::process::exit(2);
+    }
+    let data = load_skeleton_data(&PathBuf::from(&args[0]));
+    let bytes = Model::new(&data).write();
+    std::fs::write(&args[1], bytes).expect("write model dump");
+}
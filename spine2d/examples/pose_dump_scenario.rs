@@ -1,13 +1,15 @@
 use serde_json::json;
 use spine2d::{
-    AnimationState, AnimationStateData, MixBlend, Physics, Skeleton, SkeletonData, TrackEntryHandle,
+    AnimationState, AnimationStateData, AttachmentData, MixBlend, Physics, Skeleton, SkeletonData,
+    TrackEntryHandle,
 };
 use std::path::PathBuf;
 use std::sync::Arc;
+use std::time::Instant;
 
 fn print_usage_and_exit() -> ! {
     eprintln!(
-        "Usage:\n  pose_dump_scenario <skeleton.(json|skel)> <commands...>\n\nCommands:\n  --set-skin <name|none>\n  --dump-slot-vertices <slotName>\n  --dump-update-cache\n  --mix <from> <to> <duration>\n  --set <track> <animation> <loop 0|1>\n  --add <track> <animation> <loop 0|1> <delay>\n  --set-empty <track> <mixDuration>\n  --add-empty <track> <mixDuration> <delay>\n  --entry-alpha <alpha>\n  --entry-hold-previous <0|1>\n  --entry-mix-blend <setup|first|replace|add>\n  --entry-reverse <0|1>\n  --entry-shortest-rotation <0|1>\n  --entry-reset-rotation-directions\n  --physics <none|reset|update|pose>\n  --step <dt>\n"
+        "Usage:\n  pose_dump_scenario <skeleton.(json|skel)> <commands...>\n\nCommands:\n  --set-skin <name|none>\n  --dump-slot-vertices <slotName>\n  --dump-update-cache\n  --dump-all-slot-vertices\n  --mix <from> <to> <duration>\n  --set <track> <animation> <loop 0|1>\n  --add <track> <animation> <loop 0|1> <delay>\n  --set-empty <track> <mixDuration>\n  --add-empty <track> <mixDuration> <delay>\n  --entry-alpha <alpha>\n  --entry-hold-previous <0|1>\n  --entry-mix-blend <setup|first|replace|add>\n  --entry-reverse <0|1>\n  --entry-shortest-rotation <0|1>\n  --entry-reset-rotation-directions\n  --physics <none|reset|update|pose>\n  --wind <x> <y>\n  --gravity <x> <y>\n  --step <dt>\n\nBenchmark (per-phase update/apply/world/render timings as JSON):\n  --bench <iterations>\n  --bench-warmup <iterations>   (default 1)\n"
     );
     std::process::exit(2);
 }
@@ -50,17 +52,82 @@ fn parse_physics(s: &str) -> Option<Physics> {
     }
 }
 
-fn main() {
-    let mut args: Vec<String> = std::env::args().skip(1).collect();
-    if args.is_empty() {
-        print_usage_and_exit();
+struct ScenarioOutput {
+    skeleton: Skeleton,
+    total_time: f32,
+    dump_slot_vertices: Option<String>,
+    dump_update_cache: bool,
+    dump_all_slot_vertices: bool,
+}
+
+const BENCH_PHASES: [&str; 4] = ["update", "apply", "world", "render"];
+
+/// Per-phase wall-clock samples, one per benchmark iteration (summed over that iteration's steps).
+/// Mirrors the C++ oracle's `--bench` output so `scripts/bench_cross_runtime.py` can compare them.
+#[derive(Default)]
+struct BenchTimings {
+    steps: usize,
+    current: [u64; 4],
+    samples: [Vec<u64>; 4],
+}
+
+impl BenchTimings {
+    fn step(
+        &mut self,
+        state: &mut AnimationState,
+        skeleton: &mut Skeleton,
+        dt: f32,
+        physics: Physics,
+    ) {
+        let t0 = Instant::now();
+        state.update(dt);
+        let t1 = Instant::now();
+        state.apply(skeleton);
+        let t2 = Instant::now();
+        skeleton.update(dt);
+        skeleton.update_world_transform_with_physics(physics);
+        let t3 = Instant::now();
+        let draw_list = spine2d::build_draw_list(skeleton);
+        let t4 = Instant::now();
+        std::hint::black_box(&draw_list);
+
+        self.current[0] += (t1 - t0).as_nanos() as u64;
+        self.current[1] += (t2 - t1).as_nanos() as u64;
+        self.current[2] += (t3 - t2).as_nanos() as u64;
+        self.current[3] += (t4 - t3).as_nanos() as u64;
+        self.steps += 1;
     }
 
-    let json_path = PathBuf::from(args.remove(0));
+    fn begin_iteration(&mut self) {
+        self.current = [0; 4];
+        self.steps = 0;
+    }
+
+    fn end_iteration(&mut self) {
+        for (samples, current) in self.samples.iter_mut().zip(self.current) {
+            samples.push(current);
+        }
+    }
+}
+
+fn percentile_ns(samples: &[u64], q: f64) -> u64 {
+    if samples.is_empty() {
+        return 0;
+    }
+    let mut sorted = samples.to_vec();
+    sorted.sort_unstable();
+    let idx = (q * (sorted.len() - 1) as f64 + 0.5) as usize;
+    sorted[idx.min(sorted.len() - 1)]
+}
+
+fn run_scenario(
+    data: &Arc<SkeletonData>,
+    args: &[String],
+    mut bench: Option<&mut BenchTimings>,
+) -> ScenarioOutput {
     let mut dump_slot_vertices: Option<String> = None;
     let mut dump_update_cache: bool = false;
-    let data: Arc<SkeletonData> = load_skeleton_data(&json_path);
-
+    let mut dump_all_slot_vertices: bool = false;
     let mut skeleton = Skeleton::new(data.clone());
     let mut state = AnimationState::new(AnimationStateData::new(data.clone()));
     let mut last_entry: Option<TrackEntryHandle> = None;
@@ -81,6 +148,10 @@ fn main() {
                 dump_update_cache = true;
                 i += 1;
             }
+            "--dump-all-slot-vertices" => {
+                dump_all_slot_vertices = true;
+                i += 1;
+            }
             "--set-skin" if i + 1 < args.len() => {
                 let name = args[i + 1].as_str();
                 if name == "none" {
@@ -204,12 +275,28 @@ fn main() {
                     parse_physics(next).unwrap_or_else(|| panic!("invalid physics mode: {next}"));
                 i += 2;
             }
+            "--wind" if i + 2 < args.len() => {
+                let x: f32 = args[i + 1].parse().unwrap();
+                let y: f32 = args[i + 2].parse().unwrap();
+                skeleton.set_wind(x, y);
+                i += 3;
+            }
+            "--gravity" if i + 2 < args.len() => {
+                let x: f32 = args[i + 1].parse().unwrap();
+                let y: f32 = args[i + 2].parse().unwrap();
+                skeleton.set_gravity(x, y);
+                i += 3;
+            }
             "--step" if i + 1 < args.len() => {
                 let dt: f32 = args[i + 1].parse().unwrap();
-                state.update(dt);
-                state.apply(&mut skeleton);
-                skeleton.update(dt);
-                skeleton.update_world_transform_with_physics(physics);
+                if let Some(bench) = bench.as_deref_mut() {
+                    bench.step(&mut state, &mut skeleton, dt, physics);
+                } else {
+                    state.update(dt);
+                    state.apply(&mut skeleton);
+                    skeleton.update(dt);
+                    skeleton.update_world_transform_with_physics(physics);
+                }
                 total_time += dt;
                 i += 2;
             }
@@ -219,6 +306,132 @@ fn main() {
         }
     }
 
+    ScenarioOutput {
+        skeleton,
+        total_time,
+        dump_slot_vertices,
+        dump_update_cache,
+        dump_all_slot_vertices,
+    }
+}
+
+/// World vertices of every slot whose attachment is a vertex attachment, concatenated in slot order
+/// with an `offset`/`length` table. Mirrors the C++ oracle's `--dump-all-slot-vertices`.
+fn all_slot_vertices_json(skeleton: &Skeleton) -> serde_json::Value {
+    let mut table = Vec::new();
+    let mut vertices: Vec<f32> = Vec::new();
+    for (i, slot) in skeleton.data.slots.iter().enumerate() {
+        let Some(attachment) = skeleton.slot_attachment_data(i) else {
+            continue;
+        };
+        let kind = match attachment {
+            AttachmentData::Mesh(_) => "mesh",
+            AttachmentData::Path(_) => "path",
+            AttachmentData::BoundingBox(_) => "boundingbox",
+            AttachmentData::Clipping(_) => "clipping",
+            AttachmentData::Region(_) | AttachmentData::Point(_) => continue,
+        };
+        let world = skeleton
+            .slot_vertex_attachment_world_vertices(i)
+            .unwrap_or_default();
+        table.push(json!({
+            "slot": i,
+            "name": slot.name,
+            "attachment": attachment.name(),
+            "type": kind,
+            "offset": vertices.len(),
+            "length": world.len(),
+        }));
+        vertices.extend_from_slice(&world);
+    }
+    json!({ "slots": table, "vertices": vertices })
+}
+
+fn run_bench(data: &Arc<SkeletonData>, args: &[String], iterations: usize, warmup: usize) {
+    let mut timings = BenchTimings::default();
+    let mut total_time = 0.0f32;
+    for iter in 0..(warmup + iterations) {
+        timings.begin_iteration();
+        total_time = run_scenario(data, args, Some(&mut timings)).total_time;
+        if iter >= warmup {
+            timings.end_iteration();
+        }
+    }
+
+    let mut phases = serde_json::Map::new();
+    for (name, samples) in BENCH_PHASES.iter().zip(timings.samples.iter()) {
+        let mean = if samples.is_empty() {
+            0.0
+        } else {
+            samples.iter().sum::<u64>() as f64 / samples.len() as f64
+        };
+        let per_step = if timings.steps == 0 {
+            0.0
+        } else {
+            mean / timings.steps as f64
+        };
+        phases.insert(
+            name.to_string(),
+            json!({
+                "meanNs": mean,
+                "minNs": percentile_ns(samples, 0.0),
+                "p50Ns": percentile_ns(samples, 0.5),
+                "p90Ns": percentile_ns(samples, 0.9),
+                "perStepNs": per_step,
+                "samplesNs": samples,
+            }),
+        );
+    }
+    let out = json!({
+        "mode": "bench",
+        "runtime": "spine2d",
+        "iterations": iterations,
+        "warmup": warmup,
+        "steps": timings.steps,
+        "time": total_time,
+        "phases": phases,
+    });
+    println!("{}", serde_json::to_string(&out).expect("json"));
+}
+
+fn main() {
+    let mut args: Vec<String> = std::env::args().skip(1).collect();
+    if args.is_empty() {
+        print_usage_and_exit();
+    }
+
+    let json_path = PathBuf::from(args.remove(0));
+    let mut bench_iterations: usize = 0;
+    let mut bench_warmup: usize = 1;
+    let mut i = 0;
+    while i < args.len() {
+        match args[i].as_str() {
+            "--bench" if i + 1 < args.len() => {
+                bench_iterations = args[i + 1].parse().unwrap();
+                args.drain(i..i + 2);
+            }
+            "--bench-warmup" if i + 1 < args.len() => {
+                bench_warmup = args[i + 1].parse().unwrap();
+                args.drain(i..i + 2);
+            }
+            _ => i += 1,
+        }
+    }
+
+    let data: Arc<SkeletonData> = load_skeleton_data(&json_path);
+    if bench_iterations > 0 {
+        run_bench(&data, &args, bench_iterations, bench_warmup);
+        return;
+    }
+
+    let ScenarioOutput {
+        skeleton,
+        total_time,
+        dump_slot_vertices,
+        dump_update_cache,
+        dump_all_slot_vertices,
+    } = run_scenario(&data, &args, None);
+
     let bones: Vec<_> = skeleton
         .bones
         .iter()
@@ -411,6 +624,12 @@ fn main() {
             }
         }
     }
+    if dump_all_slot_vertices {
+        debug_map.insert(
+            "allSlotVertices".to_string(),
+            all_slot_vertices_json(&skeleton),
+        );
+    }
     let debug = if debug_map.is_empty() {
         None
     } else {
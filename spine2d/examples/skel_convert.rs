@@ -0,0 +1,211 @@
+use serde_json::json;
+use spine2d::{AnimationState, AnimationStateData, Skeleton, SkeletonData};
+use std::sync::Arc;
+use std::time::Instant;
+
+fn print_usage_and_exit() -> ! {
+    eprintln!(
+        "Usage: skel_convert <in.json> <out.skel> [--check] [--hz <rate>] [--load-iterations <n>]\n\
+         \n\
+         Writes <in.json> as a Spine 4.3 .skel. --check reloads the .skel and compares poses (world\n\
+         transforms, slot colors, deforms, attachments and draw order) against the JSON over every\n\
+         animation x skin x time grid at --hz (default 30); --load-iterations times both loads\n\
+         (default 0 = skip)."
+    );
+    std::process::exit(2);
+}
+
+/// One swept frame: bone world transforms, slot colors and deform vertices, plus the state that
+/// must match exactly (draw order, and per slot the attachment, sequence index and deform length).
+#[derive(Default)]
+struct Frame {
+    values: Vec<f32>,
+    draw_order: Vec<usize>,
+    attachments: Vec<(Option<String>, i32, usize)>,
+}
+
+/// Frames of `data` at every `1 / hz` step of `animation` under `skin`, from setup pose with
+/// physics off.
+fn sweep(data: &Arc<SkeletonData>, animation: &str, skin: Option<&str>, hz: f32) -> Vec<Frame> {
+    let mut skeleton = Skeleton::new(data.clone());
+    skeleton.set_skin(skin).expect("skin exists");
+    skeleton.set_to_setup_pose();
+    let mut state = AnimationState::new(AnimationStateData::new(data.clone()));
+    state
+        .set_animation(0, animation, false)
+        .expect("set animation");
+    let duration = data
+        .animation(animation)
+        .map(|(_, a)| a.duration)
+        .unwrap_or(0.0);
+    let frames = (duration * hz).floor() as usize + 1;
+    let mut out = Vec::with_capacity(frames);
+    for frame in 0..frames {
+        if frame > 0 {
+            state.update(1.0 / hz);
+        }
+        skeleton.set_to_setup_pose();
+        state.apply(&mut skeleton);
+        skeleton.update_world_transform();
+        let mut f = Frame {
+            draw_order: skeleton.draw_order.clone(),
+            ..Frame::default()
+        };
+        for b in &skeleton.bones {
+            f.values.extend([b.a, b.b, b.c, b.d, b.world_x, b.world_y]);
+        }
+        for s in &skeleton.slots {
+            f.values.extend(s.color);
+            f.values.extend(&s.deform);
+            f.attachments
+                .push((s.attachment.clone(), s.sequence_index, s.deform.len()));
+        }
+        out.push(f);
+    }
+    out
+}
+
+fn median_us<T>(iterations: usize, mut f: impl FnMut() -> T) -> f64 {
+    let mut samples: Vec<f64> = (0..iterations)
+        .map(|_| {
+            let start = Instant::now();
+            std::hint::black_box(f());
+            start.elapsed().as_secs_f64() * 1.0e6
+        })
+        .collect();
+    samples.sort_by(f64::total_cmp);
+    samples.get(samples.len() / 2).copied().unwrap_or(0.0)
+}
+
+fn main() {
+    let args = std::env::args().skip(1).collect::<Vec<_>>();
+    let mut positional = Vec::<String>::new();
+    let mut check = false;
+    let mut hz = 30.0f32;
+    let mut load_iterations = 0usize;
+
+    let mut i = 0usize;
+    while i < args.len() {
+        match args[i].as_str() {
+            "--check" => {
+                check = true;
+                i += 1;
+            }
+            "--hz" if i + 1 < args.len() => {
+                hz = args[i + 1]
+                    .parse()
+                    .unwrap_or_else(|_| print_usage_and_exit());
+                i += 2;
+            }
+            "--load-iterations" if i + 1 < args.len() => {
+                load_iterations = args[i + 1]
+                    .parse()
+                    .unwrap_or_else(|_| print_usage_and_exit());
+                i += 2;
+            }
+            other if !other.starts_with("--") => {
+                positional.push(other.to_string());
+                i += 1;
+            }
+            _ => print_usage_and_exit(),
+        }
+    }
+    if positional.len() != 2 || !hz.is_finite() || hz <= 0.0 {
+        print_usage_and_exit();
+    }
+
+    let json_text = std::fs::read_to_string(&positional[0]).expect("read json");
+    let json_data = SkeletonData::from_json_str(&json_text).expect("parse json");
+    let bytes = match json_data.to_skel_bytes() {
+        Ok(bytes) => bytes,
+        Err(e) => {
+            eprintln!("{}: {e}", positional[0]);
+            std::process::exit(1);
+        }
+    };
+    std::fs::write(&positional[1], &bytes).expect("write skel");
+
+    let mut summary = json!({
+        "json": positional[0],
+        "skel": positional[1],
+        "jsonBytes": json_text.len(),
+        "skelBytes": bytes.len(),
+    });
+
+    let mut failed = false;
+    if check {
+        let skel_data = SkeletonData::from_skel_bytes(&bytes).expect("parse written skel");
+        let mut skins: Vec<Option<&str>> =
+            json_data.skins.keys().map(|s| Some(s.as_str())).collect();
+        skins.sort();
+        if skins.is_empty() {
+            skins.push(None);
+        }
+        let mut max_diff = 0.0f32;
+        let mut worst = json!(null);
+        let mut frames = 0usize;
+        for animation in &json_data.animations {
+            for &skin in &skins {
+                let a = sweep(&json_data, &animation.name, skin, hz);
+                let b = sweep(&skel_data, &animation.name, skin, hz);
+                if a.len() != b.len() {
+                    failed = true;
+                    worst = json!({"animation": animation.name, "skin": skin, "frames": [a.len(), b.len()]});
+                    continue;
+                }
+                frames += a.len();
+                for (frame, (fa, fb)) in a.iter().zip(&b).enumerate() {
+                    if fa.draw_order != fb.draw_order || fa.attachments != fb.attachments {
+                        failed = true;
+                        if max_diff.is_finite() {
+                            max_diff = f32::INFINITY;
+                            worst = json!({
+                                "animation": animation.name,
+                                "skin": skin,
+                                "time": frame as f32 / hz,
+                                "drawOrder": [fa.draw_order, fb.draw_order],
+                                "attachments": [fa.attachments, fb.attachments],
+                            });
+                        }
+                        break;
+                    }
+                    for (x, y) in fa.values.iter().zip(&fb.values) {
+                        let d = (x - y).abs();
+                        let d = if d.is_nan() { f32::INFINITY } else { d };
+                        if d > max_diff {
+                            max_diff = d;
+                            worst = json!({
+                                "animation": animation.name,
+                                "skin": skin,
+                                "time": frame as f32 / hz,
+                            });
+                        }
+                    }
+                }
+            }
+        }
+        summary["check"] = json!({
+            "hz": hz,
+            "frames": frames,
+            "maxDiff": if max_diff.is_finite() { json!(max_diff) } else { json!(null) },
+            "worst": worst,
+        });
+        failed |= max_diff > 1.0e-3;
+    }
+
+    if load_iterations > 0 {
+        summary["load"] = json!({
+            "iterations": load_iterations,
+            "jsonMedianUs": median_us(load_iterations, || SkeletonData::from_json_str(&json_text)),
+            "skelMedianUs": median_us(load_iterations, || SkeletonData::from_skel_bytes(&bytes)),
+        });
+    }
+
+    println!(
+        "{}",
+        serde_json::to_string(&summary).expect("serialize summary")
+    );
+    if failed {
+        std::process::exit(1);
+    }
+}
@@ -0,0 +1,431 @@
+//! Pre-baked binary atlas index.
+//!
+//! The `.atlas` text is re-parsed on every [`Atlas::parse`]; an index baked once (by
+//! [`Atlas::to_index_bytes`] or `scripts/spine_cpp_lite_atlas_index.cpp`) loads with fixed-size
+//! record reads and answers region lookups through an embedded hash table without building a map.
+//!
+//! Layout (little-endian):
+//! - header (32 bytes): `"SPAI"`, version, page count, region count, bucket count (power of two),
+//!   string blob offset, string blob length, reserved.
+//! - pages (24 bytes each): name offset/length, width, height, scale (f32), pma, min filter,
+//!   mag filter, wrap (`u | v << 2`).
+//! - regions (52 bytes each): name offset/length, FNV-1a hash of the name, page, degrees, x, y,
+//!   width, height, offset x/y (i32), original width/height.
+//! - buckets (u32 each): region index + 1 (0 = empty), open addressing with linear probing from
+//!   `hash & (bucket_count - 1)`. Regions are inserted in record order, so a duplicated name
+//!   resolves to its first record.
+//! - string blob: UTF-8 names, each followed by a NUL (not counted in the length) for C readers.
+
+use crate::{Atlas, AtlasFilter, AtlasPage, AtlasRegion, AtlasWrap, Error};
+use std::collections::HashMap;
+
+const MAGIC: &[u8; 4] = b"SPAI";
+const VERSION: u32 = 1;
+const HEADER_SIZE: usize = 32;
+const PAGE_SIZE: usize = 24;
+const REGION_SIZE: usize = 52;
+const FILTER_OTHER: u8 = 255;
+
+/// FNV-1a (32-bit) over the UTF-8 bytes of a region name.
+pub fn atlas_index_hash(name: &str) -> u32 {
+    name.bytes().fold(0x811c_9dc5u32, |h, b| {
+        (h ^ b as u32).wrapping_mul(0x0100_0193)
+    })
+}
+
+fn filter_code(filter: &AtlasFilter) -> u8 {
+    match filter {
+        AtlasFilter::Nearest => 0,
+        AtlasFilter::Linear => 1,
+        AtlasFilter::MipMap => 2,
+        AtlasFilter::MipMapNearestNearest => 3,
+        AtlasFilter::MipMapNearestLinear => 4,
+        AtlasFilter::MipMapLinearNearest => 5,
+        AtlasFilter::MipMapLinearLinear => 6,
+        AtlasFilter::Other(_) => FILTER_OTHER,
+    }
+}
+
+fn filter_from_code(code: u8) -> AtlasFilter {
+    match code {
+        0 => AtlasFilter::Nearest,
+        1 => AtlasFilter::Linear,
+        2 => AtlasFilter::MipMap,
+        3 => AtlasFilter::MipMapNearestNearest,
+        4 => AtlasFilter::MipMapNearestLinear,
+        5 => AtlasFilter::MipMapLinearNearest,
+        6 => AtlasFilter::MipMapLinearLinear,
+        _ => AtlasFilter::Other(String::new()),
+    }
+}
+
+fn wrap_code(wrap: AtlasWrap) -> u8 {
+    match wrap {
+        AtlasWrap::ClampToEdge => 0,
+        AtlasWrap::Repeat => 1,
+    }
+}
+
+fn wrap_from_code(code: u8) -> AtlasWrap {
+    match code & 3 {
+        1 => AtlasWrap::Repeat,
+        _ => AtlasWrap::ClampToEdge,
+    }
+}
+
+fn invalid(message: impl Into<String>) -> Error {
+    Error::AtlasParse {
+        message: format!("atlas index: {}", message.into()),
+    }
+}
+
+impl Atlas {
+    /// Serializes the atlas as a binary index (see the `atlas_index` module docs).
+    ///
+    /// Regions are written in name order. Unrecognized filter names (`AtlasFilter::Other`) are
+    /// stored as a single "other" code and read back as `Other("")`.
+    pub fn to_index_bytes(&self) -> Vec<u8> {
+        let mut regions: Vec<&AtlasRegion> = self.regions.values().collect();
+        regions.sort_by(|a, b| a.name.cmp(&b.name));
+        let bucket_count = (regions.len() * 2).max(1).next_power_of_two();
+
+        let mut strings = Vec::new();
+        let mut intern = |s: &str| {
+            let offset = strings.len() as u32;
+            strings.extend_from_slice(s.as_bytes());
+            strings.push(0);
+            (offset, s.len() as u32)
+        };
+
+        let strings_offset = HEADER_SIZE
+            + self.pages.len() * PAGE_SIZE
+            + regions.len() * REGION_SIZE
+            + bucket_count * 4;
+        let mut out = Vec::with_capacity(strings_offset);
+        out.extend_from_slice(MAGIC);
+        for v in [
+            VERSION,
+            self.pages.len() as u32,
+            regions.len() as u32,
+            bucket_count as u32,
+            strings_offset as u32,
+            0,
+            0,
+        ] {
+            out.extend(v.to_le_bytes());
+        }
+
+        for page in &self.pages {
+            let (offset, len) = intern(&page.name);
+            for v in [offset, len, page.width, page.height] {
+                out.extend(v.to_le_bytes());
+            }
+            out.extend(page.scale.to_le_bytes());
+            out.extend([
+                page.pma as u8,
+                filter_code(&page.min_filter),
+                filter_code(&page.mag_filter),
+                wrap_code(page.wrap_u) | (wrap_code(page.wrap_v) << 2),
+            ]);
+        }
+
+        let mut buckets = vec![0u32; bucket_count];
+        for (i, region) in regions.iter().enumerate() {
+            let (offset, len) = intern(&region.name);
+            let hash = atlas_index_hash(&region.name);
+            for v in [
+                offset,
+                len,
+                hash,
+                region.page as u32,
+                region.degrees as u32,
+                region.x,
+                region.y,
+                region.width,
+                region.height,
+            ] {
+                out.extend(v.to_le_bytes());
+            }
+            out.extend(region.offset_x.to_le_bytes());
+            out.extend(region.offset_y.to_le_bytes());
+            out.extend(region.original_width.to_le_bytes());
+            out.extend(region.original_height.to_le_bytes());
+
+            let mut b = hash as usize & (bucket_count - 1);
+            while buckets[b] != 0 {
+                b = (b + 1) & (bucket_count - 1);
+            }
+            buckets[b] = i as u32 + 1;
+        }
+        for b in buckets {
+            out.extend(b.to_le_bytes());
+        }
+
+        let strings_len = strings.len() as u32;
+        out[24..28].copy_from_slice(&strings_len.to_le_bytes());
+        out.extend(strings);
+        out
+    }
+
+    /// Decodes a binary atlas index into an [`Atlas`], validating every record.
+    pub fn from_index_bytes(bytes: &[u8]) -> Result<Self, Error> {
+        let index = AtlasIndex::new(bytes)?;
+        let pages = (0..index.page_count())
+            .map(|i| {
+                index
+                    .page(i)
+                    .ok_or_else(|| invalid(format!("bad page {i}")))
+            })
+            .collect::<Result<Vec<_>, _>>()?;
+        let mut regions = HashMap::with_capacity(index.region_count());
+        for i in 0..index.region_count() {
+            let region = index
+                .region(i)
+                .ok_or_else(|| invalid(format!("bad region {i}")))?;
+            if region.page >= pages.len() {
+                return Err(invalid(format!(
+                    "region '{}' page out of range",
+                    region.name
+                )));
+            }
+            // Same precedence as the index lookup: the first record of a duplicated name wins.
+            regions.entry(region.name.clone()).or_insert(region);
+        }
+        Ok(Self { pages, regions })
+    }
+}
+
+/// Zero-copy view over a binary atlas index; lookups go through the embedded hash table.
+#[derive(Copy, Clone, Debug)]
+pub struct AtlasIndex<'a> {
+    bytes: &'a [u8],
+    page_count: usize,
+    region_count: usize,
+    bucket_count: usize,
+    strings: &'a [u8],
+}
+
+impl<'a> AtlasIndex<'a> {
+    /// Validates the header and table bounds. Records are checked as they are read.
+    pub fn new(bytes: &'a [u8]) -> Result<Self, Error> {
+        if bytes.len() < HEADER_SIZE || &bytes[0..4] != MAGIC {
+            return Err(invalid("missing SPAI header"));
+        }
+        let header = |i: usize| u32_at(bytes, 4 + i * 4).unwrap_or(0) as usize;
+        if header(0) != VERSION as usize {
+            return Err(invalid(format!("unsupported version {}", header(0))));
+        }
+        let (page_count, region_count, bucket_count) = (header(1), header(2), header(3));
+        let (strings_offset, strings_len) = (header(4), header(5));
+        if !bucket_count.is_power_of_two() || bucket_count < region_count {
+            return Err(invalid(format!("bad bucket count {bucket_count}")));
+        }
+        let tables_end = page_count
+            .checked_mul(PAGE_SIZE)
+            .and_then(|p| Some(p + region_count.checked_mul(REGION_SIZE)?))
+            .and_then(|r| Some(r + bucket_count.checked_mul(4)?))
+            .map(|t| t + HEADER_SIZE)
+            .ok_or_else(|| invalid("table sizes overflow"))?;
+        let strings = strings_offset
+            .checked_add(strings_len)
+            .filter(|&end| strings_offset >= tables_end && end <= bytes.len())
+            .map(|end| &bytes[strings_offset..end])
+            .ok_or_else(|| invalid("string blob out of range"))?;
+        Ok(Self {
+            bytes,
+            page_count,
+            region_count,
+            bucket_count,
+            strings,
+        })
+    }
+
+    pub fn page_count(&self) -> usize {
+        self.page_count
+    }
+
+    pub fn region_count(&self) -> usize {
+        self.region_count
+    }
+
+    fn string(&self, offset: u32, len: u32) -> Option<&'a str> {
+        let start = offset as usize;
+        let bytes = self.strings.get(start..start.checked_add(len as usize)?)?;
+        std::str::from_utf8(bytes).ok()
+    }
+
+    pub fn page(&self, index: usize) -> Option<AtlasPage> {
+        if index >= self.page_count {
+            return None;
+        }
+        let at = HEADER_SIZE + index * PAGE_SIZE;
+        let flags = self.bytes.get(at + 20..at + 24)?;
+        Some(AtlasPage {
+            name: self
+                .string(u32_at(self.bytes, at)?, u32_at(self.bytes, at + 4)?)?
+                .to_string(),
+            width: u32_at(self.bytes, at + 8)?,
+            height: u32_at(self.bytes, at + 12)?,
+            scale: f32::from_bits(u32_at(self.bytes, at + 16)?),
+            pma: flags[0] != 0,
+            min_filter: filter_from_code(flags[1]),
+            mag_filter: filter_from_code(flags[2]),
+            wrap_u: wrap_from_code(flags[3]),
+            wrap_v: wrap_from_code(flags[3] >> 2),
+        })
+    }
+
+    fn region_at(&self, index: usize) -> usize {
+        HEADER_SIZE + self.page_count * PAGE_SIZE + index * REGION_SIZE
+    }
+
+    /// Name of the `index`-th region record without decoding the rest of it.
+    pub fn region_name(&self, index: usize) -> Option<&'a str> {
+        if index >= self.region_count {
+            return None;
+        }
+        let at = self.region_at(index);
+        self.string(u32_at(self.bytes, at)?, u32_at(self.bytes, at + 4)?)
+    }
+
+    pub fn region(&self, index: usize) -> Option<AtlasRegion> {
+        let name = self.region_name(index)?;
+        let at = self.region_at(index);
+        let field = |i: usize| u32_at(self.bytes, at + 12 + i * 4);
+        Some(AtlasRegion {
+            name: name.to_string(),
+            page: field(0)? as usize,
+            degrees: u16::try_from(field(1)?).ok()?,
+            x: field(2)?,
+            y: field(3)?,
+            width: field(4)?,
+            height: field(5)?,
+            offset_x: field(6)? as i32,
+            offset_y: field(7)? as i32,
+            original_width: field(8)?,
+            original_height: field(9)?,
+        })
+    }
+
+    /// Index of the first region record named `name`.
+    pub fn find_index(&self, name: &str) -> Option<usize> {
+        let hash = atlas_index_hash(name);
+        let buckets = self.region_at(self.region_count);
+        let mask = self.bucket_count - 1;
+        let mut b = hash as usize & mask;
+        for _ in 0..self.bucket_count {
+            let slot = u32_at(self.bytes, buckets + b * 4)? as usize;
+            if slot == 0 {
+                return None;
+            }
+            let index = slot - 1;
+            if u32_at(self.bytes, self.region_at(index) + 8)? == hash
+                && self.region_name(index)? == name
+            {
+                return Some(index);
+            }
+            b = (b + 1) & mask;
+        }
+        None
+    }
+
+    pub fn find(&self, name: &str) -> Option<AtlasRegion> {
+        self.region(self.find_index(name)?)
+    }
+}
+
+fn u32_at(bytes: &[u8], at: usize) -> Option<u32> {
+    let b = bytes.get(at..at.checked_add(4)?)?;
+    Some(u32::from_le_bytes([b[0], b[1], b[2], b[3]]))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const ATLAS: &str = r#"
+page0.png
+size: 64,64
+scale: 0.5
+pma: true
+filter: MipMapLinearLinear, Nearest
+repeat: x
+
+head
+  rotate: 90
+  xy: 2, 4
+  size: 16, 8
+  offset: 1, 2
+  orig: 20, 12
+eye
+  xy: 20, 4
+  size: 4, 4
+
+page1.png
+size: 32,16
+filter: Linear, Linear
+
+tail
+  xy: 0, 0
+  size: 8, 8
+"#;
+
+    fn assert_region_eq(a: &AtlasRegion, b: &AtlasRegion) {
+        assert_eq!(a.name, b.name);
+        assert_eq!(
+            (a.page, a.degrees, a.x, a.y, a.width, a.height),
+            (b.page, b.degrees, b.x, b.y, b.width, b.height)
+        );
+        assert_eq!(
+            (a.offset_x, a.offset_y, a.original_width, a.original_height),
+            (b.offset_x, b.offset_y, b.original_width, b.original_height)
+        );
+    }
+
+    #[test]
+    fn atlas_index_round_trips_pages_and_regions() {
+        let atlas = Atlas::parse(ATLAS).unwrap();
+        let bytes = atlas.to_index_bytes();
+        let decoded = Atlas::from_index_bytes(&bytes).unwrap();
+
+        assert_eq!(decoded.pages.len(), 2);
+        for (a, b) in atlas.pages.iter().zip(&decoded.pages) {
+            assert_eq!(a.name, b.name);
+            assert_eq!((a.width, a.height, a.pma), (b.width, b.height, b.pma));
+            assert_eq!(a.scale.to_bits(), b.scale.to_bits());
+            assert_eq!(
+                (&a.min_filter, &a.mag_filter),
+                (&b.min_filter, &b.mag_filter)
+            );
+            assert_eq!((a.wrap_u, a.wrap_v), (b.wrap_u, b.wrap_v));
+        }
+        assert_eq!(decoded.regions.len(), atlas.regions.len());
+        for (name, region) in &atlas.regions {
+            assert_region_eq(region, &decoded.regions[name]);
+        }
+        assert_eq!(decoded.to_index_bytes(), bytes);
+    }
+
+    #[test]
+    fn atlas_index_finds_regions_through_hash_table() {
+        let atlas = Atlas::parse(ATLAS).unwrap();
+        let bytes = atlas.to_index_bytes();
+        let index = AtlasIndex::new(&bytes).unwrap();
+        assert_eq!(index.region_count(), 3);
+        for (name, region) in &atlas.regions {
+            assert_region_eq(region, &index.find(name).unwrap());
+        }
+        assert!(index.find("missing").is_none());
+        assert!(index.find("").is_none());
+    }
+
+    #[test]
+    fn atlas_index_rejects_truncated_input() {
+        let bytes = Atlas::parse(ATLAS).unwrap().to_index_bytes();
+        assert!(AtlasIndex::new(&bytes[..HEADER_SIZE - 1]).is_err());
+        assert!(AtlasIndex::new(&bytes[..bytes.len() - 1]).is_err());
+        let mut bad_magic = bytes.clone();
+        bad_magic[0] = b'X';
+        assert!(Atlas::from_index_bytes(&bad_magic).is_err());
+    }
+}
@@ -21,53 +21,53 @@ use byteorder::{BigEndian, ByteOrder};
 use std::collections::HashMap;
 use std::sync::Arc;
 
-const CURVE_LINEAR: i8 = 0;
-const CURVE_STEPPED: i8 = 1;
-const CURVE_BEZIER: i8 = 2;
-
-const ATTACHMENT_DEFORM: u8 = 0;
-const ATTACHMENT_SEQUENCE: u8 = 1;
-
-const SLOT_ATTACHMENT: u8 = 0;
-const SLOT_RGBA: u8 = 1;
-const SLOT_RGB: u8 = 2;
-const SLOT_RGBA2: u8 = 3;
-const SLOT_RGB2: u8 = 4;
-const SLOT_ALPHA: u8 = 5;
-
-const BONE_ROTATE: u8 = 0;
-const BONE_TRANSLATE: u8 = 1;
-const BONE_TRANSLATEX: u8 = 2;
-const BONE_TRANSLATEY: u8 = 3;
-const BONE_SCALE: u8 = 4;
-const BONE_SCALEX: u8 = 5;
-const BONE_SCALEY: u8 = 6;
-const BONE_SHEAR: u8 = 7;
-const BONE_SHEARX: u8 = 8;
-const BONE_SHEARY: u8 = 9;
-const BONE_INHERIT: u8 = 10;
-
-const PATH_POSITION: u8 = 0;
-const PATH_SPACING: u8 = 1;
-const PATH_MIX: u8 = 2;
-
-const PHYSICS_INERTIA: u8 = 0;
-const PHYSICS_STRENGTH: u8 = 1;
-const PHYSICS_DAMPING: u8 = 2;
-const PHYSICS_MASS: u8 = 4;
-const PHYSICS_WIND: u8 = 5;
-const PHYSICS_GRAVITY: u8 = 6;
-const PHYSICS_MIX: u8 = 7;
-const PHYSICS_RESET: u8 = 8;
-
-const SLIDER_TIME: u8 = 0;
-const SLIDER_MIX: u8 = 1;
-
-const CONSTRAINT_IK: u8 = 0;
-const CONSTRAINT_PATH: u8 = 1;
-const CONSTRAINT_TRANSFORM: u8 = 2;
-const CONSTRAINT_PHYSICS: u8 = 3;
-const CONSTRAINT_SLIDER: u8 = 4;
+pub(crate) const CURVE_LINEAR: i8 = 0;
+pub(crate) const CURVE_STEPPED: i8 = 1;
+pub(crate) const CURVE_BEZIER: i8 = 2;
+
+pub(crate) const ATTACHMENT_DEFORM: u8 = 0;
+pub(crate) const ATTACHMENT_SEQUENCE: u8 = 1;
+
+pub(crate) const SLOT_ATTACHMENT: u8 = 0;
+pub(crate) const SLOT_RGBA: u8 = 1;
+pub(crate) const SLOT_RGB: u8 = 2;
+pub(crate) const SLOT_RGBA2: u8 = 3;
+pub(crate) const SLOT_RGB2: u8 = 4;
+pub(crate) const SLOT_ALPHA: u8 = 5;
+
+pub(crate) const BONE_ROTATE: u8 = 0;
+pub(crate) const BONE_TRANSLATE: u8 = 1;
+pub(crate) const BONE_TRANSLATEX: u8 = 2;
+pub(crate) const BONE_TRANSLATEY: u8 = 3;
+pub(crate) const BONE_SCALE: u8 = 4;
+pub(crate) const BONE_SCALEX: u8 = 5;
+pub(crate) const BONE_SCALEY: u8 = 6;
+pub(crate) const BONE_SHEAR: u8 = 7;
+pub(crate) const BONE_SHEARX: u8 = 8;
+pub(crate) const BONE_SHEARY: u8 = 9;
+pub(crate) const BONE_INHERIT: u8 = 10;
+
+pub(crate) const PATH_POSITION: u8 = 0;
+pub(crate) const PATH_SPACING: u8 = 1;
+pub(crate) const PATH_MIX: u8 = 2;
+
+pub(crate) const PHYSICS_INERTIA: u8 = 0;
+pub(crate) const PHYSICS_STRENGTH: u8 = 1;
+pub(crate) const PHYSICS_DAMPING: u8 = 2;
+pub(crate) const PHYSICS_MASS: u8 = 4;
+pub(crate) const PHYSICS_WIND: u8 = 5;
+pub(crate) const PHYSICS_GRAVITY: u8 = 6;
+pub(crate) const PHYSICS_MIX: u8 = 7;
+pub(crate) const PHYSICS_RESET: u8 = 8;
+
+pub(crate) const SLIDER_TIME: u8 = 0;
+pub(crate) const SLIDER_MIX: u8 = 1;
+
+pub(crate) const CONSTRAINT_IK: u8 = 0;
+pub(crate) const CONSTRAINT_PATH: u8 = 1;
+pub(crate) const CONSTRAINT_TRANSFORM: u8 = 2;
+pub(crate) const CONSTRAINT_PHYSICS: u8 = 3;
+pub(crate) const CONSTRAINT_SLIDER: u8 = 4;
 
 // Spine 4.3 binary format stores constraints in a single ordered list (mixed types). Animation
 // timelines reference constraints by that combined index, so we need a mapping to our per-type
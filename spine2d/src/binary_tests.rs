@@ -625,3 +625,179 @@ fn debug_dump_tank_shoot_t01_skel_vs_json() {
         }
     }
 }
+
+#[cfg(all(feature = "json", feature = "binary"))]
+const ROUND_TRIP_JSON: &str = r#"{
+"skeleton":{"spine":"4.3.00"},
+"bones":[
+  {"name":"root"},
+  {"name":"hip","parent":"root","y":20},
+  {"name":"upper","parent":"hip","rotation":-80,"length":40},
+  {"name":"lower","parent":"upper","x":40,"rotation":10,"length":40},
+  {"name":"target","parent":"root","x":50,"y":-30},
+  {"name":"follow","parent":"root","x":-20,"shearY":5},
+  {"name":"rider","parent":"root"}
+],
+"slots":[
+  {"name":"body","bone":"hip","attachment":"body","color":"ff8080ff","dark":"203040","blend":"additive"},
+  {"name":"mesh","bone":"upper","attachment":"mesh"},
+  {"name":"tip","bone":"lower","attachment":"tip"},
+  {"name":"rail","bone":"root","attachment":"rail"}
+],
+"constraints":[
+  {"type":"ik","name":"leg","bones":["upper","lower"],"target":"target","mix":0.75,"softness":5,"bendPositive":false},
+  {"type":"transform","name":"copy","bones":["follow"],"source":"hip","x":3,"rotation":15,"mixRotate":0.5,"mixX":1,"mixY":1},
+  {"type":"path","name":"ride","bones":["rider"],"target":"rail","spacingMode":"fixed","rotateMode":"chain","position":0.25,"spacing":10}
+],
+"skins":[
+  {"name":"default","attachments":{
+    "body":{"body":{"x":1,"y":2,"rotation":12,"width":30,"height":20,"color":"80ffffc0"}},
+    "mesh":{"mesh":{"type":"mesh","uvs":[0,0,1,0,1,1,0,1],"triangles":[0,1,2,2,3,0],
+      "vertices":[0,-5,40,-5,40,5,0,5],"hull":4}},
+    "tip":{"tip":{"width":8,"height":8},"tip2":{"name":"tip-alt","width":6,"height":10}},
+    "rail":{"rail":{"type":"path","vertexCount":6,"vertices":[0,0,0,0,30,20,60,-20,90,0,90,0],"lengths":[50,100]}}
+  }},
+  {"name":"alt","attachments":{
+    "mesh":{"mesh":{"type":"linkedmesh","parent":"mesh","skin":"default","path":"mesh-alt","color":"c0c0ffff"}}
+  }}
+],
+"events":{"hit":{"int":3,"float":0.5,"string":"boom"}},
+"animations":{
+  "walk":{
+    "bones":{
+      "hip":{
+        "rotate":[{"time":0,"value":0,"curve":[0.25,0,0.75,30]},{"time":0.5,"value":30},{"time":1,"value":0}],
+        "translate":[{"time":0,"curve":[0.2,0,0.8,10,0.2,0,0.8,-5]},{"time":0.5,"x":10,"y":-5,"curve":"stepped"},{"time":1}],
+        "scale":[{"time":0},{"time":1,"x":1.2,"y":0.8}]
+      }
+    },
+    "slots":{
+      "body":{"rgba":[{"time":0,"color":"ffffffff"},{"time":1,"color":"ff0000c0"}]},
+      "tip":{"attachment":[{"time":0.5,"name":"tip2"}]}
+    },
+    "attachments":{"default":{"mesh":{"mesh":{"deform":[
+      {"time":0},{"time":0.5,"offset":2,"vertices":[5,5],"curve":[0.3,0,0.7,1]},{"time":1}
+    ]}}}},
+    "ik":{"leg":[{"time":0,"mix":1},{"time":0.5,"mix":0.25,"softness":2,"bendPositive":true,"curve":"stepped"},{"time":1}]},
+    "transform":{"copy":[{"time":0,"mixRotate":0},{"time":1,"mixRotate":1}]},
+    "path":{"ride":{"position":[{"time":0,"value":0.25},{"time":1,"value":0.75}]}},
+    "drawOrder":[{"time":0.5,"offsets":[{"slot":"tip","offset":-2}]},{"time":1}],
+    "events":[{"time":0.25,"name":"hit"},{"time":0.75,"name":"hit","string":"bang","int":7}]
+  },
+  "idle":{}
+}
+}"#;
+
+#[cfg(all(feature = "json", feature = "binary"))]
+fn pose_with_skin(
+    data: Arc<SkeletonData>,
+    skin: Option<&str>,
+    animation_name: &str,
+    time: f32,
+) -> Skeleton {
+    let (_, anim) = data.animation(animation_name).expect("animation exists");
+    let mut skeleton = Skeleton::new(data.clone());
+    skeleton.set_skin(skin).expect("skin exists");
+    skeleton.set_to_setup_pose();
+    apply_animation(anim, &mut skeleton, time, false, 1.0, MixBlend::Replace);
+    skeleton.update_world_transform();
+    skeleton
+}
+
+#[test]
+#[cfg(all(feature = "json", feature = "binary"))]
+fn to_skel_bytes_round_trips_json_pose() {
+    let json = SkeletonData::from_json_str(ROUND_TRIP_JSON).expect("parse json");
+    let bytes = json.to_skel_bytes().expect("write skel");
+    let skel = SkeletonData::from_skel_bytes(&bytes).expect("parse written skel");
+
+    assert_eq!(skel.bones.len(), json.bones.len());
+    assert_eq!(skel.slots[0].blend, json.slots[0].blend);
+    assert!(skel.slots[0].has_dark);
+    for name in ["walk", "idle"] {
+        let (_, a) = json.animation(name).expect("json animation");
+        let (_, b) = skel.animation(name).expect("skel animation");
+        assert_approx(b.duration, a.duration, 0.0, &format!("{name}.duration"));
+    }
+
+    let (_, walk) = skel.animation("walk").expect("walk");
+    assert_eq!(walk.bone_timelines.len(), 3);
+    assert_eq!(walk.deform_timelines.len(), 1);
+    assert_eq!(walk.ik_constraint_timelines.len(), 1);
+    assert_eq!(walk.transform_constraint_timelines.len(), 1);
+    assert_eq!(walk.path_constraint_timelines.len(), 1);
+    assert_eq!(
+        skel.path_constraints[0].position_mode,
+        json.path_constraints[0].position_mode
+    );
+    match skel.skin("alt").and_then(|s| s.attachment(1, "mesh")) {
+        Some(crate::AttachmentData::Mesh(m)) => {
+            assert_eq!(m.path, "mesh-alt");
+            assert_eq!(
+                (m.timeline_skin.as_str(), m.timeline_attachment.as_str()),
+                ("default", "mesh")
+            );
+        }
+        other => panic!("alt mesh: {other:?}"),
+    }
+    let events = &walk.event_timeline.as_ref().expect("event timeline").events;
+    assert_eq!(
+        events
+            .iter()
+            .map(|e| (e.int_value, e.string.as_str()))
+            .collect::<Vec<_>>(),
+        [(3, "boom"), (7, "bang")]
+    );
+
+    for skin in [None, Some("alt")] {
+        for step in 0..=10 {
+            let t = step as f32 * 0.1;
+            let a = pose_with_skin(skel.clone(), skin, "walk", t);
+            let b = pose_with_skin(json.clone(), skin, "walk", t);
+            assert_pose_close(&a, &b, 1.0e-4, &format!("walk skin={skin:?} t={t}"));
+        }
+    }
+
+    // Writing the reloaded data reproduces the file byte for byte.
+    assert_eq!(skel.to_skel_bytes().expect("rewrite skel"), bytes);
+}
+
+#[test]
+#[cfg(all(feature = "json", feature = "binary"))]
+fn to_skel_bytes_rejects_unencodable_path_position_mode() {
+    // Percent position with length spacing: spine-cpp would read the position mode as fixed.
+    let json =
+        SkeletonData::from_json_str(&ROUND_TRIP_JSON.replace(r#""spacingMode":"fixed","#, ""))
+            .expect("parse json");
+    match json.to_skel_bytes() {
+        Err(crate::Error::InvalidValue { message }) => {
+            assert!(message.contains("'ride'"), "{message}")
+        }
+        other => panic!("expected InvalidValue, got {other:?}"),
+    }
+}
+
+#[test]
+#[ignore]
+#[cfg(all(feature = "json", feature = "binary", feature = "upstream-smoke"))]
+fn to_skel_bytes_round_trips_upstream_examples() {
+    for (rel, animation) in [
+        (
+            "assets/spine-runtimes/examples/spineboy/export/spineboy-pro.json",
+            "run",
+        ),
+        (
+            "assets/spine-runtimes/examples/tank/export/tank-pro.json",
+            "shoot",
+        ),
+    ] {
+        let json = SkeletonData::from_json_str(&load_string(rel)).expect("parse json");
+        let bytes = json.to_skel_bytes().expect("write skel");
+        let skel = SkeletonData::from_skel_bytes(&bytes).expect("parse written skel");
+        for &t in &[0.0, 0.1, 0.3, 0.5] {
+            let a = pose_at(skel.clone(), animation, t);
+            let b = pose_at(json.clone(), animation, t);
+            assert_pose_close(&a, &b, 1.0e-3, &format!("{rel} {animation} t={t}"));
+        }
+    }
+}
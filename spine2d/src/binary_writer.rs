@@ -0,0 +1,1560 @@
+//! Spine `.skel` (binary) writer for Spine 4.3, the inverse of [`crate::binary`].
+//!
+//! Serializes already loaded [`SkeletonData`] (typically parsed from JSON) so exports can ship as
+//! `.skel` for faster loading. Nonessential data (colors, edges, image paths, fps) is not part of
+//! the model and is omitted. Values are written as stored, i.e. with the load scale applied.
+//!
+//! Limitations of the model and format that the writer reports as [`Error::InvalidValue`]:
+//! mixed stepped/Bezier channels within one key, meshes whose triangle count implies a negative
+//! hull length, more than 7 transform constraint "from" properties, path constraints whose position
+//! mode the format cannot carry next to their spacing mode, and slider constraints without an
+//! animation. A clipping attachment without an end slot is written as ending at the last slot.
+
+use crate::binary::{
+    ATTACHMENT_DEFORM, ATTACHMENT_SEQUENCE, BONE_INHERIT, BONE_ROTATE, BONE_SCALE, BONE_SCALEX,
+    BONE_SCALEY, BONE_SHEAR, BONE_SHEARX, BONE_SHEARY, BONE_TRANSLATE, BONE_TRANSLATEX,
+    BONE_TRANSLATEY, CONSTRAINT_IK, CONSTRAINT_PATH, CONSTRAINT_PHYSICS, CONSTRAINT_SLIDER,
+    CONSTRAINT_TRANSFORM, CURVE_BEZIER, CURVE_LINEAR, CURVE_STEPPED, PATH_MIX, PATH_POSITION,
+    PATH_SPACING, PHYSICS_DAMPING, PHYSICS_GRAVITY, PHYSICS_INERTIA, PHYSICS_MASS, PHYSICS_MIX,
+    PHYSICS_RESET, PHYSICS_STRENGTH, PHYSICS_WIND, SLIDER_MIX, SLIDER_TIME, SLOT_ALPHA,
+    SLOT_ATTACHMENT, SLOT_RGB, SLOT_RGB2, SLOT_RGBA, SLOT_RGBA2,
+};
+use crate::{
+    Animation, AttachmentData, BlendMode, BoneTimeline, Curve, DeformTimeline, Error, Inherit,
+    MeshVertices, PathConstraintTimeline, PhysicsConstraintTimeline, PositionMode, RotateMode,
+    SequenceDef, SequenceMode, SequenceTimeline, SkeletonData, SkinData, SpacingMode,
+    TransformProperty,
+};
+use std::collections::{BTreeMap, HashMap};
+
+#[derive(Default)]
+struct BinaryOutput {
+    bytes: Vec<u8>,
+}
+
+impl BinaryOutput {
+    fn write_u8(&mut self, v: u8) {
+        self.bytes.push(v);
+    }
+
+    fn write_i8(&mut self, v: i8) {
+        self.bytes.push(v as u8);
+    }
+
+    fn write_bool(&mut self, v: bool) {
+        self.bytes.push(v as u8);
+    }
+
+    fn write_i32_be(&mut self, v: i32) {
+        self.bytes.extend_from_slice(&v.to_be_bytes());
+    }
+
+    fn write_f32_be(&mut self, v: f32) {
+        self.bytes.extend_from_slice(&v.to_be_bytes());
+    }
+
+    /// Inverse of `BinaryInput::read_varint`: negative values with `optimize_positive` take the
+    /// full 5 bytes (the reader reinterprets the 32 bits).
+    fn write_varint(&mut self, value: i32, optimize_positive: bool) {
+        let mut v = if optimize_positive {
+            value as u32
+        } else {
+            ((value << 1) ^ (value >> 31)) as u32
+        };
+        loop {
+            let b = (v & 0x7F) as u8;
+            v >>= 7;
+            if v == 0 {
+                self.bytes.push(b);
+                break;
+            }
+            self.bytes.push(b | 0x80);
+        }
+    }
+
+    fn write_len(&mut self, n: usize) {
+        self.write_varint(n as i32, true);
+    }
+
+    fn write_string(&mut self, s: Option<&str>) {
+        match s {
+            None => self.write_len(0),
+            Some(s) => {
+                self.write_len(s.len() + 1);
+                self.bytes.extend_from_slice(s.as_bytes());
+            }
+        }
+    }
+
+    fn write_color_byte(&mut self, v: f32) {
+        self.write_u8((v.clamp(0.0, 1.0) * 255.0).round() as u8);
+    }
+
+    fn write_color_rgba(&mut self, c: [f32; 4]) {
+        for v in c {
+            self.write_color_byte(v);
+        }
+    }
+}
+
+/// Strings referenced by index (`read_string_ref`): attachment keys, names and paths, slot setup
+/// attachments and attachment timeline keys. Interned while the body is written; the table is
+/// emitted ahead of the body afterwards.
+#[derive(Default)]
+struct StringTable {
+    strings: Vec<String>,
+    index: HashMap<String, usize>,
+}
+
+impl StringTable {
+    fn write_ref(&mut self, out: &mut BinaryOutput, s: Option<&str>) {
+        let Some(s) = s else {
+            out.write_len(0);
+            return;
+        };
+        let next = self.strings.len();
+        let i = *self.index.entry(s.to_string()).or_insert_with(|| {
+            self.strings.push(s.to_string());
+            next
+        });
+        out.write_len(i + 1);
+    }
+}
+
+#[derive(Copy, Clone, Debug)]
+enum ConstraintRef {
+    Ik(usize),
+    Transform(usize),
+    Path(usize),
+    Physics(usize),
+    Slider(usize),
+}
+
+/// Index maps shared by the skin and animation sections.
+struct Indices<'a> {
+    constraints: Vec<ConstraintRef>,
+    ik: Vec<usize>,
+    transform: Vec<usize>,
+    path: Vec<usize>,
+    physics: Vec<usize>,
+    slider: Vec<usize>,
+    /// Binary skin order: `default` first (when it has attachments), then named skins by name.
+    skins: Vec<&'a SkinData>,
+    skin_index: HashMap<&'a str, usize>,
+    events: Vec<&'a crate::EventData>,
+    event_index: HashMap<&'a str, usize>,
+}
+
+impl<'a> Indices<'a> {
+    fn new(data: &'a SkeletonData) -> Self {
+        // Same tie-break as the runtime's update cache: stable sort by `order` over the per-kind
+        // lists in ik, transform, path, physics, slider order.
+        let mut ordered = Vec::new();
+        ordered.extend(
+            (data.ik_constraints.iter().enumerate()).map(|(i, c)| (c.order, ConstraintRef::Ik(i))),
+        );
+        ordered.extend(
+            (data.transform_constraints.iter().enumerate())
+                .map(|(i, c)| (c.order, ConstraintRef::Transform(i))),
+        );
+        ordered.extend(
+            (data.path_constraints.iter().enumerate())
+                .map(|(i, c)| (c.order, ConstraintRef::Path(i))),
+        );
+        ordered.extend(
+            (data.physics_constraints.iter().enumerate())
+                .map(|(i, c)| (c.order, ConstraintRef::Physics(i))),
+        );
+        ordered.extend(
+            (data.slider_constraints.iter().enumerate())
+                .map(|(i, c)| (c.order, ConstraintRef::Slider(i))),
+        );
+        ordered.sort_by_key(|(order, _)| *order);
+        let constraints: Vec<ConstraintRef> = ordered.into_iter().map(|(_, c)| c).collect();
+
+        let mut ik = vec![0; data.ik_constraints.len()];
+        let mut transform = vec![0; data.transform_constraints.len()];
+        let mut path = vec![0; data.path_constraints.len()];
+        let mut physics = vec![0; data.physics_constraints.len()];
+        let mut slider = vec![0; data.slider_constraints.len()];
+        for (combined, c) in constraints.iter().enumerate() {
+            match *c {
+                ConstraintRef::Ik(i) => ik[i] = combined,
+                ConstraintRef::Transform(i) => transform[i] = combined,
+                ConstraintRef::Path(i) => path[i] = combined,
+                ConstraintRef::Physics(i) => physics[i] = combined,
+                ConstraintRef::Slider(i) => slider[i] = combined,
+            }
+        }
+
+        let mut skins: Vec<&SkinData> = Vec::new();
+        if let Some(default) = data.skins.get("default") {
+            if default.attachments.iter().any(|m| !m.is_empty()) {
+                skins.push(default);
+            }
+        }
+        let mut named: Vec<&SkinData> = data
+            .skins
+            .values()
+            .filter(|s| s.name != "default")
+            .collect();
+        named.sort_by(|a, b| a.name.cmp(&b.name));
+        skins.extend(named);
+        let skin_index = skins
+            .iter()
+            .enumerate()
+            .map(|(i, s)| (s.name.as_str(), i))
+            .collect();
+
+        let mut events: Vec<&crate::EventData> = data.events.values().collect();
+        events.sort_by(|a, b| a.name.cmp(&b.name));
+        let event_index = events
+            .iter()
+            .enumerate()
+            .map(|(i, e)| (e.name.as_str(), i))
+            .collect();
+
+        Self {
+            constraints,
+            ik,
+            transform,
+            path,
+            physics,
+            slider,
+            skins,
+            skin_index,
+            events,
+            event_index,
+        }
+    }
+}
+
+fn invalid(message: String) -> Error {
+    Error::InvalidValue { message }
+}
+
+fn inherit_byte(inherit: Inherit) -> u8 {
+    match inherit {
+        Inherit::Normal => 0,
+        Inherit::OnlyTranslation => 1,
+        Inherit::NoRotationOrReflection => 2,
+        Inherit::NoScale => 3,
+        Inherit::NoScaleOrReflection => 4,
+    }
+}
+
+fn blend_index(blend: BlendMode) -> i32 {
+    match blend {
+        BlendMode::Normal => 0,
+        BlendMode::Additive => 1,
+        BlendMode::Multiply => 2,
+        BlendMode::Screen => 3,
+    }
+}
+
+fn property_kind(property: TransformProperty) -> u8 {
+    property.index() as u8
+}
+
+fn sequence_mode_index(mode: SequenceMode) -> i32 {
+    match mode {
+        SequenceMode::Hold => 0,
+        SequenceMode::Once => 1,
+        SequenceMode::Loop => 2,
+        SequenceMode::PingPong => 3,
+        SequenceMode::OnceReverse => 4,
+        SequenceMode::LoopReverse => 5,
+        SequenceMode::PingPongReverse => 6,
+    }
+}
+
+/// One key of a curve timeline: its time, channel values and the curves to the next key.
+struct Key<'a> {
+    time: f32,
+    values: Vec<f32>,
+    curves: &'a [Curve],
+}
+
+/// Curve of one key -> next key segment. The binary format stores one curve type per key for all
+/// channels, so a Bezier key writes every channel as Bezier (linear channels as their equivalent
+/// straight-line Bezier).
+enum SharedCurve {
+    Linear,
+    Stepped,
+    Bezier(Vec<[f32; 4]>),
+}
+
+impl SharedCurve {
+    fn between(key: &Key<'_>, next: &Key<'_>) -> Result<Self, Error> {
+        if key.curves.iter().all(|c| matches!(c, Curve::Linear)) {
+            return Ok(Self::Linear);
+        }
+        if key.curves.iter().all(|c| matches!(c, Curve::Stepped)) {
+            return Ok(Self::Stepped);
+        }
+        let (t1, t2) = (key.time, next.time);
+        let mut out = Vec::with_capacity(key.curves.len());
+        for (ch, curve) in key.curves.iter().enumerate() {
+            out.push(match *curve {
+                Curve::Bezier { cx1, cy1, cx2, cy2 } => [cx1, cy1, cx2, cy2],
+                Curve::Linear => {
+                    let (v1, v2) = (key.values[ch], next.values[ch]);
+                    [
+                        t1 + (t2 - t1) / 3.0,
+                        v1 + (v2 - v1) / 3.0,
+                        t1 + (t2 - t1) * 2.0 / 3.0,
+                        v1 + (v2 - v1) * 2.0 / 3.0,
+                    ]
+                }
+                Curve::Stepped => {
+                    return Err(invalid(format!(
+                        "key at time {t1} mixes stepped and Bezier channels"
+                    )));
+                }
+            });
+        }
+        Ok(Self::Bezier(out))
+    }
+
+    fn bezier_count(&self) -> usize {
+        match self {
+            Self::Bezier(b) => b.len(),
+            _ => 0,
+        }
+    }
+
+    fn write(&self, out: &mut BinaryOutput) {
+        match self {
+            Self::Linear => out.write_i8(CURVE_LINEAR),
+            Self::Stepped => out.write_i8(CURVE_STEPPED),
+            Self::Bezier(beziers) => {
+                out.write_i8(CURVE_BEZIER);
+                write_beziers(out, beziers);
+            }
+        }
+    }
+}
+
+fn write_beziers(out: &mut BinaryOutput, beziers: &[[f32; 4]]) {
+    for b in beziers {
+        for v in b {
+            out.write_f32_be(*v);
+        }
+    }
+}
+
+fn segment_curves(keys: &[Key<'_>]) -> Result<Vec<SharedCurve>, Error> {
+    keys.windows(2)
+        .map(|w| SharedCurve::between(&w[0], &w[1]))
+        .collect()
+}
+
+fn write_f32_values(out: &mut BinaryOutput, values: &[f32]) {
+    for v in values {
+        out.write_f32_be(*v);
+    }
+}
+
+fn write_color_values(out: &mut BinaryOutput, values: &[f32]) {
+    for v in values {
+        out.write_color_byte(*v);
+    }
+}
+
+/// Frame count, Bezier count, then `time, values` for the first key and
+/// `time, values, curve` for every following key (the curve belonging to the previous key).
+fn write_curve_timeline(
+    out: &mut BinaryOutput,
+    keys: &[Key<'_>],
+    write_values: fn(&mut BinaryOutput, &[f32]),
+) -> Result<(), Error> {
+    let curves = segment_curves(keys)?;
+    out.write_len(keys.len());
+    out.write_len(curves.iter().map(SharedCurve::bezier_count).sum());
+    out.write_f32_be(keys[0].time);
+    write_values(out, &keys[0].values);
+    for (key, curve) in keys[1..].iter().zip(&curves) {
+        out.write_f32_be(key.time);
+        write_values(out, &key.values);
+        curve.write(out);
+    }
+    Ok(())
+}
+
+fn float_keys(frames: &[crate::FloatFrame]) -> Vec<Key<'_>> {
+    frames
+        .iter()
+        .map(|f| Key {
+            time: f.time,
+            values: vec![f.value],
+            curves: std::slice::from_ref(&f.curve),
+        })
+        .collect()
+}
+
+fn vec2_keys(frames: &[crate::Vec2Frame]) -> Vec<Key<'_>> {
+    frames
+        .iter()
+        .map(|f| Key {
+            time: f.time,
+            values: vec![f.x, f.y],
+            curves: &f.curve,
+        })
+        .collect()
+}
+
+fn write_vertices(out: &mut BinaryOutput, vertices: &MeshVertices) -> usize {
+    match vertices {
+        MeshVertices::Unweighted(v) => {
+            out.write_len(v.len());
+            for [x, y] in v {
+                out.write_f32_be(*x);
+                out.write_f32_be(*y);
+            }
+            v.len()
+        }
+        MeshVertices::Weighted(v) => {
+            out.write_len(v.len());
+            for weights in v {
+                out.write_len(weights.len());
+                for w in weights {
+                    out.write_len(w.bone);
+                    out.write_f32_be(w.x);
+                    out.write_f32_be(w.y);
+                    out.write_f32_be(w.weight);
+                }
+            }
+            v.len()
+        }
+    }
+}
+
+fn write_sequence(out: &mut BinaryOutput, sequence: &SequenceDef) {
+    out.write_len(sequence.count);
+    out.write_varint(sequence.start, true);
+    out.write_len(sequence.digits);
+    out.write_varint(sequence.setup_index, true);
+}
+
+struct Writer<'a> {
+    data: &'a SkeletonData,
+    indices: Indices<'a>,
+    out: BinaryOutput,
+    strings: StringTable,
+}
+
+impl crate::SkeletonData {
+    /// Serializes this skeleton as a Spine 4.3 `.skel` that [`SkeletonData::from_skel_bytes`] and
+    /// the official runtimes load back to the same setup pose and animations.
+    ///
+    /// Skins after `default` and event definitions are written in name order; constraints keep
+    /// their update order.
+    pub fn to_skel_bytes(&self) -> Result<Vec<u8>, Error> {
+        let mut w = Writer {
+            data: self,
+            indices: Indices::new(self),
+            out: BinaryOutput::default(),
+            strings: StringTable::default(),
+        };
+        w.write_bones();
+        w.write_slots();
+        w.write_constraints()?;
+        w.write_skins()?;
+        w.write_events();
+        w.out.write_len(self.animations.len());
+        for animation in &self.animations {
+            w.write_animation(animation)?;
+        }
+        for c in &w.indices.constraints {
+            if let ConstraintRef::Slider(i) = *c {
+                let slider = &self.slider_constraints[i];
+                let animation = slider.animation.ok_or_else(|| {
+                    invalid(format!(
+                        "slider constraint '{}' has no animation",
+                        slider.name
+                    ))
+                })?;
+                w.out.write_len(animation);
+            }
+        }
+
+        let mut head = BinaryOutput::default();
+        // Hash (unused by the runtimes).
+        head.write_i32_be(0);
+        head.write_i32_be(0);
+        head.write_string(Some(self.spine_version.as_deref().unwrap_or("4.3")));
+        // x, y, width, height
+        for _ in 0..4 {
+            head.write_f32_be(0.0);
+        }
+        head.write_f32_be(self.reference_scale);
+        head.write_bool(false); // nonessential
+        head.write_len(w.strings.strings.len());
+        for s in &w.strings.strings {
+            head.write_string(Some(s));
+        }
+        head.bytes.extend_from_slice(&w.out.bytes);
+        Ok(head.bytes)
+    }
+}
+
+impl<'a> Writer<'a> {
+    fn write_bones(&mut self) {
+        let out = &mut self.out;
+        out.write_len(self.data.bones.len());
+        for (i, bone) in self.data.bones.iter().enumerate() {
+            out.write_string(Some(&bone.name));
+            if i != 0 {
+                out.write_len(bone.parent.unwrap_or(0));
+            }
+            out.write_f32_be(bone.rotation);
+            out.write_f32_be(bone.x);
+            out.write_f32_be(bone.y);
+            out.write_f32_be(bone.scale_x);
+            out.write_f32_be(bone.scale_y);
+            out.write_f32_be(bone.shear_x);
+            out.write_f32_be(bone.shear_y);
+            out.write_u8(inherit_byte(bone.inherit));
+            out.write_f32_be(bone.length);
+            out.write_bool(bone.skin_required);
+        }
+    }
+
+    fn write_slots(&mut self) {
+        self.out.write_len(self.data.slots.len());
+        for slot in &self.data.slots {
+            self.out.write_string(Some(&slot.name));
+            self.out.write_len(slot.bone);
+            self.out.write_color_rgba(slot.color);
+            // Dark color as a, r, g, b; all 0xff means "no dark color", so a real one uses a = 0.
+            if slot.has_dark {
+                self.out.write_u8(0);
+                for v in slot.dark_color {
+                    self.out.write_color_byte(v);
+                }
+            } else {
+                self.out.write_i32_be(-1);
+            }
+            self.strings
+                .write_ref(&mut self.out, slot.attachment.as_deref());
+            self.out.write_varint(blend_index(slot.blend), true);
+        }
+    }
+
+    fn write_constraints(&mut self) -> Result<(), Error> {
+        let data = self.data;
+        let out = &mut self.out;
+        out.write_len(self.indices.constraints.len());
+        for c in &self.indices.constraints {
+            match *c {
+                ConstraintRef::Ik(i) => {
+                    let ik = &data.ik_constraints[i];
+                    out.write_string(Some(&ik.name));
+                    out.write_u8(CONSTRAINT_IK);
+                    out.write_len(ik.bones.len());
+                    for b in &ik.bones {
+                        out.write_len(*b);
+                    }
+                    out.write_len(ik.target);
+                    let mut flags = 0u8;
+                    flags |= ik.skin_required as u8;
+                    flags |= (ik.uniform as u8) << 1;
+                    flags |= ((ik.bend_direction < 0) as u8) << 2;
+                    flags |= (ik.compress as u8) << 3;
+                    flags |= (ik.stretch as u8) << 4;
+                    flags |= ((ik.mix != 0.0) as u8) << 5;
+                    flags |= ((ik.mix != 0.0 && ik.mix != 1.0) as u8) << 6;
+                    flags |= ((ik.softness != 0.0) as u8) << 7;
+                    out.write_u8(flags);
+                    if (flags & 64) != 0 {
+                        out.write_f32_be(ik.mix);
+                    }
+                    if (flags & 128) != 0 {
+                        out.write_f32_be(ik.softness);
+                    }
+                }
+                ConstraintRef::Transform(i) => {
+                    let t = &data.transform_constraints[i];
+                    if t.properties.len() > 7 {
+                        return Err(invalid(format!(
+                            "transform constraint '{}' has {} properties (max 7)",
+                            t.name,
+                            t.properties.len()
+                        )));
+                    }
+                    out.write_string(Some(&t.name));
+                    out.write_u8(CONSTRAINT_TRANSFORM);
+                    out.write_len(t.bones.len());
+                    for b in &t.bones {
+                        out.write_len(*b);
+                    }
+                    out.write_len(t.source);
+                    let mut flags = t.skin_required as u8;
+                    flags |= (t.local_source as u8) << 1;
+                    flags |= (t.local_target as u8) << 2;
+                    flags |= (t.additive as u8) << 3;
+                    flags |= (t.clamp as u8) << 4;
+                    flags |= (t.properties.len() as u8) << 5;
+                    out.write_u8(flags);
+                    for from in &t.properties {
+                        out.write_u8(property_kind(from.property));
+                        out.write_f32_be(from.offset);
+                        out.write_u8(from.to.len() as u8);
+                        for to in &from.to {
+                            out.write_u8(property_kind(to.property));
+                            out.write_f32_be(to.offset);
+                            out.write_f32_be(to.max);
+                            out.write_f32_be(to.scale);
+                        }
+                    }
+                    for values in [
+                        t.offsets,
+                        [
+                            t.mix_rotate,
+                            t.mix_x,
+                            t.mix_y,
+                            t.mix_scale_x,
+                            t.mix_scale_y,
+                            t.mix_shear_y,
+                        ],
+                    ] {
+                        let mut flags = 0u8;
+                        for (bit, v) in values.iter().enumerate() {
+                            flags |= ((*v != 0.0) as u8) << bit;
+                        }
+                        out.write_u8(flags);
+                        for v in values.iter().filter(|v| **v != 0.0) {
+                            out.write_f32_be(*v);
+                        }
+                    }
+                }
+                ConstraintRef::Path(i) => {
+                    let p = &data.path_constraints[i];
+                    out.write_string(Some(&p.name));
+                    out.write_u8(CONSTRAINT_PATH);
+                    out.write_len(p.bones.len());
+                    for b in &p.bones {
+                        out.write_len(*b);
+                    }
+                    out.write_len(p.target);
+                    let spacing = match p.spacing_mode {
+                        SpacingMode::Length => 0u8,
+                        SpacingMode::Fixed => 1,
+                        SpacingMode::Percent => 2,
+                        SpacingMode::Proportional => 3,
+                    };
+                    let rotate = match p.rotate_mode {
+                        RotateMode::Tangent => 0u8,
+                        RotateMode::Chain => 1,
+                        RotateMode::ChainScale => 2,
+                    };
+                    // Editor layout. spine-cpp (and `binary.rs`) decode the position mode from
+                    // bit 2, which is also the low spacing bit, so only some pairs survive.
+                    if !position_mode_survives_skel(p) {
+                        return Err(invalid(format!(
+                            "path constraint '{}' has position mode {:?} with spacing mode {:?}, which .skel cannot encode",
+                            p.name, p.position_mode, p.spacing_mode
+                        )));
+                    }
+                    let mut flags = p.skin_required as u8;
+                    flags |= ((p.position_mode == PositionMode::Percent) as u8) << 1;
+                    flags |= spacing << 2;
+                    flags |= rotate << 4;
+                    flags |= ((p.offset_rotation != 0.0) as u8) << 7;
+                    out.write_u8(flags);
+                    if p.offset_rotation != 0.0 {
+                        out.write_f32_be(p.offset_rotation);
+                    }
+                    out.write_f32_be(p.position);
+                    out.write_f32_be(p.spacing);
+                    out.write_f32_be(p.mix_rotate);
+                    out.write_f32_be(p.mix_x);
+                    out.write_f32_be(p.mix_y);
+                }
+                ConstraintRef::Physics(i) => {
+                    let p = &data.physics_constraints[i];
+                    out.write_string(Some(&p.name));
+                    out.write_u8(CONSTRAINT_PHYSICS);
+                    out.write_len(p.bone);
+                    let optional = [p.x, p.y, p.rotate, p.scale_x, p.shear_x];
+                    let mut flags = p.skin_required as u8;
+                    for (bit, v) in optional.iter().enumerate() {
+                        flags |= ((*v != 0.0) as u8) << (bit + 1);
+                    }
+                    flags |= ((p.limit != 5000.0) as u8) << 6;
+                    flags |= ((p.mass_inverse != 1.0) as u8) << 7;
+                    out.write_u8(flags);
+                    for v in optional.iter().filter(|v| **v != 0.0) {
+                        out.write_f32_be(*v);
+                    }
+                    if p.limit != 5000.0 {
+                        out.write_f32_be(p.limit);
+                    }
+                    let fps = if p.step > 0.0 {
+                        (1.0 / p.step).round().clamp(1.0, 255.0)
+                    } else {
+                        1.0
+                    };
+                    out.write_u8(fps as u8);
+                    out.write_f32_be(p.inertia);
+                    out.write_f32_be(p.strength);
+                    out.write_f32_be(p.damping);
+                    if p.mass_inverse != 1.0 {
+                        out.write_f32_be(p.mass_inverse);
+                    }
+                    out.write_f32_be(p.wind);
+                    out.write_f32_be(p.gravity);
+                    let mut flags = p.inertia_global as u8;
+                    flags |= (p.strength_global as u8) << 1;
+                    flags |= (p.damping_global as u8) << 2;
+                    flags |= (p.mass_global as u8) << 3;
+                    flags |= (p.wind_global as u8) << 4;
+                    flags |= (p.gravity_global as u8) << 5;
+                    flags |= (p.mix_global as u8) << 6;
+                    flags |= ((p.mix != 1.0) as u8) << 7;
+                    out.write_u8(flags);
+                    if p.mix != 1.0 {
+                        out.write_f32_be(p.mix);
+                    }
+                }
+                ConstraintRef::Slider(i) => {
+                    let s = &data.slider_constraints[i];
+                    out.write_string(Some(&s.name));
+                    out.write_u8(CONSTRAINT_SLIDER);
+                    let mut flags = s.skin_required as u8;
+                    flags |= (s.looped as u8) << 1;
+                    flags |= (s.additive as u8) << 2;
+                    flags |= ((s.setup_time != 0.0) as u8) << 3;
+                    if s.setup_mix != 1.0 {
+                        flags |= 16 | 32;
+                    }
+                    flags |= (s.bone.is_some() as u8) << 6;
+                    flags |= ((s.bone.is_some() && s.local) as u8) << 7;
+                    out.write_u8(flags);
+                    if s.setup_time != 0.0 {
+                        out.write_f32_be(s.setup_time);
+                    }
+                    if s.setup_mix != 1.0 {
+                        out.write_f32_be(s.setup_mix);
+                    }
+                    if let Some(bone) = s.bone {
+                        out.write_len(bone);
+                        out.write_f32_be(s.property_from);
+                        out.write_u8(s.property.map(property_kind).unwrap_or(u8::MAX));
+                        out.write_f32_be(s.to);
+                        out.write_f32_be(s.scale);
+                    }
+                }
+            }
+        }
+        Ok(())
+    }
+
+    fn write_skins(&mut self) -> Result<(), Error> {
+        let skins = self.indices.skins.clone();
+        let mut named = skins.as_slice();
+        match skins.first() {
+            Some(default) if default.name == "default" => {
+                self.write_skin_attachments(default)?;
+                named = &skins[1..];
+            }
+            _ => self.out.write_len(0),
+        }
+        self.out.write_len(named.len());
+        for skin in named {
+            self.out.write_string(Some(&skin.name));
+            self.out.write_len(skin.bones.len());
+            for b in &skin.bones {
+                self.out.write_len(*b);
+            }
+            let ind = &self.indices;
+            let constraints: Vec<usize> = (skin.ik_constraints.iter().map(|&i| ind.ik[i]))
+                .chain(skin.transform_constraints.iter().map(|&i| ind.transform[i]))
+                .chain(skin.path_constraints.iter().map(|&i| ind.path[i]))
+                .chain(skin.physics_constraints.iter().map(|&i| ind.physics[i]))
+                .chain(skin.slider_constraints.iter().map(|&i| ind.slider[i]))
+                .collect();
+            self.out.write_len(constraints.len());
+            for c in constraints {
+                self.out.write_len(c);
+            }
+            self.write_skin_attachments(skin)?;
+        }
+        Ok(())
+    }
+
+    fn write_skin_attachments(&mut self, skin: &SkinData) -> Result<(), Error> {
+        let slots: Vec<(usize, &HashMap<String, AttachmentData>)> = skin
+            .attachments
+            .iter()
+            .enumerate()
+            .filter(|(_, m)| !m.is_empty())
+            .collect();
+        self.out.write_len(slots.len());
+        for (slot_index, map) in slots {
+            self.out.write_len(slot_index);
+            self.out.write_len(map.len());
+            let mut keys: Vec<&String> = map.keys().collect();
+            keys.sort();
+            for key in keys {
+                self.strings.write_ref(&mut self.out, Some(key));
+                self.write_attachment(skin, key, &map[key])?;
+            }
+        }
+        Ok(())
+    }
+
+    /// Flags byte: type in bits 0-2, bit 3 when the name differs from the skin key, bits 4-7 per
+    /// attachment type.
+    fn write_attachment(
+        &mut self,
+        skin: &SkinData,
+        key: &str,
+        attachment: &AttachmentData,
+    ) -> Result<(), Error> {
+        let name = attachment.name();
+        let name_flag = if name != key { 8u8 } else { 0 };
+        let white = [1.0f32; 4];
+        match attachment {
+            AttachmentData::Region(r) => {
+                let mut flags = name_flag;
+                flags |= ((r.path != r.name) as u8) << 4;
+                flags |= ((r.color != white) as u8) << 5;
+                flags |= (r.sequence.is_some() as u8) << 6;
+                flags |= ((r.rotation != 0.0) as u8) << 7;
+                self.out.write_u8(flags);
+                self.write_name_and_path(name_flag != 0, name, r.path != r.name, &r.path);
+                if r.color != white {
+                    self.out.write_color_rgba(r.color);
+                }
+                if let Some(sequence) = &r.sequence {
+                    write_sequence(&mut self.out, sequence);
+                }
+                if r.rotation != 0.0 {
+                    self.out.write_f32_be(r.rotation);
+                }
+                for v in [r.x, r.y, r.scale_x, r.scale_y, r.width, r.height] {
+                    self.out.write_f32_be(v);
+                }
+            }
+            AttachmentData::BoundingBox(b) => {
+                let weighted = matches!(b.vertices, MeshVertices::Weighted(_));
+                self.out.write_u8(1 | name_flag | ((weighted as u8) << 4));
+                self.write_name_and_path(name_flag != 0, name, false, "");
+                write_vertices(&mut self.out, &b.vertices);
+            }
+            AttachmentData::Mesh(m)
+                if m.timeline_skin != skin.name || m.timeline_attachment != key =>
+            {
+                // Linked mesh inheriting timelines: the timeline attachment is its parent, whose
+                // geometry it shares.
+                let parent_skin = *self
+                    .indices
+                    .skin_index
+                    .get(m.timeline_skin.as_str())
+                    .ok_or_else(|| {
+                        invalid(format!(
+                            "linked mesh '{key}' in skin '{}' references skin '{}', which has no attachments",
+                            skin.name, m.timeline_skin
+                        ))
+                    })?;
+                let mut flags = 3 | name_flag;
+                flags |= ((m.path != m.name) as u8) << 4;
+                flags |= ((m.color != white) as u8) << 5;
+                flags |= (m.sequence.is_some() as u8) << 6;
+                flags |= 128;
+                self.out.write_u8(flags);
+                self.write_name_and_path(name_flag != 0, name, m.path != m.name, &m.path);
+                if m.color != white {
+                    self.out.write_color_rgba(m.color);
+                }
+                if let Some(sequence) = &m.sequence {
+                    write_sequence(&mut self.out, sequence);
+                }
+                self.out.write_len(parent_skin);
+                self.strings
+                    .write_ref(&mut self.out, Some(&m.timeline_attachment));
+            }
+            AttachmentData::Mesh(m) => {
+                let weighted = matches!(m.vertices, MeshVertices::Weighted(_));
+                let mut flags = 2 | name_flag;
+                flags |= ((m.path != m.name) as u8) << 4;
+                flags |= ((m.color != white) as u8) << 5;
+                flags |= (m.sequence.is_some() as u8) << 6;
+                flags |= (weighted as u8) << 7;
+                self.out.write_u8(flags);
+                self.write_name_and_path(name_flag != 0, name, m.path != m.name, &m.path);
+                if m.color != white {
+                    self.out.write_color_rgba(m.color);
+                }
+                if let Some(sequence) = &m.sequence {
+                    write_sequence(&mut self.out, sequence);
+                }
+                // The reader derives the triangle count as (2 * vertices - hull - 2) * 3.
+                let vertex_count = m.uvs.len();
+                let hull = (vertex_count * 2) as isize - 2 - (m.triangles.len() / 3) as isize;
+                if hull < 0 || m.triangles.len() % 3 != 0 {
+                    return Err(invalid(format!(
+                        "mesh '{key}' in skin '{}': {} triangle indices for {vertex_count} vertices cannot be encoded",
+                        skin.name,
+                        m.triangles.len()
+                    )));
+                }
+                self.out.write_len(hull as usize);
+                write_vertices(&mut self.out, &m.vertices);
+                for [u, v] in &m.uvs {
+                    self.out.write_f32_be(*u);
+                    self.out.write_f32_be(*v);
+                }
+                for t in &m.triangles {
+                    self.out.write_len(*t as usize);
+                }
+            }
+            AttachmentData::Path(p) => {
+                let weighted = matches!(p.vertices, MeshVertices::Weighted(_));
+                let mut flags = 4 | name_flag;
+                flags |= (p.closed as u8) << 4;
+                flags |= (p.constant_speed as u8) << 5;
+                flags |= (weighted as u8) << 6;
+                self.out.write_u8(flags);
+                self.write_name_and_path(name_flag != 0, name, false, "");
+                write_vertices(&mut self.out, &p.vertices);
+                for l in &p.lengths {
+                    self.out.write_f32_be(*l);
+                }
+            }
+            AttachmentData::Point(p) => {
+                self.out.write_u8(5 | name_flag);
+                self.write_name_and_path(name_flag != 0, name, false, "");
+                self.out.write_f32_be(p.rotation);
+                self.out.write_f32_be(p.x);
+                self.out.write_f32_be(p.y);
+            }
+            AttachmentData::Clipping(c) => {
+                let weighted = matches!(c.vertices, MeshVertices::Weighted(_));
+                self.out.write_u8(6 | name_flag | ((weighted as u8) << 4));
+                self.write_name_and_path(name_flag != 0, name, false, "");
+                let end = c
+                    .end_slot
+                    .unwrap_or(self.data.slots.len().saturating_sub(1));
+                self.out.write_len(end);
+                write_vertices(&mut self.out, &c.vertices);
+            }
+        }
+        Ok(())
+    }
+
+    fn write_name_and_path(&mut self, write_name: bool, name: &str, write_path: bool, path: &str) {
+        if write_name {
+            self.strings.write_ref(&mut self.out, Some(name));
+        }
+        if write_path {
+            self.strings.write_ref(&mut self.out, Some(path));
+        }
+    }
+
+    fn write_events(&mut self) {
+        self.out.write_len(self.indices.events.len());
+        for e in &self.indices.events {
+            self.out.write_string(Some(&e.name));
+            self.out.write_varint(e.int_value, false);
+            self.out.write_f32_be(e.float_value);
+            self.out.write_string(Some(&e.string));
+            if e.audio_path.is_empty() {
+                self.out.write_string(None);
+            } else {
+                self.out.write_string(Some(&e.audio_path));
+                self.out.write_f32_be(e.volume);
+                self.out.write_f32_be(e.balance);
+            }
+        }
+    }
+
+    fn write_animation(&mut self, a: &Animation) -> Result<(), Error> {
+        self.out.write_string(Some(&a.name));
+        let timeline_count = a.bone_timelines.len()
+            + a.deform_timelines.len()
+            + a.sequence_timelines.len()
+            + a.slot_attachment_timelines.len()
+            + a.slot_color_timelines.len()
+            + a.slot_rgb_timelines.len()
+            + a.slot_alpha_timelines.len()
+            + a.slot_rgba2_timelines.len()
+            + a.slot_rgb2_timelines.len()
+            + a.ik_constraint_timelines.len()
+            + a.transform_constraint_timelines.len()
+            + a.path_constraint_timelines.len()
+            + a.physics_constraint_timelines.len()
+            + a.physics_reset_timelines.len()
+            + a.slider_time_timelines.len()
+            + a.slider_mix_timelines.len()
+            + a.draw_order_timeline.is_some() as usize
+            + a.event_timeline.is_some() as usize;
+        self.out.write_len(timeline_count);
+
+        self.write_slot_timelines(a)?;
+        self.write_bone_timelines(a)?;
+        self.write_ik_timelines(a)?;
+        self.write_transform_timelines(a)?;
+        self.write_path_timelines(a)?;
+        self.write_physics_timelines(a)?;
+        self.write_slider_timelines(a)?;
+        self.write_attachment_timelines(a)?;
+        self.write_draw_order(a);
+        self.write_event_timeline(a)
+    }
+
+    fn write_slot_timelines(&mut self, a: &Animation) -> Result<(), Error> {
+        // Per slot: (type, frames written by the closure) in model order.
+        type SlotTimeline<'t> = (u8, Vec<Key<'t>>, Option<&'t crate::AttachmentTimeline>);
+        let mut by_slot: BTreeMap<usize, Vec<SlotTimeline<'_>>> = BTreeMap::new();
+        for t in a
+            .slot_attachment_timelines
+            .iter()
+            .filter(|t| !t.frames.is_empty())
+        {
+            by_slot
+                .entry(t.slot_index)
+                .or_default()
+                .push((SLOT_ATTACHMENT, Vec::new(), Some(t)));
+        }
+        for t in a
+            .slot_color_timelines
+            .iter()
+            .filter(|t| !t.frames.is_empty())
+        {
+            let keys = (t.frames.iter())
+                .map(|f| Key {
+                    time: f.time,
+                    values: f.color.to_vec(),
+                    curves: &f.curve,
+                })
+                .collect();
+            by_slot
+                .entry(t.slot_index)
+                .or_default()
+                .push((SLOT_RGBA, keys, None));
+        }
+        for t in a.slot_rgb_timelines.iter().filter(|t| !t.frames.is_empty()) {
+            let keys = (t.frames.iter())
+                .map(|f| Key {
+                    time: f.time,
+                    values: f.color.to_vec(),
+                    curves: &f.curve,
+                })
+                .collect();
+            by_slot
+                .entry(t.slot_index)
+                .or_default()
+                .push((SLOT_RGB, keys, None));
+        }
+        for t in a
+            .slot_rgba2_timelines
+            .iter()
+            .filter(|t| !t.frames.is_empty())
+        {
+            let keys = (t.frames.iter())
+                .map(|f| Key {
+                    time: f.time,
+                    values: f.light.iter().chain(&f.dark).copied().collect(),
+                    curves: &f.curve,
+                })
+                .collect();
+            by_slot
+                .entry(t.slot_index)
+                .or_default()
+                .push((SLOT_RGBA2, keys, None));
+        }
+        for t in a
+            .slot_rgb2_timelines
+            .iter()
+            .filter(|t| !t.frames.is_empty())
+        {
+            let keys = (t.frames.iter())
+                .map(|f| Key {
+                    time: f.time,
+                    values: f.light.iter().chain(&f.dark).copied().collect(),
+                    curves: &f.curve,
+                })
+                .collect();
+            by_slot
+                .entry(t.slot_index)
+                .or_default()
+                .push((SLOT_RGB2, keys, None));
+        }
+        for t in a
+            .slot_alpha_timelines
+            .iter()
+            .filter(|t| !t.frames.is_empty())
+        {
+            let keys = (t.frames.iter())
+                .map(|f| Key {
+                    time: f.time,
+                    values: vec![f.alpha],
+                    curves: std::slice::from_ref(&f.curve),
+                })
+                .collect();
+            by_slot
+                .entry(t.slot_index)
+                .or_default()
+                .push((SLOT_ALPHA, keys, None));
+        }
+
+        self.out.write_len(by_slot.len());
+        for (slot_index, timelines) in by_slot {
+            self.out.write_len(slot_index);
+            self.out.write_len(timelines.len());
+            for (ty, keys, attachment) in timelines {
+                self.out.write_u8(ty);
+                if let Some(t) = attachment {
+                    self.out.write_len(t.frames.len());
+                    for f in &t.frames {
+                        self.out.write_f32_be(f.time);
+                        self.strings.write_ref(&mut self.out, f.name.as_deref());
+                    }
+                } else {
+                    write_curve_timeline(&mut self.out, &keys, write_color_values)?;
+                }
+            }
+        }
+        Ok(())
+    }
+
+    fn write_bone_timelines(&mut self, a: &Animation) -> Result<(), Error> {
+        let mut by_bone: BTreeMap<usize, Vec<&BoneTimeline>> = BTreeMap::new();
+        for t in &a.bone_timelines {
+            let (bone, empty) = match t {
+                BoneTimeline::Rotate(t) => (t.bone_index, t.frames.is_empty()),
+                BoneTimeline::Translate(t) => (t.bone_index, t.frames.is_empty()),
+                BoneTimeline::TranslateX(t) => (t.bone_index, t.frames.is_empty()),
+                BoneTimeline::TranslateY(t) => (t.bone_index, t.frames.is_empty()),
+                BoneTimeline::Scale(t) => (t.bone_index, t.frames.is_empty()),
+                BoneTimeline::ScaleX(t) => (t.bone_index, t.frames.is_empty()),
+                BoneTimeline::ScaleY(t) => (t.bone_index, t.frames.is_empty()),
+                BoneTimeline::Shear(t) => (t.bone_index, t.frames.is_empty()),
+                BoneTimeline::ShearX(t) => (t.bone_index, t.frames.is_empty()),
+                BoneTimeline::ShearY(t) => (t.bone_index, t.frames.is_empty()),
+                BoneTimeline::Inherit(t) => (t.bone_index, t.frames.is_empty()),
+            };
+            if !empty {
+                by_bone.entry(bone).or_default().push(t);
+            }
+        }
+
+        self.out.write_len(by_bone.len());
+        for (bone_index, timelines) in by_bone {
+            self.out.write_len(bone_index);
+            self.out.write_len(timelines.len());
+            for t in timelines {
+                let (ty, keys) = match t {
+                    BoneTimeline::Inherit(t) => {
+                        self.out.write_u8(BONE_INHERIT);
+                        self.out.write_len(t.frames.len());
+                        for f in &t.frames {
+                            self.out.write_f32_be(f.time);
+                            self.out.write_u8(inherit_byte(f.inherit));
+                        }
+                        continue;
+                    }
+                    BoneTimeline::Rotate(t) => (
+                        BONE_ROTATE,
+                        (t.frames.iter())
+                            .map(|f| Key {
+                                time: f.time,
+                                values: vec![f.angle],
+                                curves: std::slice::from_ref(&f.curve),
+                            })
+                            .collect(),
+                    ),
+                    BoneTimeline::Translate(t) => (BONE_TRANSLATE, vec2_keys(&t.frames)),
+                    BoneTimeline::TranslateX(t) => (BONE_TRANSLATEX, float_keys(&t.frames)),
+                    BoneTimeline::TranslateY(t) => (BONE_TRANSLATEY, float_keys(&t.frames)),
+                    BoneTimeline::Scale(t) => (BONE_SCALE, vec2_keys(&t.frames)),
+                    BoneTimeline::ScaleX(t) => (BONE_SCALEX, float_keys(&t.frames)),
+                    BoneTimeline::ScaleY(t) => (BONE_SCALEY, float_keys(&t.frames)),
+                    BoneTimeline::Shear(t) => (BONE_SHEAR, vec2_keys(&t.frames)),
+                    BoneTimeline::ShearX(t) => (BONE_SHEARX, float_keys(&t.frames)),
+                    BoneTimeline::ShearY(t) => (BONE_SHEARY, float_keys(&t.frames)),
+                };
+                self.out.write_u8(ty);
+                write_curve_timeline(&mut self.out, &keys, write_f32_values)?;
+            }
+        }
+        Ok(())
+    }
+
+    fn write_ik_timelines(&mut self, a: &Animation) -> Result<(), Error> {
+        let timelines: Vec<_> = (a.ik_constraint_timelines.iter())
+            .filter(|t| !t.frames.is_empty())
+            .collect();
+        self.out.write_len(timelines.len());
+        for t in timelines {
+            let keys: Vec<Key<'_>> = (t.frames.iter())
+                .map(|f| Key {
+                    time: f.time,
+                    values: vec![f.mix, f.softness],
+                    curves: &f.curve,
+                })
+                .collect();
+            let curves = segment_curves(&keys)?;
+            self.out.write_len(self.indices.ik[t.constraint_index]);
+            self.out.write_len(t.frames.len());
+            self.out
+                .write_len(curves.iter().map(SharedCurve::bezier_count).sum());
+            // Each key's flags also carry the curve of the segment ending at it (64 stepped,
+            // 128 Bezier).
+            for (k, f) in t.frames.iter().enumerate() {
+                let mut flags = (f.mix != 0.0) as u8;
+                flags |= ((f.mix != 0.0 && f.mix != 1.0) as u8) << 1;
+                flags |= ((f.softness != 0.0) as u8) << 2;
+                flags |= ((f.bend_direction > 0) as u8) << 3;
+                flags |= (f.compress as u8) << 4;
+                flags |= (f.stretch as u8) << 5;
+                let incoming = if k == 0 { None } else { Some(&curves[k - 1]) };
+                match incoming {
+                    Some(SharedCurve::Stepped) => flags |= 64,
+                    Some(SharedCurve::Bezier(_)) => flags |= 128,
+                    _ => {}
+                }
+                self.out.write_u8(flags);
+                self.out.write_f32_be(f.time);
+                if (flags & 2) != 0 {
+                    self.out.write_f32_be(f.mix);
+                }
+                if (flags & 4) != 0 {
+                    self.out.write_f32_be(f.softness);
+                }
+                if let Some(SharedCurve::Bezier(beziers)) = incoming {
+                    write_beziers(&mut self.out, beziers);
+                }
+            }
+        }
+        Ok(())
+    }
+
+    fn write_transform_timelines(&mut self, a: &Animation) -> Result<(), Error> {
+        let timelines: Vec<_> = (a.transform_constraint_timelines.iter())
+            .filter(|t| !t.frames.is_empty())
+            .collect();
+        self.out.write_len(timelines.len());
+        for t in timelines {
+            let keys: Vec<Key<'_>> = (t.frames.iter())
+                .map(|f| Key {
+                    time: f.time,
+                    values: vec![
+                        f.mix_rotate,
+                        f.mix_x,
+                        f.mix_y,
+                        f.mix_scale_x,
+                        f.mix_scale_y,
+                        f.mix_shear_y,
+                    ],
+                    curves: &f.curve,
+                })
+                .collect();
+            self.out
+                .write_len(self.indices.transform[t.constraint_index]);
+            write_curve_timeline(&mut self.out, &keys, write_f32_values)?;
+        }
+        Ok(())
+    }
+
+    fn write_path_timelines(&mut self, a: &Animation) -> Result<(), Error> {
+        let mut by_constraint: BTreeMap<usize, Vec<(u8, Vec<Key<'_>>)>> = BTreeMap::new();
+        for t in &a.path_constraint_timelines {
+            let (index, ty, keys) = match t {
+                PathConstraintTimeline::Position(t) => {
+                    (t.constraint_index, PATH_POSITION, float_keys(&t.frames))
+                }
+                PathConstraintTimeline::Spacing(t) => {
+                    (t.constraint_index, PATH_SPACING, float_keys(&t.frames))
+                }
+                PathConstraintTimeline::Mix(t) => (
+                    t.constraint_index,
+                    PATH_MIX,
+                    (t.frames.iter())
+                        .map(|f| Key {
+                            time: f.time,
+                            values: vec![f.mix_rotate, f.mix_x, f.mix_y],
+                            curves: &f.curve,
+                        })
+                        .collect(),
+                ),
+            };
+            if !keys.is_empty() {
+                by_constraint.entry(index).or_default().push((ty, keys));
+            }
+        }
+        self.out.write_len(by_constraint.len());
+        for (index, timelines) in by_constraint {
+            self.out.write_len(self.indices.path[index]);
+            self.out.write_len(timelines.len());
+            for (ty, keys) in timelines {
+                self.out.write_u8(ty);
+                write_curve_timeline(&mut self.out, &keys, write_f32_values)?;
+            }
+        }
+        Ok(())
+    }
+
+    fn write_physics_timelines(&mut self, a: &Animation) -> Result<(), Error> {
+        // Keyed by constraint index, -1 (all constraints) first.
+        type Timeline<'t> = (u8, Vec<Key<'t>>, Option<&'t [f32]>);
+        let mut by_constraint: BTreeMap<i32, Vec<Timeline<'_>>> = BTreeMap::new();
+        for t in &a.physics_reset_timelines {
+            if !t.frames.is_empty() {
+                by_constraint.entry(t.constraint_index).or_default().push((
+                    PHYSICS_RESET,
+                    Vec::new(),
+                    Some(&t.frames),
+                ));
+            }
+        }
+        for t in &a.physics_constraint_timelines {
+            let (ty, t) = match t {
+                PhysicsConstraintTimeline::Inertia(t) => (PHYSICS_INERTIA, t),
+                PhysicsConstraintTimeline::Strength(t) => (PHYSICS_STRENGTH, t),
+                PhysicsConstraintTimeline::Damping(t) => (PHYSICS_DAMPING, t),
+                PhysicsConstraintTimeline::Mass(t) => (PHYSICS_MASS, t),
+                PhysicsConstraintTimeline::Wind(t) => (PHYSICS_WIND, t),
+                PhysicsConstraintTimeline::Gravity(t) => (PHYSICS_GRAVITY, t),
+                PhysicsConstraintTimeline::Mix(t) => (PHYSICS_MIX, t),
+            };
+            if !t.frames.is_empty() {
+                by_constraint.entry(t.constraint_index).or_default().push((
+                    ty,
+                    float_keys(&t.frames),
+                    None,
+                ));
+            }
+        }
+        self.out.write_len(by_constraint.len());
+        for (index, timelines) in by_constraint {
+            let combined = if index < 0 {
+                0
+            } else {
+                self.indices.physics[index as usize] + 1
+            };
+            self.out.write_len(combined);
+            self.out.write_len(timelines.len());
+            for (ty, keys, reset) in timelines {
+                self.out.write_u8(ty);
+                if let Some(times) = reset {
+                    self.out.write_len(times.len());
+                    for time in times {
+                        self.out.write_f32_be(*time);
+                    }
+                } else {
+                    write_curve_timeline(&mut self.out, &keys, write_f32_values)?;
+                }
+            }
+        }
+        Ok(())
+    }
+
+    fn write_slider_timelines(&mut self, a: &Animation) -> Result<(), Error> {
+        let mut by_constraint: BTreeMap<usize, Vec<(u8, Vec<Key<'_>>)>> = BTreeMap::new();
+        for (ty, timelines) in [
+            (SLIDER_TIME, &a.slider_time_timelines),
+            (SLIDER_MIX, &a.slider_mix_timelines),
+        ] {
+            for t in timelines.iter().filter(|t| !t.frames.is_empty()) {
+                by_constraint
+                    .entry(t.constraint_index)
+                    .or_default()
+                    .push((ty, float_keys(&t.frames)));
+            }
+        }
+        self.out.write_len(by_constraint.len());
+        for (index, timelines) in by_constraint {
+            self.out.write_len(self.indices.slider[index]);
+            self.out.write_len(timelines.len());
+            for (ty, keys) in timelines {
+                self.out.write_u8(ty);
+                write_curve_timeline(&mut self.out, &keys, write_f32_values)?;
+            }
+        }
+        Ok(())
+    }
+
+    fn write_attachment_timelines(&mut self, a: &Animation) -> Result<(), Error> {
+        enum Entry<'t> {
+            Deform(&'t DeformTimeline),
+            Sequence(&'t SequenceTimeline),
+        }
+        type BySlot<'t> = BTreeMap<usize, Vec<(&'t str, Entry<'t>)>>;
+        let mut by_skin: BTreeMap<usize, BySlot<'_>> = BTreeMap::new();
+        let skin_slot = |skin: &str, slot: usize| -> Result<_, Error> {
+            let index = *self.indices.skin_index.get(skin).ok_or_else(|| {
+                invalid(format!(
+                    "animation '{}' keys an attachment in skin '{skin}', which has no attachments",
+                    a.name
+                ))
+            })?;
+            Ok((index, slot))
+        };
+        let mut entries = Vec::new();
+        for t in a.deform_timelines.iter().filter(|t| !t.frames.is_empty()) {
+            entries.push((
+                skin_slot(&t.skin, t.slot_index)?,
+                t.attachment.as_str(),
+                Entry::Deform(t),
+            ));
+        }
+        for t in a.sequence_timelines.iter().filter(|t| !t.frames.is_empty()) {
+            entries.push((
+                skin_slot(&t.skin, t.slot_index)?,
+                t.attachment.as_str(),
+                Entry::Sequence(t),
+            ));
+        }
+        for ((skin, slot), key, entry) in entries {
+            by_skin
+                .entry(skin)
+                .or_default()
+                .entry(slot)
+                .or_default()
+                .push((key, entry));
+        }
+
+        self.out.write_len(by_skin.len());
+        for (skin, slots) in by_skin {
+            self.out.write_len(skin);
+            self.out.write_len(slots.len());
+            for (slot, timelines) in slots {
+                self.out.write_len(slot);
+                self.out.write_len(timelines.len());
+                for (key, entry) in timelines {
+                    self.strings.write_ref(&mut self.out, Some(key));
+                    match entry {
+                        Entry::Deform(t) => self.write_deform(t)?,
+                        Entry::Sequence(t) => {
+                            self.out.write_u8(ATTACHMENT_SEQUENCE);
+                            self.out.write_len(t.frames.len());
+                            for f in &t.frames {
+                                self.out.write_f32_be(f.time);
+                                self.out
+                                    .write_i32_be((f.index << 4) | sequence_mode_index(f.mode));
+                                self.out.write_f32_be(f.delay);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        Ok(())
+    }
+
+    /// Keys store absolute vertices; the format stores the nonzero span of the offsets from the
+    /// setup vertices (unweighted) or the raw offsets (weighted).
+    fn write_deform(&mut self, t: &DeformTimeline) -> Result<(), Error> {
+        let keys: Vec<Key<'_>> = (t.frames.iter())
+            .map(|f| Key {
+                time: f.time,
+                values: vec![0.0, 1.0],
+                curves: std::slice::from_ref(&f.curve),
+            })
+            .collect();
+        let curves = segment_curves(&keys)?;
+        self.out.write_u8(ATTACHMENT_DEFORM);
+        self.out.write_len(t.frames.len());
+        self.out
+            .write_len(curves.iter().map(SharedCurve::bezier_count).sum());
+        self.out.write_f32_be(t.frames[0].time);
+        for (k, f) in t.frames.iter().enumerate() {
+            let offsets: Vec<f32> = match &t.setup_vertices {
+                Some(setup) => (f.vertices.iter().zip(setup)).map(|(v, s)| v - s).collect(),
+                None => f.vertices.clone(),
+            };
+            match offsets.iter().position(|v| *v != 0.0) {
+                None => self.out.write_len(0),
+                Some(start) => {
+                    let end = offsets.iter().rposition(|v| *v != 0.0).unwrap_or(start) + 1;
+                    self.out.write_len(end - start);
+                    self.out.write_len(start);
+                    write_f32_values(&mut self.out, &offsets[start..end]);
+                }
+            }
+            if k + 1 < t.frames.len() {
+                self.out.write_f32_be(t.frames[k + 1].time);
+                curves[k].write(&mut self.out);
+            }
+        }
+        Ok(())
+    }
+
+    /// Each changed key lists `(slot, position - slot)` for the slots that moved, in slot order;
+    /// the reader fills the remaining positions with the unmoved slots in order.
+    fn write_draw_order(&mut self, a: &Animation) {
+        let frames = a
+            .draw_order_timeline
+            .as_ref()
+            .map(|t| t.frames.as_slice())
+            .unwrap_or(&[]);
+        self.out.write_len(frames.len());
+        for f in frames {
+            self.out.write_f32_be(f.time);
+            let Some(order) = &f.draw_order_to_setup_index else {
+                self.out.write_len(0);
+                continue;
+            };
+            let mut position = vec![0usize; order.len()];
+            for (p, &slot) in order.iter().enumerate() {
+                position[slot] = p;
+            }
+            let moved: Vec<(usize, i32)> = (position.iter().enumerate())
+                .filter(|(slot, p)| *slot != **p)
+                .map(|(slot, p)| (slot, *p as i32 - slot as i32))
+                .collect();
+            self.out.write_len(moved.len());
+            for (slot, offset) in moved {
+                self.out.write_len(slot);
+                self.out.write_varint(offset, true);
+            }
+        }
+    }
+
+    fn write_event_timeline(&mut self, a: &Animation) -> Result<(), Error> {
+        let events = a
+            .event_timeline
+            .as_ref()
+            .map(|t| t.events.as_slice())
+            .unwrap_or(&[]);
+        self.out.write_len(events.len());
+        for e in events {
+            let index = *self
+                .indices
+                .event_index
+                .get(e.name.as_str())
+                .ok_or_else(|| {
+                    invalid(format!(
+                        "animation '{}' keys unknown event '{}'",
+                        a.name, e.name
+                    ))
+                })?;
+            let data = self.indices.events[index];
+            self.out.write_f32_be(e.time);
+            self.out.write_len(index);
+            self.out.write_varint(e.int_value, false);
+            self.out.write_f32_be(e.float_value);
+            // Null falls back to the event data string.
+            self.out
+                .write_string((e.string != data.string).then_some(e.string.as_str()));
+            if !data.audio_path.is_empty() {
+                self.out.write_f32_be(e.volume);
+                self.out.write_f32_be(e.balance);
+            }
+        }
+        Ok(())
+    }
+}
+
+/// True when the position mode spine-cpp decodes from flag bit 2 (the low spacing bit) matches
+/// `p`'s own.
+fn position_mode_survives_skel(p: &crate::PathConstraintData) -> bool {
+    let decoded_percent = matches!(
+        p.spacing_mode,
+        SpacingMode::Fixed | SpacingMode::Proportional
+    );
+    decoded_percent == (p.position_mode == PositionMode::Percent)
+}
@@ -6,6 +6,7 @@
 #![forbid(unsafe_code)]
 
 mod atlas;
+mod atlas_index;
 mod error;
 mod geometry;
 #[cfg(any(feature = "json", feature = "binary"))]
@@ -21,7 +22,11 @@ pub mod json;
 #[cfg(feature = "binary")]
 pub mod binary;
 
+#[cfg(feature = "binary")]
+mod binary_writer;
+
 pub use atlas::*;
+pub use atlas_index::*;
 pub use error::*;
 pub use model::*;
 pub use render::*;